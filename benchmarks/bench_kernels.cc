@@ -0,0 +1,445 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/07.
+ * @brief Microbenchmarks of the kernels on zones, timed conditions, and the monitors
+ *
+ * Each benchmark is executed for each parameter, i.e., the number of the clocks for the zones, the length of the
+ * words for the timed conditions, and the number of the states for the monitors. The results are written in the JSON
+ * Lines format, one object per line, so that the output of a run can be saved and used as the baseline of the later
+ * runs.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <map>
+#include <optional>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+
+#include "zone.hh"
+#include "timed_condition.hh"
+#include "timed_condition_set.hh"
+#include "elementary_language.hh"
+#include "backward_regional_elementary_language.hh"
+#include "equivalence.hh"
+#include "split_mix64.hh"
+#include "timed_automaton_runner.hh"
+
+#include "../tests/random_monitor_fixture.hh"
+// Generated by generate_test_monitors
+#include "generated_monitors/RandomMonitor4.hh"
+#include "generated_monitors/RandomMonitor16.hh"
+#include "generated_monitors/RandomMonitor64.hh"
+
+namespace {
+  using namespace learnta;
+
+  //! @brief Prevent the compiler from removing the computation of the given value
+  template<class T>
+  inline void doNotOptimize(const T &value) {
+    asm volatile("" : : "g"(&value) : "memory");
+  }
+
+  struct Options {
+    double minSeconds = 0.05;
+    int repetitions = 5;
+    std::string filter;
+    std::string output;
+    std::string baseline;
+    double threshold = 0;
+  };
+
+  //! @brief The result of a benchmark for a parameter
+  struct Result {
+    std::string name;
+    std::string parameterName;
+    int parameter;
+    std::size_t iterations;
+    double nsPerOp;
+
+    [[nodiscard]] std::string key() const {
+      return name + "/" + parameterName + ":" + std::to_string(parameter);
+    }
+
+    [[nodiscard]] std::string toJson() const {
+      std::stringstream stream;
+      stream << R"({"benchmark":")" << name << R"(","params":{")" << parameterName << R"(":)" << parameter
+             << R"(},"iterations":)" << iterations << R"(,"ns_per_op":)" << nsPerOp << "}";
+      return stream.str();
+    }
+
+    //! @brief Parse a line written by toJson
+    static std::optional<Result> fromJson(const std::string &line) {
+      static const std::regex pattern{
+              R"re(\{"benchmark":"([^"]*)","params":\{"([^"]*)":(-?[0-9]+)\},"iterations":([0-9]+),"ns_per_op":([^}]*)\})re"};
+      std::smatch match;
+      if (!std::regex_match(line, match, pattern)) {
+        return std::nullopt;
+      }
+      return Result{match[1], match[2], std::stoi(match[3]), std::stoul(match[4]), std::stod(match[5])};
+    }
+  };
+
+  /*!
+   * @brief Measure the time of body(i) per iteration
+   *
+   * We double the iterations until a run takes at least minSeconds, and then take the median of the repetitions.
+   */
+  double measure(const Options &options, const std::function<void(std::size_t)> &body, std::size_t &iterations) {
+    const auto run = [&](std::size_t n) {
+      const auto start = std::chrono::steady_clock::now();
+      for (std::size_t i = 0; i < n; ++i) {
+        body(i);
+      }
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    iterations = 1;
+    while (run(iterations) < options.minSeconds && iterations < (std::size_t{1} << 40)) {
+      iterations *= 2;
+    }
+    std::vector<double> samples;
+    for (int i = 0; i < std::max(options.repetitions, 1); ++i) {
+      samples.push_back(run(iterations) * 1e9 / static_cast<double>(iterations));
+    }
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+
+    return samples.at(samples.size() / 2);
+  }
+
+  /*!
+   * @brief The inputs of a benchmark for a parameter
+   *
+   * The seed is derived from the name and the value of the parameter. Thus, the inputs do not depend on which
+   * benchmarks ran before, and a filtered run is measured on the same inputs as its baseline. The benchmarks with the
+   * same parameter, e.g., TimedAutomatonRunner::step and GeneratedMonitor::step, run on the same inputs. We only use
+   * the bits of SplitMix64 because the distributions of the standard library differ between the platforms.
+   */
+  class Inputs {
+  private:
+    static constexpr std::size_t numInputs = 64;
+    SplitMix64 engine;
+
+    static std::uint64_t seed(const std::string &parameterName, int parameter) {
+      std::uint64_t hash = 14695981039346656037ull;
+      for (const char c: parameterName + ":" + std::to_string(parameter)) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+      }
+      return hash;
+    }
+
+  public:
+    Inputs(const std::string &parameterName, int parameter) : engine(seed(parameterName, parameter)) {}
+
+    //! @brief Random canonical zones with the given number of clocks
+    std::vector<Zone> zones(std::size_t clocks) {
+      std::vector<Zone> result;
+      result.reserve(numInputs);
+      while (result.size() < numInputs) {
+        std::vector<double> valuation(clocks);
+        std::generate(valuation.begin(), valuation.end(), [&] {
+          return std::floor(engine.uniformReal() * 5 * 2) / 2;
+        });
+        Zone zone{valuation, Bounds{5, true}};
+        zone.elapse();
+        for (std::size_t x = 0; x < clocks; ++x) {
+          zone.tighten(x, -1, Bounds{valuation.at(x) + 1 + static_cast<double>(engine.uniformIndex(10)), true});
+        }
+        zone.canonize();
+        if (zone.isSatisfiableNoCanonize()) {
+          result.push_back(std::move(zone));
+        }
+      }
+
+      return result;
+    }
+
+    //! @brief Simple timed conditions of the given length
+    std::vector<TimedCondition> simpleConditions(std::size_t length) {
+      std::vector<TimedCondition> result;
+      result.reserve(numInputs);
+      for (std::size_t i = 0; i < numInputs; ++i) {
+        // accumulatedDuration[i] is the sum of the durations from i to the end
+        std::vector<double> accumulatedDuration(length + 1);
+        double sum = 0;
+        for (auto it = accumulatedDuration.rbegin(); it != accumulatedDuration.rend(); ++it) {
+          sum += std::floor(engine.uniformReal() * 2 * 4) / 4;
+          *it = sum;
+        }
+        result.emplace_back(accumulatedDuration);
+      }
+
+      return result;
+    }
+
+    //! @brief Non-simple timed conditions of the given length made by the convex hull of two simple ones
+    std::vector<TimedCondition> conditions(std::size_t length) {
+      auto left = simpleConditions(length);
+      auto right = simpleConditions(length);
+      std::vector<TimedCondition> result;
+      result.reserve(numInputs);
+      for (std::size_t i = 0; i < numInputs; ++i) {
+        result.push_back(left.at(i).convexHull(right.at(i)));
+      }
+
+      return result;
+    }
+
+    //! @brief A timed word over the given alphabet as the pairs of a duration and an action
+    std::vector<std::pair<double, Alphabet>> timedWord(const std::vector<Alphabet> &alphabet) {
+      std::vector<std::pair<double, Alphabet>> result;
+      result.reserve(numInputs);
+      for (std::size_t i = 0; i < numInputs; ++i) {
+        result.emplace_back(static_cast<double>(engine.uniformIndex(21)) / 4.0,
+                            alphabet.at(engine.uniformIndex(alphabet.size())));
+      }
+
+      return result;
+    }
+  };
+
+  //! @brief Execute a monitor generated by generateMonitor on the word, one event per iteration
+  template<class Monitor>
+  std::function<void(std::size_t)> runMonitor(std::vector<std::pair<double, Alphabet>> word) {
+    return [monitor = Monitor{}, word = std::move(word)](std::size_t i) mutable {
+      if (i % word.size() == 0) {
+        monitor.reset();
+      }
+      const auto &[duration, action] = word[i % word.size()];
+      doNotOptimize(monitor.step(duration));
+      doNotOptimize(monitor.step(action));
+    };
+  }
+
+  //! @brief A benchmark taking one integer parameter
+  struct Benchmark {
+    std::string name;
+    std::string parameterName;
+    std::vector<int> parameters;
+    // Make the body to measure for the parameter
+    std::function<std::function<void(std::size_t)>(Inputs &, int)> setup;
+  };
+
+  std::vector<Benchmark> makeBenchmarks() {
+    const std::vector<int> clocks = {2, 4, 8, 16};
+    const std::vector<int> lengths = {1, 2, 3, 4};
+    std::vector<Benchmark> benchmarks;
+
+    benchmarks.push_back({"Zone::canonize", "clocks", clocks, [](Inputs &inputs, int parameter) {
+      auto zones = inputs.zones(parameter);
+      // The copy is included because canonize is idempotent
+      return [zones](std::size_t i) {
+        Zone zone = zones[i % zones.size()];
+        zone.canonize();
+        doNotOptimize(zone);
+      };
+    }});
+    benchmarks.push_back({"Zone::includes", "clocks", clocks, [](Inputs &inputs, int parameter) {
+      auto zones = inputs.zones(parameter);
+      return [zones](std::size_t i) {
+        doNotOptimize(zones[i % zones.size()].includes(zones[(i + 1) % zones.size()]));
+      };
+    }});
+    benchmarks.push_back({"Zone::extrapolate", "clocks", clocks, [](Inputs &inputs, int parameter) {
+      auto zones = inputs.zones(parameter);
+      return [zones](std::size_t i) {
+        Zone zone = zones[i % zones.size()];
+        zone.extrapolate();
+        doNotOptimize(zone);
+      };
+    }});
+    benchmarks.push_back({"Zone::operator^", "clocks", clocks, [](Inputs &inputs, int parameter) {
+      auto zones = inputs.zones(parameter);
+      return [zones](std::size_t i) {
+        doNotOptimize(zones[i % zones.size()] ^ zones[(i + 1) % zones.size()]);
+      };
+    }});
+    benchmarks.push_back({"hash_value(Zone)", "clocks", clocks, [](Inputs &inputs, int parameter) {
+      auto zones = inputs.zones(parameter);
+      return [zones](std::size_t i) {
+        doNotOptimize(hash_value(zones[i % zones.size()]));
+      };
+    }});
+    benchmarks.push_back({"TimedCondition::enumerate", "length", lengths, [](Inputs &inputs, int parameter) {
+      auto conditions = inputs.conditions(parameter);
+      return [conditions](std::size_t i) {
+        std::vector<TimedCondition> simpleConditions;
+        conditions[i % conditions.size()].enumerate(simpleConditions);
+        doNotOptimize(simpleConditions);
+      };
+    }});
+    benchmarks.push_back({"TimedCondition::convexHull", "length", lengths, [](Inputs &inputs, int parameter) {
+      auto conditions = inputs.simpleConditions(parameter);
+      return [conditions](std::size_t i) {
+        doNotOptimize(conditions[i % conditions.size()].convexHull(conditions[(i + 1) % conditions.size()]));
+      };
+    }});
+    // The reduction is exponential in the length
+    benchmarks.push_back({"TimedConditionSet::reduce", "length", {1, 2, 3}, [](Inputs &inputs, int parameter) {
+      // The simple elementary languages in a non-simple one
+      std::vector<std::list<ElementaryLanguage>> languages;
+      for (const auto &condition: inputs.conditions(parameter)) {
+        std::list<ElementaryLanguage> simpleLanguages;
+        for (auto &simpleCondition: condition.enumerate()) {
+          simpleLanguages.emplace_back(std::string(parameter, 'a'), std::move(simpleCondition));
+        }
+        languages.push_back(std::move(simpleLanguages));
+      }
+      return [languages](std::size_t i) {
+        doNotOptimize(TimedConditionSet::reduce(languages[i % languages.size()]));
+      };
+    }});
+    benchmarks.push_back({"findDeterministicEquivalentRenaming", "length", lengths,
+                          [](Inputs &inputs, int parameter) {
+      const std::vector<BackwardRegionalElementaryLanguage> suffixes = {
+              BackwardRegionalElementaryLanguage::fromTimedWord(TimedWord{"", {0.5}}),
+              BackwardRegionalElementaryLanguage::fromTimedWord(TimedWord{"a", {0.25, 0.5}}),
+              BackwardRegionalElementaryLanguage::fromTimedWord(TimedWord{"a", {1, 1.5}}),
+              BackwardRegionalElementaryLanguage::fromTimedWord(TimedWord{"aa", {0.5, 0, 1}}),
+      };
+      // Pairs of the simple elementary languages and the rows accepting all the concatenations
+      std::vector<std::pair<ElementaryLanguage, std::vector<TimedConditionSet>>> rows;
+      for (auto &condition: inputs.simpleConditions(parameter)) {
+        ElementaryLanguage prefix{std::string(parameter, 'a'), std::move(condition)};
+        std::vector<TimedConditionSet> row;
+        for (const auto &suffix: suffixes) {
+          row.emplace_back((prefix + suffix).getTimedCondition());
+        }
+        rows.emplace_back(std::move(prefix), std::move(row));
+      }
+      return [rows, suffixes](std::size_t i) {
+        const auto &[left, leftRow] = rows[i % rows.size()];
+        const auto &[right, rightRow] = rows[(i + 1) % rows.size()];
+        doNotOptimize(findDeterministicEquivalentRenaming(left, leftRow, right, rightRow, suffixes));
+      };
+    }});
+    // The same random DTAs executed by the interpreter and the generated code
+    const std::vector<int> states = {4, 16, 64};
+    benchmarks.push_back({"TimedAutomatonRunner::step", "states", states, [](Inputs &inputs, int parameter) {
+      const auto fixture = makeRandomMonitorFixture(parameter);
+      auto word = inputs.timedWord(fixture.alphabet);
+      return [runner = TimedAutomatonRunner{fixture.automaton}, word](std::size_t i) mutable {
+        if (i % word.size() == 0) {
+          runner.pre();
+        }
+        const auto &[duration, action] = word[i % word.size()];
+        doNotOptimize(runner.step(duration));
+        doNotOptimize(runner.step(action));
+      };
+    }});
+    benchmarks.push_back({"GeneratedMonitor::step", "states", states,
+                          [](Inputs &inputs, int parameter) -> std::function<void(std::size_t)> {
+      auto word = inputs.timedWord(makeRandomMonitorFixture(parameter).alphabet);
+      switch (parameter) {
+        case 4:
+          return runMonitor<RandomMonitor4>(std::move(word));
+        case 16:
+          return runMonitor<RandomMonitor16>(std::move(word));
+        case 64:
+          return runMonitor<RandomMonitor64>(std::move(word));
+        default:
+          throw std::invalid_argument("No monitor is generated for " + std::to_string(parameter) + " states");
+      }
+    }});
+
+    return benchmarks;
+  }
+
+  std::map<std::string, Result> readBaseline(const std::string &path) {
+    std::ifstream stream{path};
+    if (!stream) {
+      throw std::runtime_error("Failed to open the baseline " + path);
+    }
+    std::map<std::string, Result> baseline;
+    std::string line;
+    while (std::getline(stream, line)) {
+      if (auto result = Result::fromJson(line)) {
+        baseline.emplace(result->key(), *result);
+      }
+    }
+
+    return baseline;
+  }
+
+  void usage(const char *program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --filter SUBSTRING   run only the benchmarks whose names contain SUBSTRING\n"
+              << "  --min-time SECONDS   the minimum time of each measurement (default: 0.05)\n"
+              << "  --repetitions N      the number of the measurements to take the median (default: 5)\n"
+              << "  --output PATH        write the results to PATH instead of the standard output\n"
+              << "  --baseline PATH      compare the results with the ones saved in PATH\n"
+              << "  --threshold RATIO    exit with 1 if a result is slower than the baseline by more than RATIO\n";
+  }
+}
+
+int main(int argc, const char *argv[]) {
+  boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::warning);
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string argument = argv[i];
+    if (argument == "--help") {
+      usage(argv[0]);
+      return 0;
+    } else if (i + 1 >= argc) {
+      usage(argv[0]);
+      return 2;
+    } else if (argument == "--filter") {
+      options.filter = argv[++i];
+    } else if (argument == "--min-time") {
+      options.minSeconds = std::stod(argv[++i]);
+    } else if (argument == "--repetitions") {
+      options.repetitions = std::stoi(argv[++i]);
+    } else if (argument == "--output") {
+      options.output = argv[++i];
+    } else if (argument == "--baseline") {
+      options.baseline = argv[++i];
+    } else if (argument == "--threshold") {
+      options.threshold = std::stod(argv[++i]);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  const auto baseline = options.baseline.empty() ? std::map<std::string, Result>{} : readBaseline(options.baseline);
+  std::ofstream outputFile;
+  if (!options.output.empty()) {
+    outputFile.open(options.output);
+  }
+  std::ostream &output = options.output.empty() ? std::cout : outputFile;
+
+  bool regressed = false;
+  for (const auto &benchmark: makeBenchmarks()) {
+    if (benchmark.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    for (const int parameter: benchmark.parameters) {
+      Result result{benchmark.name, benchmark.parameterName, parameter, 0, 0};
+      Inputs inputs{benchmark.parameterName, parameter};
+      result.nsPerOp = measure(options, benchmark.setup(inputs, parameter), result.iterations);
+      output << result.toJson() << std::endl;
+      if (auto it = baseline.find(result.key()); it != baseline.end()) {
+        const double ratio = result.nsPerOp / it->second.nsPerOp;
+        std::cerr << result.key() << ": " << it->second.nsPerOp << " -> " << result.nsPerOp << " [ns/op] (x"
+                  << ratio << ")\n";
+        if (options.threshold > 0 && ratio > options.threshold) {
+          regressed = true;
+        }
+      }
+    }
+  }
+
+  return regressed ? 1 : 0;
+}
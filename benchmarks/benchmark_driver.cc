@@ -0,0 +1,421 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/08.
+ * @brief Runs the learning of the example models in parallel worker processes and collects the statistics
+ *
+ * Each model is learned in a forked process under the given CPU time, wall-clock time, and memory limits. The output
+ * of each worker is written to a log file in the same format as the learn_* executables, and the statistics in it are
+ * collected with the wall time and the peak RSS of the worker. The results are written in the JSON format described
+ * by utils/schema.json or in the CSV format.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "experiment_runner.hh"
+#include "ota_json_parser.hh"
+#include "ota_json_writer.hh"
+#include "fischer_fixture.hh"
+#include "fddi_fixture.hh"
+#include "unbalanced_loop_fixture.hh"
+
+namespace {
+  namespace fs = std::filesystem;
+
+  //! @brief The exit status of a worker running out of memory
+  constexpr int memoryOutStatus = 3;
+
+  struct Options {
+    std::size_t jobs = std::max(1u, std::thread::hardware_concurrency());
+    // The limits of each worker. 0 means no limit.
+    rlim_t cpuSeconds = 3 * 60 * 60;
+    unsigned int wallSeconds = 0;
+    rlim_t memoryMegabytes = 0;
+    std::string logDirectory;
+    std::string output;
+  };
+
+  //! @brief A model to learn in a worker
+  struct Job {
+    std::string name;
+    std::function<void()> learn;
+  };
+
+  //! @brief The result of a job
+  struct Result {
+    std::string status;
+    double wallTime = 0;
+    double cpuTime = 0;
+    long peakRss = 0;
+    // The statistics reported by the learner, e.g., membership_queries
+    std::map<std::string, double> statistics;
+    std::map<std::string, double> phaseTimes;
+  };
+
+  template<class Fixture>
+  std::function<void()> learnFixture(std::function<Fixture()> makeFixture) {
+    return [makeFixture] {
+      const Fixture fixture = makeFixture();
+      learnta::ExperimentRunner runner{fixture.alphabet, fixture.targetAutomaton};
+      runner.run();
+    };
+  }
+
+  std::vector<int> parseList(const std::string &list) {
+    std::vector<int> result;
+    std::stringstream stream{list};
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+      result.push_back(std::stoi(item));
+    }
+    return result;
+  }
+
+  //! @brief Add the OTA JSON files in the given path, which may be a directory
+  void addJsonJobs(const fs::path &path, std::vector<Job> &jobs) {
+    std::vector<fs::path> files;
+    if (fs::is_directory(path)) {
+      for (const auto &entry: fs::recursive_directory_iterator(path)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json") {
+          files.push_back(entry.path());
+        }
+      }
+      std::sort(files.begin(), files.end());
+    } else {
+      files.push_back(path);
+    }
+    for (const auto &file: files) {
+      jobs.push_back({file.stem().string(), [file] {
+        learnta::OtaJsonParser parser{file.string()};
+        learnta::ExperimentRunner runner{parser.getAlphabet(), parser.getTarget()};
+        runner.run();
+      }});
+    }
+  }
+
+  //! @brief Execute the job in the forked worker. This function never returns.
+  [[noreturn]] void runWorker(const Options &options, const Job &job, const std::string &logPath) {
+    const int fd = open(logPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0 || dup2(fd, STDOUT_FILENO) < 0 || dup2(fd, STDERR_FILENO) < 0) {
+      _exit(EXIT_FAILURE);
+    }
+    if (options.cpuSeconds > 0) {
+      // We are killed by SIGXCPU at the soft limit
+      const rlimit limit{options.cpuSeconds, options.cpuSeconds + 1};
+      setrlimit(RLIMIT_CPU, &limit);
+    }
+    if (options.memoryMegabytes > 0) {
+      const rlimit limit{options.memoryMegabytes << 20, options.memoryMegabytes << 20};
+      setrlimit(RLIMIT_AS, &limit);
+    }
+    if (options.wallSeconds > 0) {
+      // We are killed by SIGALRM
+      alarm(options.wallSeconds);
+    }
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::info);
+    int status = EXIT_SUCCESS;
+    try {
+      job.learn();
+    } catch (const std::bad_alloc &) {
+      std::cout << "Out of memory" << std::endl;
+      status = memoryOutStatus;
+    } catch (const std::exception &e) {
+      std::cout << "Error: " << e.what() << std::endl;
+      status = EXIT_FAILURE;
+    }
+    std::cout.flush();
+    std::clog.flush();
+    _exit(status);
+  }
+
+  //! @brief Collect the statistics in the log written by a worker
+  void parseLog(const std::string &logPath, Result &result) {
+    static const std::vector<std::pair<std::regex, std::string>> statisticPatterns = {
+            {std::regex{R"(Number of symbolic membership queries \(with cache\): ([0-9.e+-]+))"},
+                    "symbolic_membership_queries"},
+            {std::regex{R"(Number of membership queries \(with cache\): ([0-9.e+-]+))"}, "membership_queries"},
+            {std::regex{R"(Number of equivalence queries \(with cache\): ([0-9.e+-]+))"}, "equivalence_queries"},
+            {std::regex{R"(Execution Time: ([0-9.e+-]+) \[ms\])"}, "execution_time"},
+    };
+    static const std::regex phasePattern{R"(Phase Time \(([^)]*)\): ([0-9.e+-]+) \[ms\])"};
+    std::ifstream stream{logPath};
+    std::string line;
+    std::smatch match;
+    while (std::getline(stream, line)) {
+      for (const auto &[pattern, key]: statisticPatterns) {
+        if (std::regex_search(line, match, pattern)) {
+          result.statistics[key] = std::stod(match[1]);
+        }
+      }
+      if (std::regex_search(line, match, phasePattern)) {
+        result.phaseTimes[match[1]] = std::stod(match[2]);
+      }
+    }
+  }
+
+  std::string statusOf(int waitStatus) {
+    if (WIFEXITED(waitStatus)) {
+      switch (WEXITSTATUS(waitStatus)) {
+        case EXIT_SUCCESS:
+          return "ok";
+        case memoryOutStatus:
+          return "memout";
+        default:
+          return "error";
+      }
+    }
+    if (WIFSIGNALED(waitStatus)) {
+      const int signal = WTERMSIG(waitStatus);
+      if (signal == SIGXCPU || signal == SIGALRM || signal == SIGKILL) {
+        return "timeout";
+      }
+    }
+    return "error";
+  }
+
+  //! @brief Run the jobs with at most options.jobs workers at once
+  std::vector<Result> runJobs(const Options &options, const std::vector<Job> &jobs, const std::string &logDirectory) {
+    std::vector<Result> results(jobs.size());
+    std::map<pid_t, std::pair<std::size_t, std::chrono::steady_clock::time_point>> running;
+    std::size_t nextJob = 0;
+    const auto logPath = [&](std::size_t index) {
+      return (fs::path{logDirectory} / (jobs.at(index).name + ".log")).string();
+    };
+    while (nextJob < jobs.size() || !running.empty()) {
+      while (nextJob < jobs.size() && running.size() < options.jobs) {
+        std::cout.flush();
+        std::cerr.flush();
+        // We take the start time before fork because the worker may finish before the parent is scheduled again
+        const auto startTime = std::chrono::steady_clock::now();
+        const pid_t pid = fork();
+        if (pid < 0) {
+          throw std::runtime_error(std::string{"Failed to fork a worker: "} + std::strerror(errno));
+        } else if (pid == 0) {
+          runWorker(options, jobs.at(nextJob), logPath(nextJob));
+        }
+        std::cerr << "Started " << jobs.at(nextJob).name << std::endl;
+        running.emplace(pid, std::make_pair(nextJob++, startTime));
+      }
+      int waitStatus;
+      rusage usage{};
+      const pid_t pid = wait4(-1, &waitStatus, 0, &usage);
+      if (pid < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw std::runtime_error(std::string{"Failed to wait for the workers: "} + std::strerror(errno));
+      }
+      const auto it = running.find(pid);
+      if (it == running.end()) {
+        continue;
+      }
+      const auto [index, startTime] = it->second;
+      running.erase(it);
+      Result &result = results.at(index);
+      result.status = statusOf(waitStatus);
+      result.wallTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+      result.cpuTime = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e3 +
+                       (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e3;
+      // ru_maxrss is in kilobytes on Linux
+      result.peakRss = usage.ru_maxrss;
+      parseLog(logPath(index), result);
+      std::cerr << "Finished " << jobs.at(index).name << ": " << result.status << " in " << result.wallTime
+                << " [ms]" << std::endl;
+    }
+
+    return results;
+  }
+
+  //! @brief The key of a phase in the JSON output, e.g., "observation table" -> "observation_table"
+  std::string phaseKey(std::string phase) {
+    std::replace(phase.begin(), phase.end(), ' ', '_');
+    std::replace(phase.begin(), phase.end(), '-', '_');
+    return phase;
+  }
+
+  void writeJson(std::ostream &stream, const std::vector<Job> &jobs, const std::vector<Result> &results) {
+    stream << "{\n";
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+      const auto &result = results.at(i);
+      stream << learnta::quoteJson(jobs.at(i).name) << ":{";
+      stream << "\"status\":" << learnta::quoteJson(result.status);
+      for (const auto &[key, value]: result.statistics) {
+        stream << "," << learnta::quoteJson(key) << ":" << value;
+      }
+      stream << ",\"wall_time\":" << result.wallTime << ",\"cpu_time\":" << result.cpuTime
+             << ",\"peak_rss\":" << result.peakRss;
+      stream << ",\"phase_times\":{";
+      bool first = true;
+      for (const auto &[phase, value]: result.phaseTimes) {
+        stream << (first ? "" : ",") << learnta::quoteJson(phaseKey(phase)) << ":" << value;
+        first = false;
+      }
+      stream << "}}" << (i + 1 < jobs.size() ? "," : "") << "\n";
+    }
+    stream << "}\n";
+  }
+
+  void writeCsv(std::ostream &stream, const std::vector<Job> &jobs, const std::vector<Result> &results) {
+    static const std::vector<std::string> statisticKeys = {"symbolic_membership_queries", "membership_queries",
+                                                           "equivalence_queries", "execution_time"};
+    std::vector<std::string> phases;
+    for (const auto &result: results) {
+      for (const auto &[phase, value]: result.phaseTimes) {
+        if (std::find(phases.begin(), phases.end(), phase) == phases.end()) {
+          phases.push_back(phase);
+        }
+      }
+    }
+    stream << "name,status";
+    for (const auto &key: statisticKeys) {
+      stream << "," << key;
+    }
+    stream << ",wall_time,cpu_time,peak_rss";
+    for (const auto &phase: phases) {
+      stream << ",phase_time_" << phaseKey(phase);
+    }
+    stream << "\n";
+    const auto write = [&](const std::map<std::string, double> &values, const std::string &key) {
+      stream << ",";
+      if (auto it = values.find(key); it != values.end()) {
+        stream << it->second;
+      }
+    };
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+      const auto &result = results.at(i);
+      stream << jobs.at(i).name << "," << result.status;
+      for (const auto &key: statisticKeys) {
+        write(result.statistics, key);
+      }
+      stream << "," << result.wallTime << "," << result.cpuTime << "," << result.peakRss;
+      for (const auto &phase: phases) {
+        write(result.phaseTimes, phase);
+      }
+      stream << "\n";
+    }
+  }
+
+  void usage(const char *program) {
+    std::cerr << "Usage: " << program << " [options] [OTA json files or directories...]\n"
+              << "  --fischer N[,N...]      learn the Fischer benchmark with the given scales\n"
+              << "  --fddi N[,N...]         learn the FDDI benchmark with the given scales\n"
+              << "  --unbalanced N[,N...]   learn the Unbalanced benchmark with 5 states and the given clocks\n"
+              << "  --jobs N                the number of the parallel workers (default: the hardware threads)\n"
+              << "  --cpu-limit SECONDS     the CPU time limit of each worker (default: 10800, 0 for no limit)\n"
+              << "  --wall-limit SECONDS    the wall-clock time limit of each worker (default: no limit)\n"
+              << "  --memory-limit MB       the address space limit of each worker (default: no limit)\n"
+              << "  --log-dir DIR           keep the log of each worker in DIR (default: a temporary directory)\n"
+              << "  --output PATH           write the results to PATH. The format is CSV if it ends with .csv\n"
+              << "                          and JSON otherwise (default: JSON to the standard output)\n";
+  }
+}
+
+int main(int argc, const char *argv[]) {
+  Options options;
+  std::vector<Job> jobs;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string argument = argv[i];
+      const bool isOption = argument.rfind("--", 0) == 0;
+      if (argument == "--help") {
+        usage(argv[0]);
+        return 0;
+      } else if (isOption && i + 1 >= argc) {
+        usage(argv[0]);
+        return 2;
+      } else if (argument == "--fischer") {
+        for (const int scale: parseList(argv[++i])) {
+          jobs.push_back({"fischer-" + std::to_string(scale), learnFixture<FischerFixture>([scale] {
+            return FischerFixture{scale};
+          })});
+        }
+      } else if (argument == "--fddi") {
+        for (const int scale: parseList(argv[++i])) {
+          jobs.push_back({"fddi-" + std::to_string(scale), learnFixture<FDDIFixture>([scale] {
+            return FDDIFixture{scale};
+          })});
+        }
+      } else if (argument == "--unbalanced") {
+        for (const int clocks: parseList(argv[++i])) {
+          jobs.push_back({"unbalanced-" + std::to_string(clocks), learnFixture<UnbalancedLoopFixture>([clocks] {
+            return UnbalancedLoopFixture{5, clocks, 1};
+          })});
+        }
+      } else if (argument == "--jobs") {
+        options.jobs = std::max(1, std::stoi(argv[++i]));
+      } else if (argument == "--cpu-limit") {
+        options.cpuSeconds = std::stoul(argv[++i]);
+      } else if (argument == "--wall-limit") {
+        options.wallSeconds = std::stoul(argv[++i]);
+      } else if (argument == "--memory-limit") {
+        options.memoryMegabytes = std::stoul(argv[++i]);
+      } else if (argument == "--log-dir") {
+        options.logDirectory = argv[++i];
+      } else if (argument == "--output") {
+        options.output = argv[++i];
+      } else if (isOption) {
+        usage(argv[0]);
+        return 2;
+      } else {
+        addJsonJobs(argument, jobs);
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    usage(argv[0]);
+    return 2;
+  }
+  if (jobs.empty()) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  std::string logDirectory = options.logDirectory;
+  if (logDirectory.empty()) {
+    std::string pattern = (fs::temp_directory_path() / "learnta_benchmark_XXXXXX").string();
+    if (!mkdtemp(pattern.data())) {
+      std::cerr << "Failed to make a temporary directory" << std::endl;
+      return 1;
+    }
+    logDirectory = pattern;
+  } else {
+    fs::create_directories(logDirectory);
+  }
+  std::cerr << "The logs are written to " << logDirectory << std::endl;
+
+  const auto results = runJobs(options, jobs, logDirectory);
+  std::ofstream outputFile;
+  if (!options.output.empty()) {
+    outputFile.open(options.output);
+  }
+  std::ostream &output = options.output.empty() ? std::cout : outputFile;
+  if (fs::path{options.output}.extension() == ".csv") {
+    writeCsv(output, jobs, results);
+  } else {
+    writeJson(output, jobs, results);
+  }
+
+  return std::all_of(results.begin(), results.end(), [](const Result &result) {
+    return result.status == "ok";
+  }) ? 0 : 1;
+}
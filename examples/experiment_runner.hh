@@ -8,17 +8,24 @@
 #include <boost/log/trivial.hpp>
 #include <boost/log/core.hpp>
 #include <boost/log/expressions.hpp>
+#include <sstream>
 #include <utility>
 
 #include "timed_automaton.hh"
+#include "compiled_timed_automaton.hh"
+#include "monitor_code_generator.hh"
 #include "sul.hh"
 #include "timed_automaton_runner.hh"
 #include "symbolic_membership_oracle.hh"
 #include "equivalence_oracle_by_test.hh"
+#include "equivalence_oracle_by_zone_coverage.hh"
 #include "timed_automata_equivalence_oracle.hh"
 #include "learner.hh"
+#include "async_reporter.hh"
 #include "equivalance_oracle_chain.hh"
+#include "equivalence_oracle_concurrent_chain.hh"
 #include "equivalence_oracle_memo.hh"
+#include "persistent_membership_store.hh"
 
 namespace learnta {
 
@@ -27,6 +34,36 @@ namespace learnta {
     const std::vector<Alphabet> alphabet;
     TimedAutomaton target;
     std::vector<TimedWord> testWords;
+    // The number of the threads to fill the observation table
+    std::size_t numThreads = 1;
+    // If true, the cells of the observation table are filled only when they are used
+    bool lazyTable = false;
+    // The path to the checkpoint. If it is empty, we do not use checkpoints.
+    std::string checkpointPath;
+    // The directory of the persistent membership stores. If it is empty, we do not use them.
+    std::string membershipStoreDirectory;
+    // If true, the membership queries are cached for each region of timed words
+    bool regionalMembershipCache = false;
+    // If true, the hits of the regional cache are verified by the SUL
+    bool verifyRegionalMembershipCache = false;
+    // How we search for the breakpoint of the counterexamples
+    CEXAnalysisMode cexAnalysisMode = CEXAnalysisMode::LINEAR;
+    // The maximum number of the counterexamples handled in one refinement
+    std::size_t maxCounterExamples = 1;
+    // If true, the equivalence oracles are executed in parallel
+    bool concurrentEquivalence = false;
+    // The maximum number of the zone-coverage tests in each equivalence query. If it is 0, we do not use them.
+    int maxZoneCoverageTests = 0;
+    int maxZoneCoverageSuffixLength = 0;
+    // The path to write the instrumentation of each iteration. If it is empty, we do not write it.
+    std::string instrumentationOutput;
+    // Where we stream the events of the learning loop. If it is empty, we do not stream them.
+    std::string telemetryDestination;
+    // The path to write the monitor of the learned DTA. If it is empty, we do not write it.
+    std::string monitorOutput;
+    std::string monitorClassName;
+    // The path to write the learned DTA for CompiledTimedAutomaton::map. If it is empty, we do not write it.
+    std::string compiledOutput;
   public:
 
     void pushTestWord(const TimedWord& testWord) {
@@ -35,6 +72,118 @@ namespace learnta {
 
     ExperimentRunner(std::vector<Alphabet> alphabet, TimedAutomaton target) : alphabet(std::move(alphabet)), target(std::move(target)) {}
 
+    /*!
+     * @brief Set the number of the threads to fill the observation table. If it is 0, we use all the hardware threads.
+     */
+    void setNumThreads(std::size_t threads) {
+      this->numThreads = threads;
+    }
+
+    /*!
+     * @brief Fill the cells of the observation table only when they are used
+     */
+    void setLazyTable(bool lazy) {
+      this->lazyTable = lazy;
+    }
+
+    /*!
+     * @brief Write checkpoints to the given path. If the checkpoint already exists, we resume the learning from it.
+     */
+    void setCheckpoint(std::string path) {
+      this->checkpointPath = std::move(path);
+    }
+
+    /*!
+     * @brief Store the results of the membership queries in the given directory and reuse them in the later runs
+     *
+     * The store is chosen by the target DTA so that the experiments with different targets do not share the results.
+     */
+    void setMembershipStore(std::string directory) {
+      this->membershipStoreDirectory = std::move(directory);
+    }
+
+    /*!
+     * @brief Cache the membership queries for each region of timed words using the maximal constant of the target
+     *
+     * @param verify If it is true, the cache hits are also queried to the SUL to report mismatches
+     * @sa RegionalMembershipOracleCache
+     */
+    void setRegionalMembershipCache(bool enable, bool verify = false) {
+      this->regionalMembershipCache = enable;
+      this->verifyRegionalMembershipCache = verify;
+    }
+
+    /*!
+     * @brief Set how we search for the breakpoint of the counterexamples
+     */
+    void setCEXAnalysisMode(CEXAnalysisMode mode) {
+      this->cexAnalysisMode = mode;
+    }
+
+    /*!
+     * @brief Set the maximum number of the counterexamples handled in one refinement
+     */
+    void setMaxCounterExamples(std::size_t max) {
+      this->maxCounterExamples = max;
+    }
+
+    /*!
+     * @brief Execute the equivalence oracles in parallel and use the first counterexample found
+     *
+     * The learning result may depend on the scheduling.
+     */
+    void setConcurrentEquivalence(bool concurrent) {
+      this->concurrentEquivalence = concurrent;
+    }
+
+    /*!
+     * @brief Try the tests covering the zone graph of the target before the exact equivalence check
+     *
+     * @sa EquivalenceOracleByZoneCoverage
+     */
+    void setZoneCoverageTests(int maxTests, int maxSuffixLength) {
+      this->maxZoneCoverageTests = maxTests;
+      this->maxZoneCoverageSuffixLength = maxSuffixLength;
+    }
+
+    /*!
+     * @brief Write the instrumentation after each equivalence query in the JSON Lines format
+     *
+     * @note This requires the build with LEARNTA_INSTRUMENTATION
+     */
+    void setInstrumentationOutput(std::string path) {
+      this->instrumentationOutput = std::move(path);
+    }
+
+    /*!
+     * @brief Stream the events of the learning loop in the JSON Lines format
+     *
+     * @param destination The path to a file, or "unix:" followed by the path to a listening Unix domain socket
+     * @sa AsyncReporter
+     */
+    void setTelemetry(std::string destination) {
+      this->telemetryDestination = std::move(destination);
+    }
+
+    /*!
+     * @brief Write the learned DTA as a self-contained C++ header of a monitor
+     *
+     * @sa generateMonitor
+     */
+    void setMonitorOutput(std::string path, std::string className = "LearnedMonitor") {
+      this->monitorOutput = std::move(path);
+      this->monitorClassName = std::move(className);
+    }
+
+    /*!
+     * @brief Write the learned DTA in the binary format loaded by CompiledTimedAutomaton::map
+     *
+     * @sa CompiledTimedAutomaton::write
+     */
+    void setCompiledOutput(std::string path) {
+      this->compiledOutput = std::move(path);
+    }
+
     /*!
      * @brief Execute the experiment
      */
@@ -46,9 +195,39 @@ namespace learnta {
       BOOST_LOG_TRIVIAL(info) << "Complement of the target DTA\n" << complement;
 
       // Construct the learner
-      auto sul = std::unique_ptr<learnta::SUL>(new learnta::TimedAutomatonRunner(this->target));
-      auto memOracle = std::make_unique<learnta::SymbolicMembershipOracle>(std::move(sul));
-      auto eqOracle = std::make_unique<learnta::EquivalenceOracleChain>();
+      std::unique_ptr<learnta::MembershipOracle> concreteOracle;
+      if (numThreads == 1) {
+        auto sul = std::unique_ptr<learnta::SUL>(new learnta::TimedAutomatonRunner(this->target));
+        concreteOracle = std::make_unique<learnta::SULMembershipOracle>(std::move(sul));
+      } else {
+        // Since the target is a white-box DTA, we can make one runner for each thread
+        const std::size_t poolSize = numThreads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : numThreads;
+        std::vector<std::unique_ptr<learnta::SUL>> suls;
+        suls.reserve(poolSize);
+        for (std::size_t i = 0; i < poolSize; ++i) {
+          suls.emplace_back(new learnta::TimedAutomatonRunner(this->target));
+        }
+        concreteOracle = std::make_unique<learnta::SULPoolMembershipOracle>(std::move(suls));
+      }
+      if (!membershipStoreDirectory.empty()) {
+        // The identity of the SUL is the target DTA itself
+        std::stringstream identity;
+        identity << this->target;
+        const auto storePath = membershipStoreDirectory + "/" +
+                               learnta::PersistentMembershipStore::fileName(identity.str());
+        BOOST_LOG_TRIVIAL(info) << "Membership store: " << storePath;
+        concreteOracle = std::make_unique<learnta::PersistentMembershipOracle>(std::move(concreteOracle),
+                                                                               storePath, identity.str());
+      }
+      if (regionalMembershipCache) {
+        const auto &maxConstraints = this->target.maxConstraints;
+        const int maxConstant = maxConstraints.empty() ? 0 : *std::max_element(maxConstraints.begin(),
+                                                                                maxConstraints.end());
+        concreteOracle = std::make_unique<learnta::RegionalMembershipOracleCache>(std::move(concreteOracle),
+                                                                                  maxConstant,
+                                                                                  verifyRegionalMembershipCache);
+      }
+      auto memOracle = std::make_unique<learnta::SymbolicMembershipOracle>(std::move(concreteOracle));
       auto eqOracleByTest = std::make_unique<learnta::EquivalenceOracleByTest>(this->target);
       // Equivalence query by static string to make the evaluation stable
       // These strings are generated in macOS but the equivalence query returns a different set of counter examples.
@@ -57,12 +236,56 @@ namespace learnta {
         eqOracleByTest->push_back(testWord);
       }
 
-      eqOracle->push_back(std::move(eqOracleByTest));
-      eqOracle->push_back(
-              std::make_unique<learnta::ComplementTimedAutomataEquivalenceOracle>(
-                      this->target, complement, alphabet));
+      std::unique_ptr<learnta::EquivalenceOracle> zoneCoverageOracle;
+      if (maxZoneCoverageTests > 0) {
+        // We fix the seed to make the evaluation stable
+        zoneCoverageOracle = std::make_unique<learnta::EquivalenceOracleByZoneCoverage>(
+                alphabet, this->target, maxZoneCoverageTests, maxZoneCoverageSuffixLength, 0);
+      }
+      auto complementOracle = std::make_unique<learnta::ComplementTimedAutomataEquivalenceOracle>(
+              this->target, complement, alphabet);
+      std::unique_ptr<learnta::EquivalenceOracle> eqOracle;
+      if (concurrentEquivalence) {
+        auto chain = std::make_unique<learnta::EquivalenceOracleConcurrentChain>();
+        chain->push_back(std::move(eqOracleByTest));
+        if (zoneCoverageOracle) {
+          chain->push_back(std::move(zoneCoverageOracle));
+        }
+        chain->push_back(std::move(complementOracle));
+        eqOracle = std::move(chain);
+      } else {
+        auto chain = std::make_unique<learnta::EquivalenceOracleChain>();
+        chain->push_back(std::move(eqOracleByTest));
+        if (zoneCoverageOracle) {
+          chain->push_back(std::move(zoneCoverageOracle));
+        }
+        chain->push_back(std::move(complementOracle));
+        eqOracle = std::move(chain);
+      }
+      // We do not count the construction of the complement
+      learnta::Instrumentation::global().reset();
       learnta::Learner learner{alphabet, std::move(memOracle),
-                               std::make_unique<learnta::EquivalenceOracleMemo>(std::move(eqOracle), this->target)};
+                               std::make_unique<learnta::EquivalenceOracleMemo>(std::move(eqOracle), this->target),
+                               numThreads, lazyTable};
+      learner.setCEXAnalysisMode(cexAnalysisMode);
+      learner.setMaxCounterExamples(maxCounterExamples);
+      if (!checkpointPath.empty()) {
+        if (std::ifstream{checkpointPath}.good()) {
+          learner.loadCheckpoint(checkpointPath);
+        }
+        learner.setCheckpoint(checkpointPath);
+      }
+      if (!instrumentationOutput.empty()) {
+        learner.setInstrumentationOutput(instrumentationOutput);
+      }
+      if (!telemetryDestination.empty()) {
+        const std::string socketPrefix = "unix:";
+        if (telemetryDestination.rfind(socketPrefix, 0) == 0) {
+          learner.addObserver(learnta::AsyncReporter::toUnixSocket(telemetryDestination.substr(socketPrefix.size())));
+        } else {
+          learner.addObserver(learnta::AsyncReporter::toFile(telemetryDestination));
+        }
+      }
 
       // Run the learning
       BOOST_LOG_TRIVIAL(info) << "Start Learning!!";
@@ -72,6 +295,16 @@ namespace learnta {
 
       BOOST_LOG_TRIVIAL(info) << "Learning Finished!!";
       BOOST_LOG_TRIVIAL(info) << "The learned DTA is as follows\n" << hypothesis;
+      if (!monitorOutput.empty()) {
+        std::ofstream stream{monitorOutput};
+        generateMonitor(stream, hypothesis, monitorClassName);
+        BOOST_LOG_TRIVIAL(info) << "The monitor of the learned DTA is written to " << monitorOutput;
+      }
+      if (!compiledOutput.empty()) {
+        std::ofstream stream{compiledOutput, std::ios::binary};
+        CompiledTimedAutomaton::write(stream, hypothesis);
+        BOOST_LOG_TRIVIAL(info) << "The compiled learned DTA is written to " << compiledOutput;
+      }
       learner.printStatistics(std::cout);
       BOOST_LOG_TRIVIAL(info) << "Execution Time: "
                               << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count()
@@ -0,0 +1,91 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/15.
+ * @brief Generates a random timed automaton in the dot format or the json format of https://github.com/Leslieaj/OTALearning
+ */
+
+#include <iostream>
+#include <string>
+
+#include "random_timed_automaton_generator.hh"
+#include "ota_json_writer.hh"
+
+namespace {
+  void usage(const char *program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --states N                 the number of the states (default: 5)\n"
+              << "  --clocks N                 the number of the clocks (default: 1)\n"
+              << "  --alphabet N               the number of the actions (default: 2)\n"
+              << "  --max-constant N           the maximum constant in the guards (default: 5)\n"
+              << "  --guard-density P          the probability that each constant splits a guard (default: 0.3)\n"
+              << "  --reset-probability P      the probability that each clock is reset (default: 0.3)\n"
+              << "  --accepting-probability P  the probability that each state is accepting (default: 0.5)\n"
+              << "  --incomplete P             remove each transition with the probability P\n"
+              << "  --nondeterministic         add a transition with an overlapping guard for each state and action\n"
+              << "  --seed N                   the seed of the random number generator (default: 0)\n"
+              << "  --format dot|json          the output format (default: dot). json requires one clock\n"
+              << "  --name NAME                the name in the json format (default: random)\n";
+  }
+}
+
+int main(int argc, const char *argv[]) {
+  learnta::RandomTimedAutomatonParameters parameters;
+  std::string format = "dot";
+  std::string name = "random";
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string argument = argv[i];
+      if (argument == "--help") {
+        usage(argv[0]);
+        return 0;
+      } else if (argument == "--nondeterministic") {
+        parameters.deterministic = false;
+      } else if (argument.rfind("--", 0) != 0 || i + 1 >= argc) {
+        usage(argv[0]);
+        return 2;
+      } else if (argument == "--states") {
+        parameters.numStates = std::stoul(argv[++i]);
+      } else if (argument == "--clocks") {
+        parameters.numClocks = std::stoul(argv[++i]);
+      } else if (argument == "--alphabet") {
+        parameters.alphabetSize = std::stoul(argv[++i]);
+      } else if (argument == "--max-constant") {
+        parameters.maxConstant = std::stoi(argv[++i]);
+      } else if (argument == "--guard-density") {
+        parameters.guardDensity = std::stod(argv[++i]);
+      } else if (argument == "--reset-probability") {
+        parameters.resetProbability = std::stod(argv[++i]);
+      } else if (argument == "--accepting-probability") {
+        parameters.acceptingProbability = std::stod(argv[++i]);
+      } else if (argument == "--incomplete") {
+        parameters.complete = false;
+        parameters.missingTransitionProbability = std::stod(argv[++i]);
+      } else if (argument == "--seed") {
+        parameters.seed = std::stoull(argv[++i]);
+      } else if (argument == "--format") {
+        format = argv[++i];
+      } else if (argument == "--name") {
+        name = argv[++i];
+      } else {
+        usage(argv[0]);
+        return 2;
+      }
+    }
+    if (format != "dot" && format != "json") {
+      throw std::invalid_argument("Unknown format: " + format);
+    }
+
+    learnta::RandomTimedAutomatonGenerator generator{parameters};
+    const auto automaton = generator.generate();
+    if (format == "json") {
+      learnta::writeOtaJson(std::cout, generator.alphabet(), automaton, name);
+    } else {
+      std::cout << automaton;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 2;
+  }
+
+  return 0;
+}
@@ -5,13 +5,28 @@
  */
 
 #include <iostream>
+#include <string>
 
 #include "ota_json_parser.hh"
 #include "experiment_runner.hh"
 
-void run(const std::string &jsonPath) {
+void run(const std::string &jsonPath, const std::string &checkpointPath, const std::string &storeDirectory,
+         const std::string &monitorPath, const std::string &compiledPath, int zoneCoverageTests,
+         int zoneCoverageSuffixLength) {
   learnta::OtaJsonParser parser{jsonPath};
+  const auto &interner = parser.getInterner();
+  if (!interner.isIdentity()) {
+    // The learned DTA uses the interned actions
+    for (const auto action: parser.getAlphabet()) {
+      BOOST_LOG_TRIVIAL(info) << "Action " << learnta::actionToString(action) << ": " << interner.label(action);
+    }
+  }
   learnta::ExperimentRunner runner{parser.getAlphabet(), parser.getTarget() };
+  runner.setCheckpoint(checkpointPath);
+  runner.setMembershipStore(storeDirectory);
+  runner.setMonitorOutput(monitorPath);
+  runner.setCompiledOutput(compiledPath);
+  runner.setZoneCoverageTests(zoneCoverageTests, zoneCoverageSuffixLength);
   runner.run();
 }
 
@@ -22,12 +37,13 @@ int main(int argc, const char *argv[]) {
   boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::debug);
 #endif
 
-  std::cout << "Usage: " << argv[0] << " [json path]" << std::endl;
+  std::cout << "Usage: " << argv[0] << " [json path] ([checkpoint path] ([membership store directory] ([monitor header path] ([compiled DTA path] ([zone-coverage tests] ([zone-coverage suffix length]))))))" << std::endl;
   if (argc <= 1) {
     std::cout << "json file is not specified" << std::endl;
     return 1;
   } else {
-      run(argv[1]);
+      run(argv[1], argc > 2 ? argv[2] : "", argc > 3 ? argv[3] : "", argc > 4 ? argv[4] : "",
+          argc > 5 ? argv[5] : "", argc > 6 ? std::stoi(argv[6]) : 0, argc > 7 ? std::stoi(argv[7]) : 0);
   }
 
   return 0;
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <stdexcept>
 
 #include <boost/property_tree/ptree.hpp>
@@ -12,6 +13,7 @@
 #include <boost/foreach.hpp>
 
 #include "timed_automaton.hh"
+#include "alphabet_interner.hh"
 
 
 namespace learnta {
@@ -22,11 +24,13 @@ namespace learnta {
   class OtaJsonParser {
   private:
     std::vector<Alphabet> alphabet;
+    AlphabetInterner interner;
     TimedAutomaton target;
-    inline static void validateLabel(const std::string &label) {
-      if (label.size() != 1) {
+    [[nodiscard]] Alphabet toAction(const std::string &label) const {
+      if (!interner.contains(label)) {
         throw std::invalid_argument("Invalid alphabet: " + label);
       }
+      return interner.at(label);
     }
   public:
     explicit OtaJsonParser(const std::string &jsonPath) {
@@ -35,10 +39,17 @@ namespace learnta {
       boost::property_tree::ptree pt;
       boost::property_tree::read_json(jsonPath, pt);
 
-      // Construct the alphabet
+      // Construct the alphabet. The labels can be of any length, and we map them to actions by interning.
+      std::vector<std::string> labels;
       BOOST_FOREACH (const auto &child, pt.get_child("sigma")) {
-        learnta::OtaJsonParser::validateLabel(child.second.data());
-        this->alphabet.push_back(child.second.data().front());
+        labels.push_back(child.second.data());
+      }
+      interner = AlphabetInterner{labels};
+      this->alphabet.reserve(labels.size());
+      for (const auto &label: labels) {
+        if (std::find(this->alphabet.begin(), this->alphabet.end(), interner.at(label)) == this->alphabet.end()) {
+          this->alphabet.push_back(interner.at(label));
+        }
       }
 
       // Construct states
@@ -70,8 +81,7 @@ namespace learnta {
         auto it = child.second.begin();
         const std::string sourceName = it->second.data();
         it = boost::next(it);
-        learnta::OtaJsonParser::validateLabel(it->second.data());
-        const Alphabet label = it->second.data().front();
+        const Alphabet label = toAction(it->second.data());
         it = boost::next(it);
         const std::string range = it->second.data();
         it = boost::next(it);
@@ -133,6 +143,11 @@ namespace learnta {
       return alphabet;
     }
 
+    //! @brief The labels of the actions in the json file
+    [[nodiscard]] const AlphabetInterner &getInterner() const {
+      return interner;
+    }
+
     [[nodiscard]] const TimedAutomaton &getTarget() const {
       return target;
     }
@@ -0,0 +1,126 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/15.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "timed_automaton.hh"
+
+namespace learnta {
+  //! @brief The JSON string literal of the given string. The quotes, backslashes, and control characters are escaped.
+  static inline std::string quoteJson(const std::string &value) {
+    std::string result = "\"";
+    for (const char c: value) {
+      if (c == '"' || c == '\\') {
+        result.push_back('\\');
+        result.push_back(c);
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        char escaped[7];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+        result += escaped;
+      } else {
+        result.push_back(c);
+      }
+    }
+    return result + "\"";
+  }
+
+  /*!
+   * @brief Write a one-clock TA in the json format of https://github.com/Leslieaj/OTALearning
+   *
+   * This is the inverse of OtaJsonParser. The states are named "1", "2", ... in the order of TimedAutomaton::states.
+   *
+   * @throws std::invalid_argument if the TA is not representable in the format, e.g., it has more than one clock
+   */
+  static inline void writeOtaJson(std::ostream &os, const std::vector<Alphabet> &alphabet,
+                                  const TimedAutomaton &automaton, const std::string &name) {
+    if (automaton.initialStates.size() != 1) {
+      throw std::invalid_argument("The OTA json format requires exactly one initial state");
+    }
+    std::unordered_map<const TAState *, std::size_t> toIndex;
+    for (std::size_t i = 0; i < automaton.states.size(); ++i) {
+      toIndex[automaton.states.at(i).get()] = i + 1;
+    }
+    auto quote = [](const auto &value) {
+      return quoteJson(std::string{value});
+    };
+    // The label of an action is the character itself. With LEARNTA_WIDE_ALPHABET, only the ASCII ones are characters.
+    auto label = [](Alphabet action) {
+      if (sizeof(Alphabet) > 1 && static_cast<std::make_unsigned_t<Alphabet>>(action) > 0x7F) {
+        throw std::invalid_argument("The OTA json format supports only the ASCII actions");
+      }
+      return std::string(1, static_cast<char>(action));
+    };
+    auto makeRange = [](const std::vector<Constraint> &guard) {
+      std::optional<Constraint> lower, upper;
+      for (const auto &constraint: guard) {
+        if (constraint.x != 0) {
+          throw std::invalid_argument("The OTA json format supports only one clock");
+        }
+        auto &bound = constraint.isUpperBound() ? upper : lower;
+        if (bound) {
+          throw std::invalid_argument("The OTA json format supports only one lower and upper bound");
+        }
+        bound = constraint;
+      }
+      std::string range = !lower ? "[0" : (lower->odr == Constraint::Order::ge ? "[" : "(") + std::to_string(lower->c);
+      range += ",";
+      range += !upper ? "+)" : std::to_string(upper->c) + (upper->odr == Constraint::Order::le ? "]" : ")");
+      return range;
+    };
+
+    os << "{\n  \"name\": " << quote(name) << ",\n  \"l\": [";
+    for (std::size_t i = 1; i <= automaton.states.size(); ++i) {
+      os << (i > 1 ? ", " : "") << quote(std::to_string(i));
+    }
+    os << "],\n  \"sigma\": [";
+    for (std::size_t i = 0; i < alphabet.size(); ++i) {
+      os << (i > 0 ? ", " : "") << quote(label(alphabet.at(i)));
+    }
+    os << "],\n  \"tran\": {";
+    std::size_t numTransitions = 0;
+    for (const auto &state: automaton.states) {
+      // We follow the order of the alphabet for a reproducible output
+      for (const Alphabet action: alphabet) {
+        auto it = state->next.find(action);
+        if (it == state->next.end()) {
+          continue;
+        }
+        for (const auto &transition: it->second) {
+          bool reset = false;
+          for (const auto &[clock, value]: transition.resetVars) {
+            if (clock != 0 || !std::holds_alternative<double>(value) || std::get<double>(value) != 0.0) {
+              throw std::invalid_argument("The OTA json format supports only the resets of the clock to zero");
+            }
+            reset = true;
+          }
+          os << (numTransitions > 0 ? "," : "") << "\n    " << quote(std::to_string(numTransitions)) << ": ["
+             << quote(std::to_string(toIndex.at(state.get()))) << ", " << quote(label(action)) << ", "
+             << quote(makeRange(transition.guard)) << ", " << quote(reset ? "r" : "n") << ", "
+             << quote(std::to_string(toIndex.at(transition.target))) << "]";
+          ++numTransitions;
+        }
+      }
+    }
+    os << "\n  },\n  \"init\": " << quote(std::to_string(toIndex.at(automaton.initialStates.front().get())))
+       << ",\n  \"accept\": [";
+    bool first = true;
+    for (std::size_t i = 0; i < automaton.states.size(); ++i) {
+      if (automaton.states.at(i)->isMatch) {
+        os << (first ? "" : ", ") << quote(std::to_string(i + 1));
+        first = false;
+      }
+    }
+    os << "]\n}\n";
+  }
+}
@@ -0,0 +1,172 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/16.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "common_types.hh"
+
+namespace learnta {
+  /*!
+   * @brief Interning of string labels to the dense identifiers of Alphabet
+   *
+   * The learner handles an action only by its identifier of Alphabet. This class gives the identifiers to the labels
+   * of arbitrary length, e.g., the events of a real system. A single-character label is mapped to the character itself
+   * if it is printable and not taken, so that the timed automata with the usual single-character alphabets do not
+   * change. The other labels are mapped to the unused printable characters. We only use the printable characters
+   * except for '"' and '\\' so that the actions can be written to the logs, the dot outputs, and the OTA JSON files
+   * without escaping. With LEARNTA_WIDE_ALPHABET, the labels beyond the printable characters are mapped to the dense
+   * identifiers from 0x80. We can intern at most capacity labels.
+   */
+  class AlphabetInterner {
+  private:
+    std::unordered_map<std::string, Alphabet> toAction;
+    //! @brief The label of each interned action
+    std::unordered_map<Alphabet, std::string> toLabel;
+    //! @brief The interned actions in the interned order
+    std::vector<Alphabet> actions;
+    //! @brief The codes to be used for the labels not mapped to themselves, the preferred ones first
+    std::vector<Alphabet> freshCodes;
+    std::size_t freshIndex = 0;
+
+    //! @brief If the action can be written to the outputs without escaping
+    static bool printable(Alphabet action) {
+      return action >= '!' && action <= '~' && action != '"' && action != '\\';
+    }
+
+    void assign(const std::string &label, Alphabet action) {
+      toAction[label] = action;
+      toLabel[action] = label;
+      actions.push_back(action);
+    }
+
+  public:
+    //! @brief The number of the printable characters except for '"' and '\\'
+    static constexpr std::size_t printableCapacity = '~' - '!' + 1 - 2;
+    //! @brief The number of the labels we can intern
+    static constexpr std::size_t capacity =
+            printableCapacity +
+            (sizeof(Alphabet) == 1 ? 0 : std::numeric_limits<std::make_unsigned_t<Alphabet>>::max() - 0x7F);
+
+    AlphabetInterner() {
+      const std::string preferred = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+      freshCodes.reserve(printableCapacity);
+      freshCodes.insert(freshCodes.end(), preferred.begin(), preferred.end());
+      for (char c = '!'; c <= '~'; ++c) {
+        if (preferred.find(c) == std::string::npos && printable(c)) {
+          freshCodes.push_back(c);
+        }
+      }
+    }
+
+    /*!
+     * @brief Intern all the given labels
+     *
+     * We intern the printable single-character labels first so that they are mapped to the characters themselves.
+     */
+    explicit AlphabetInterner(const std::vector<std::string> &labels) : AlphabetInterner() {
+      for (const auto &label: labels) {
+        if (label.size() == 1 && printable(label.front())) {
+          intern(label);
+        }
+      }
+      for (const auto &label: labels) {
+        intern(label);
+      }
+    }
+
+    /*!
+     * @brief Returns the action of the label. If the label is new, we give it a new action.
+     *
+     * @throws std::invalid_argument if the label is empty or the null character, or we have no more printable actions
+     */
+    Alphabet intern(const std::string &label) {
+      auto it = toAction.find(label);
+      if (it != toAction.end()) {
+        return it->second;
+      }
+      if (label.empty() || label == std::string(1, UNOBSERVABLE)) {
+        throw std::invalid_argument("Invalid label of an action: \"" + label + "\"");
+      }
+      if (label.size() == 1 && printable(label.front()) && toLabel.find(label.front()) == toLabel.end()) {
+        assign(label, label.front());
+        return label.front();
+      }
+      while (freshIndex < freshCodes.size() && toLabel.find(freshCodes.at(freshIndex)) != toLabel.end()) {
+        ++freshIndex;
+      }
+      if (freshIndex < freshCodes.size()) {
+        const auto action = freshCodes.at(freshIndex);
+        assign(label, action);
+        return action;
+      }
+      if (actions.size() >= capacity) {
+        throw std::invalid_argument("Too many labels of actions: at most " + std::to_string(capacity) +
+                                    " labels are supported" + (sizeof(Alphabet) == 1 ?
+                                                               ". Build with LEARNTA_WIDE_ALPHABET for more labels." :
+                                                               "."));
+      }
+      // All the printable characters are taken, and the identifiers from 0x80 are never taken by a single character
+      const auto action = static_cast<Alphabet>(0x80 + actions.size() - printableCapacity);
+      assign(label, action);
+      return action;
+    }
+
+    /*!
+     * @brief Returns the action of an interned label
+     *
+     * @throws std::out_of_range if the label is not interned
+     */
+    [[nodiscard]] Alphabet at(const std::string &label) const {
+      auto it = toAction.find(label);
+      if (it == toAction.end()) {
+        throw std::out_of_range("Unknown label of an action: \"" + label + "\"");
+      }
+      return it->second;
+    }
+
+    [[nodiscard]] bool contains(const std::string &label) const {
+      return toAction.find(label) != toAction.end();
+    }
+
+    /*!
+     * @brief Returns the label of an interned action
+     *
+     * @throws std::out_of_range if the action is not interned
+     */
+    [[nodiscard]] const std::string &label(Alphabet action) const {
+      auto it = toLabel.find(action);
+      if (it == toLabel.end()) {
+        throw std::out_of_range("Unknown action: " +
+                                std::to_string(static_cast<std::make_unsigned_t<Alphabet>>(action)));
+      }
+      return it->second;
+    }
+
+    //! @brief The interned actions in the interned order
+    [[nodiscard]] const std::vector<Alphabet> &alphabet() const {
+      return actions;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+      return actions.size();
+    }
+
+    //! @brief If every label is the single character of its action
+    [[nodiscard]] bool isIdentity() const {
+      return std::all_of(actions.begin(), actions.end(), [&](Alphabet action) {
+        const auto &actionLabel = label(action);
+        return actionLabel.size() == 1 && actionLabel.front() == action;
+      });
+    }
+  };
+}
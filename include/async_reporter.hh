@@ -0,0 +1,189 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/12.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <boost/log/trivial.hpp>
+
+#include "learner_observer.hh"
+#include "spsc_ring.hh"
+
+namespace learnta {
+  /*!
+   * @brief An observer writing the events to a file descriptor in a reporter thread
+   *
+   * The learner only pushes the events to a lock-free ring buffer, and the reporter thread drains it and writes one JSON
+   * object per line. If the ring is full because the writing is too slow, we drop the events rather than blocking the
+   * learner. The reporter also writes the number of the membership queries per second since the previous event.
+   *
+   * @note notify must be called from a single thread, i.e., the thread running the learner.
+   */
+  class AsyncReporter : public LearnerObserver {
+  private:
+    static constexpr std::size_t ringCapacity = 4096;
+    SPSCRing<LearnerEvent, ringCapacity> ring;
+    const int fd;
+    const bool isSocket;
+    std::atomic<bool> stopping{false};
+    std::atomic<std::size_t> numDropped{0};
+    bool broken = false;
+    // The previous event to compute the throughput of the membership queries
+    double previousTime = 0;
+    std::size_t previousMembershipQueries = 0;
+    std::thread reporter;
+
+    //! @brief Write all the bytes. We give up writing after an error, e.g., when the socket is closed by the peer.
+    void writeAll(const std::string &data) {
+      std::size_t written = 0;
+      while (!broken && written < data.size()) {
+        // We use send for sockets to avoid SIGPIPE
+        const ssize_t result = isSocket ? ::send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL)
+                                        : ::write(fd, data.data() + written, data.size() - written);
+        if (result < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          BOOST_LOG_TRIVIAL(warning) << "AsyncReporter: failed to write the events: " << std::strerror(errno);
+          broken = true;
+        } else {
+          written += result;
+        }
+      }
+    }
+
+    void write(const LearnerEvent &event) {
+      const double elapsed = event.time - previousTime;
+      const double queriesPerSecond =
+              elapsed > 0 ? (event.numMembershipQueries - previousMembershipQueries) / elapsed : 0;
+      previousTime = event.time;
+      previousMembershipQueries = event.numMembershipQueries;
+      std::stringstream stream;
+      stream << "{\"event\":\"" << event.kind << "\",\"iteration\":" << event.iteration
+             << ",\"time\":" << event.time << ",\"duration\":" << event.duration
+             << ",\"p\":" << event.numP << ",\"prefixes\":" << event.numPrefixes
+             << ",\"suffixes\":" << event.numSuffixes
+             << ",\"membership_queries\":" << event.numMembershipQueries
+             << ",\"queries_per_second\":" << queriesPerSecond;
+      switch (event.kind) {
+        case LearnerEvent::Kind::HYPOTHESIS:
+          stream << ",\"states\":" << event.numStates << ",\"transitions\":" << event.numTransitions;
+          break;
+        case LearnerEvent::Kind::COUNTER_EXAMPLE:
+          stream << ",\"counterexamples\":" << event.numCounterExamples
+                 << ",\"counterexample_length\":" << event.counterExampleLength;
+          break;
+        case LearnerEvent::Kind::MEMBERSHIP_BATCH:
+          stream << ",\"cells\":" << event.numCells;
+          break;
+        case LearnerEvent::Kind::TABLE_CLOSED:
+          break;
+      }
+      stream << "}\n";
+      writeAll(stream.str());
+    }
+
+    void drain() {
+      while (true) {
+        const bool lastRound = stopping.load(std::memory_order_acquire);
+        while (auto event = ring.tryPop()) {
+          write(*event);
+        }
+        if (lastRound) {
+          // All the events pushed before stop are written
+          return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+
+  public:
+    /*!
+     * @param fd The file descriptor to write the events. It is closed by the destructor.
+     * @param isSocket If fd is a socket
+     */
+    AsyncReporter(int fd, bool isSocket) : fd(fd), isSocket(isSocket) {
+      reporter = std::thread([this] {
+        drain();
+      });
+    }
+
+    AsyncReporter(const AsyncReporter &) = delete;
+
+    AsyncReporter &operator=(const AsyncReporter &) = delete;
+
+    //! @brief Write the remaining events and close the file descriptor
+    ~AsyncReporter() override {
+      stopping.store(true, std::memory_order_release);
+      reporter.join();
+      if (numDropped > 0) {
+        BOOST_LOG_TRIVIAL(warning) << "AsyncReporter: " << numDropped << " events are dropped";
+      }
+      ::close(fd);
+    }
+
+    /*!
+     * @brief Make a reporter writing to the given file
+     *
+     * @throws std::runtime_error if we cannot open the file
+     */
+    static std::unique_ptr<AsyncReporter> toFile(const std::string &path) {
+      const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      if (fd < 0) {
+        throw std::runtime_error("Failed to open " + path + ": " + std::strerror(errno));
+      }
+      return std::make_unique<AsyncReporter>(fd, false);
+    }
+
+    /*!
+     * @brief Make a reporter writing to the Unix domain socket listened at the given path
+     *
+     * @throws std::runtime_error if we cannot connect to the socket
+     */
+    static std::unique_ptr<AsyncReporter> toUnixSocket(const std::string &path) {
+      sockaddr_un address{};
+      address.sun_family = AF_UNIX;
+      if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("The socket path is too long: " + path);
+      }
+      std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+      const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+      if (fd < 0) {
+        throw std::runtime_error(std::string{"Failed to make a socket: "} + std::strerror(errno));
+      }
+      if (::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0) {
+        const std::string message = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Failed to connect to " + path + ": " + message);
+      }
+      return std::make_unique<AsyncReporter>(fd, true);
+    }
+
+    void notify(const LearnerEvent &event) override {
+      if (!ring.tryPush(event)) {
+        numDropped.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    //! @brief The number of the events dropped because the ring was full
+    [[nodiscard]] std::size_t dropped() const {
+      return numDropped.load(std::memory_order_relaxed);
+    }
+  };
+}
@@ -56,7 +56,7 @@ namespace learnta {
     /*!
      * @brief Construct the discrete predecessor
      */
-    [[nodiscard]] BackwardRegionalElementaryLanguage predecessor(char action) const {
+    [[nodiscard]] BackwardRegionalElementaryLanguage predecessor(Alphabet action) const {
       return {{action + this->word, this->timedCondition.extendZero()}, fractionalOrder.extendZero()};
     }
 
@@ -0,0 +1,227 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/17.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <ostream>
+
+#include <boost/functional/hash.hpp>
+
+#include "common_types.hh"
+
+namespace learnta {
+  /*!
+   * @brief A set of clock variables as a fixed-width bitset
+   *
+   * Since ClockVariables is uint8_t, any set of clock variables fits in 256 bits. Unlike std::unordered_set or a sorted
+   * std::vector, the union, intersection, comparison, and hashing are constant-time and need no allocation, which
+   * matters because such sets are used as the keys of hash maps in the DTA construction. The iteration is in the
+   * ascending order of the clock variables.
+   */
+  class ClockSet {
+  private:
+    static constexpr std::size_t wordBits = 64;
+    static constexpr std::size_t numWords = (std::numeric_limits<ClockVariables>::max() + 1) / wordBits;
+    std::array<std::uint64_t, numWords> words{};
+
+    static constexpr std::uint64_t bit(ClockVariables clock) {
+      return std::uint64_t{1} << (clock % wordBits);
+    }
+
+  public:
+    //! @brief Forward iterator over the clock variables in the set in the ascending order
+    class const_iterator {
+    private:
+      const ClockSet *set;
+      // The current clock variable, or numWords * wordBits at the end
+      std::size_t current;
+
+      void skip() {
+        while (current < numWords * wordBits) {
+          const auto rest = set->words.at(current / wordBits) >> (current % wordBits);
+          if (rest != 0) {
+            current += __builtin_ctzll(rest);
+            return;
+          }
+          current = (current / wordBits + 1) * wordBits;
+        }
+      }
+
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = ClockVariables;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const ClockVariables *;
+      using reference = ClockVariables;
+
+      const_iterator(const ClockSet *set, std::size_t current) : set(set), current(current) {
+        skip();
+      }
+
+      ClockVariables operator*() const {
+        return static_cast<ClockVariables>(current);
+      }
+
+      const_iterator &operator++() {
+        ++current;
+        skip();
+        return *this;
+      }
+
+      const_iterator operator++(int) {
+        auto old = *this;
+        ++*this;
+        return old;
+      }
+
+      bool operator==(const const_iterator &another) const {
+        return current == another.current;
+      }
+
+      bool operator!=(const const_iterator &another) const {
+        return current != another.current;
+      }
+    };
+
+    ClockSet() = default;
+
+    ClockSet(std::initializer_list<ClockVariables> clocks) {
+      for (const auto clock: clocks) {
+        insert(clock);
+      }
+    }
+
+    template<class InputIterator>
+    ClockSet(InputIterator first, InputIterator last) {
+      for (; first != last; ++first) {
+        insert(*first);
+      }
+    }
+
+    //! @brief The set of the clock variables in [0, size)
+    static ClockSet range(std::size_t size) {
+      ClockSet result;
+      for (std::size_t i = 0; i < numWords && size > 0; ++i) {
+        const auto n = std::min(size, wordBits);
+        result.words.at(i) = n == wordBits ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1;
+        size -= n;
+      }
+      return result;
+    }
+
+    void insert(ClockVariables clock) {
+      words[clock / wordBits] |= bit(clock);
+    }
+
+    void erase(ClockVariables clock) {
+      words[clock / wordBits] &= ~bit(clock);
+    }
+
+    [[nodiscard]] bool contains(ClockVariables clock) const {
+      return words[clock / wordBits] & bit(clock);
+    }
+
+    [[nodiscard]] bool empty() const {
+      for (const auto word: words) {
+        if (word != 0) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+      std::size_t result = 0;
+      for (const auto word: words) {
+        result += __builtin_popcountll(word);
+      }
+      return result;
+    }
+
+    [[nodiscard]] const_iterator begin() const {
+      return {this, 0};
+    }
+
+    [[nodiscard]] const_iterator end() const {
+      return {this, numWords * wordBits};
+    }
+
+    ClockSet &operator|=(const ClockSet &another) {
+      for (std::size_t i = 0; i < numWords; ++i) {
+        words[i] |= another.words[i];
+      }
+      return *this;
+    }
+
+    ClockSet &operator&=(const ClockSet &another) {
+      for (std::size_t i = 0; i < numWords; ++i) {
+        words[i] &= another.words[i];
+      }
+      return *this;
+    }
+
+    friend ClockSet operator|(ClockSet left, const ClockSet &right) {
+      return left |= right;
+    }
+
+    friend ClockSet operator&(ClockSet left, const ClockSet &right) {
+      return left &= right;
+    }
+
+    bool operator==(const ClockSet &another) const {
+      return words == another.words;
+    }
+
+    bool operator!=(const ClockSet &another) const {
+      return words != another.words;
+    }
+
+    //! @brief A total order for the ordered containers. This is not the inclusion.
+    bool operator<(const ClockSet &another) const {
+      return words < another.words;
+    }
+
+    [[nodiscard]] std::size_t hash_value() const {
+      std::size_t seed = 0;
+      for (const auto word: words) {
+        boost::hash_combine(seed, word);
+      }
+      return seed;
+    }
+  };
+
+  static inline std::size_t hash_value(const ClockSet &clocks) {
+    return clocks.hash_value();
+  }
+
+  static inline std::ostream &operator<<(std::ostream &os, const ClockSet &clocks) {
+    os << "{";
+    bool initial = true;
+    for (const auto clock: clocks) {
+      if (!initial) {
+        os << ", ";
+      }
+      os << "x" << static_cast<int>(clock);
+      initial = false;
+    }
+    return os << "}";
+  }
+}
+
+namespace std {
+  template<>
+  struct hash<learnta::ClockSet> {
+    std::size_t operator()(const learnta::ClockSet &clocks) const {
+      return clocks.hash_value();
+    }
+  };
+}
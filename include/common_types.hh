@@ -2,10 +2,44 @@
 
 #include <cstdint>
 #include <memory>
+#include <ostream>
+#include <string>
 #include <vector>
 
 namespace learnta {
+#ifdef LEARNTA_WIDE_ALPHABET
+  /*!
+   * @brief An action
+   *
+   * With LEARNTA_WIDE_ALPHABET, an action is a 16-bit identifier so that the systems with thousands of event types can
+   * be learned through AlphabetInterner. Otherwise, an action is a character.
+   */
+  typedef char16_t Alphabet;
+#else
   typedef char Alphabet;
+#endif
+  //! @brief A sequence of actions
+  typedef std::basic_string<Alphabet> Word;
+
+#ifdef LEARNTA_WIDE_ALPHABET
+  //! @brief The identifier of the action as a decimal number
+  static inline std::string actionToString(Alphabet action) {
+    return std::to_string(static_cast<unsigned int>(action));
+  }
+
+  //! @brief Print the identifiers of the actions separated by spaces
+  static inline std::ostream &operator<<(std::ostream &os, const Word &word) {
+    for (std::size_t i = 0; i < word.size(); ++i) {
+      os << (i == 0 ? "" : " ") << actionToString(word[i]);
+    }
+    return os;
+  }
+#else
+  //! @brief The action as a character
+  static inline std::string actionToString(Alphabet action) {
+    return std::string(1, action);
+  }
+#endif
   typedef uint8_t ClockVariables;
   // Special action for unobservable transitions
   const Alphabet UNOBSERVABLE = 0;
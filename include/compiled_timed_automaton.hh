@@ -0,0 +1,571 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/19.
+ * @brief Compact binary form of a DTA loaded through a read-only memory mapping
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "sul.hh"
+#include "timed_automaton.hh"
+#include "timed_automaton_runner.hh"
+
+namespace learnta {
+  /*!
+   * @brief A read-only DTA in a flat binary layout, which is used in place without any parsing or allocation
+   *
+   * The binary file consists of the following sections, each of which is an array of fixed-size records. The offset
+   * of each section is a multiple of 8 so that the records are aligned in the mapped memory.
+   *
+   * | Header | int32: maxConstraints (padded) | State[] | Transition[] | Guard constraint pool | Reset pool |
+   *
+   * The transitions of a state are contiguous and sorted by the action, and the guard and the reset of a transition
+   * are contiguous ranges of the pools. The integers are in the native byte order: as in Serializer, we do not aim at
+   * the portability between platforms. The header has the version of the format and the FNV-1a checksum of the rest of
+   * the file. The loaded file is validated once, and then the DTA is executed by CompiledTimedAutomatonRunner.
+   *
+   * When loaded by map, the file is shared by all the processes mapping it through the page cache.
+   */
+  class CompiledTimedAutomaton {
+  public:
+    static constexpr char magic[8] = {'L', 'T', 'A', 'D', 'T', 'A', '\0', '\0'};
+    //! @brief The version of the format. The layout of Transition depends on the width of Alphabet.
+    static constexpr std::uint32_t version = sizeof(Alphabet) == 1 ? 1 : 2;
+    static constexpr std::uint32_t noState = std::numeric_limits<std::uint32_t>::max();
+
+    struct Header {
+      char magic[8];
+      std::uint32_t version;
+      std::uint32_t checksum;
+      std::uint32_t numClocks;
+      std::uint32_t numStates;
+      //! @brief The index of the initial state, or noState if there is no state
+      std::uint32_t initialState;
+      std::uint32_t numTransitions;
+      std::uint32_t numConstraints;
+      std::uint32_t numResets;
+    };
+
+    struct State {
+      std::uint32_t firstTransition;
+      std::uint32_t numTransitions;
+      std::uint32_t isMatch;
+      std::uint32_t padding;
+    };
+
+    struct Transition {
+      std::uint32_t target;
+      std::uint32_t firstConstraint;
+      std::uint32_t numConstraints;
+      std::uint32_t firstReset;
+      std::uint32_t numResets;
+      Alphabet action;
+      char padding[4 - sizeof(Alphabet)];
+    };
+
+    struct Constraint {
+      std::int32_t c;
+      ClockVariables x;
+      //! @brief The value of Constraint::Order
+      std::uint8_t odr;
+      char padding[2];
+
+      [[nodiscard]] learnta::Constraint toConstraint() const {
+        return {x, static_cast<learnta::Constraint::Order>(odr), c};
+      }
+    };
+
+    struct Reset {
+      //! @brief The new value if fromClock is 0
+      double value;
+      ClockVariables x;
+      //! @brief If it is not 0, the new value is the value of the clock variable source before the reset
+      std::uint8_t fromClock;
+      ClockVariables source;
+      char padding[5];
+    };
+
+  private:
+    // The mapped file or the owned bytes, which are shared by the copies
+    std::shared_ptr<const void> storage;
+    const char *data = nullptr;
+    std::size_t size = 0;
+    const Header *header = nullptr;
+    const std::int32_t *maxConstraintsBegin = nullptr;
+    const State *statesBegin = nullptr;
+    const Transition *transitionsBegin = nullptr;
+    const Constraint *constraintsBegin = nullptr;
+    const Reset *resetsBegin = nullptr;
+
+    static constexpr std::size_t align(std::size_t offset) {
+      return (offset + 7) / 8 * 8;
+    }
+
+    static std::uint32_t checksum(const char *begin, const char *end) {
+      std::uint32_t hash = 2166136261u;
+      for (; begin != end; ++begin) {
+        hash ^= static_cast<unsigned char>(*begin);
+        hash *= 16777619u;
+      }
+      return hash;
+    }
+
+    template<class T>
+    static void append(std::string &buffer, const T &record) {
+      static_assert(std::is_trivially_copyable_v<T>);
+      buffer.append(reinterpret_cast<const char *>(&record), sizeof(T));
+    }
+
+    static void pad(std::string &buffer) {
+      buffer.resize(align(buffer.size()), '\0');
+    }
+
+    //! @brief The section of count records of T at offset, which is advanced to the next section
+    template<class T>
+    const T *section(std::size_t &offset, std::size_t count) const {
+      static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= 8);
+      if (offset > size || count > (size - offset) / sizeof(T)) {
+        throw std::runtime_error("The compiled timed automaton is truncated");
+      }
+      const auto *result = reinterpret_cast<const T *>(data + offset);
+      offset = align(offset + count * sizeof(T));
+      return result;
+    }
+
+    //! @brief Locate the sections and check that all the indices are in range
+    void validate() {
+      if (reinterpret_cast<std::uintptr_t>(data) % 8 != 0) {
+        throw std::invalid_argument("The compiled timed automaton must be aligned to 8 bytes");
+      }
+      if (size < sizeof(Header) || std::memcmp(data, magic, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a compiled timed automaton");
+      }
+      header = reinterpret_cast<const Header *>(data);
+      if (header->version != version) {
+        throw std::runtime_error("Unsupported version of the compiled timed automaton: " +
+                                 std::to_string(header->version) + " (expected " + std::to_string(version) + ")");
+      }
+      std::size_t offset = align(sizeof(Header));
+      maxConstraintsBegin = section<std::int32_t>(offset, header->numClocks);
+      statesBegin = section<State>(offset, header->numStates);
+      transitionsBegin = section<Transition>(offset, header->numTransitions);
+      constraintsBegin = section<Constraint>(offset, header->numConstraints);
+      resetsBegin = section<Reset>(offset, header->numResets);
+      if (offset != size) {
+        throw std::runtime_error("The size of the compiled timed automaton does not match its header");
+      }
+      if (checksum(data + sizeof(Header), data + size) != header->checksum) {
+        throw std::runtime_error("The checksum of the compiled timed automaton does not match");
+      }
+
+      auto inRange = [](std::uint64_t first, std::uint64_t count, std::uint64_t limit) {
+        return first <= limit && count <= limit - first;
+      };
+      bool valid = header->numClocks <= std::numeric_limits<ClockVariables>::max() + 1u;
+      valid = valid && (header->numStates == 0 ? header->initialState == noState :
+                        header->initialState < header->numStates);
+      for (std::size_t i = 0; valid && i < header->numStates; ++i) {
+        const State &state = statesBegin[i];
+        valid = inRange(state.firstTransition, state.numTransitions, header->numTransitions) &&
+                std::is_sorted(transitionsBegin + state.firstTransition,
+                               transitionsBegin + state.firstTransition + state.numTransitions,
+                               [](const Transition &left, const Transition &right) {
+                                 return left.action < right.action;
+                               });
+      }
+      for (std::size_t i = 0; valid && i < header->numTransitions; ++i) {
+        const Transition &transition = transitionsBegin[i];
+        valid = transition.target < header->numStates &&
+                inRange(transition.firstConstraint, transition.numConstraints, header->numConstraints) &&
+                inRange(transition.firstReset, transition.numResets, header->numResets);
+      }
+      for (std::size_t i = 0; valid && i < header->numConstraints; ++i) {
+        valid = constraintsBegin[i].x < header->numClocks &&
+                constraintsBegin[i].odr <= static_cast<std::uint8_t>(learnta::Constraint::Order::gt);
+      }
+      for (std::size_t i = 0; valid && i < header->numResets; ++i) {
+        valid = resetsBegin[i].x < header->numClocks &&
+                (!resetsBegin[i].fromClock || resetsBegin[i].source < header->numClocks);
+      }
+      if (!valid) {
+        throw std::runtime_error("The compiled timed automaton has an index out of range");
+      }
+    }
+
+    CompiledTimedAutomaton() = default;
+
+  public:
+    /*!
+     * @brief Write the given DTA in the binary format
+     *
+     * @throws std::invalid_argument if the DTA does not have exactly one initial state or refers to a state not in
+     * TimedAutomaton::states or a clock variable not in TimedAutomaton::maxConstraints
+     */
+    static void write(std::ostream &os, const TimedAutomaton &automaton) {
+      if (!automaton.states.empty() && automaton.initialStates.size() != 1) {
+        throw std::invalid_argument("The compiled timed automaton requires exactly one initial state");
+      }
+      std::unordered_map<const TAState *, std::uint32_t> toIndex;
+      for (std::size_t i = 0; i < automaton.states.size(); ++i) {
+        toIndex[automaton.states.at(i).get()] = static_cast<std::uint32_t>(i);
+      }
+      auto index = [&](const TAState *state) {
+        auto it = toIndex.find(state);
+        if (it == toIndex.end()) {
+          throw std::invalid_argument("The DTA refers to a state not in TimedAutomaton::states");
+        }
+        return it->second;
+      };
+      auto clock = [&](ClockVariables x) {
+        if (x >= automaton.maxConstraints.size()) {
+          throw std::invalid_argument("The DTA refers to an unknown clock variable x" + std::to_string(x));
+        }
+        return x;
+      };
+
+      std::vector<State> states;
+      std::vector<Transition> transitions;
+      std::vector<Constraint> constraints;
+      std::vector<Reset> resets;
+      states.reserve(automaton.states.size());
+      for (const auto &state: automaton.states) {
+        states.push_back({static_cast<std::uint32_t>(transitions.size()), 0, state->isMatch, 0});
+        // The transitions are sorted by the action to look them up by a binary search
+        std::vector<Alphabet> actions;
+        actions.reserve(state->next.size());
+        for (const auto &[action, stateTransitions]: state->next) {
+          actions.push_back(action);
+        }
+        std::sort(actions.begin(), actions.end());
+        for (const Alphabet action: actions) {
+          for (const TATransition &transition: state->next.at(action)) {
+            transitions.push_back({index(transition.target), static_cast<std::uint32_t>(constraints.size()),
+                                   static_cast<std::uint32_t>(transition.guard.size()),
+                                   static_cast<std::uint32_t>(resets.size()),
+                                   static_cast<std::uint32_t>(transition.resetVars.size()), action, {}});
+            for (const learnta::Constraint &constraint: transition.guard) {
+              constraints.push_back({constraint.c, clock(constraint.x), static_cast<std::uint8_t>(constraint.odr),
+                                     {}});
+            }
+            for (const auto &[resetVariable, targetVariable]: transition.resetVars) {
+              if (targetVariable.index() == 1) {
+                resets.push_back({0.0, clock(resetVariable), 1, clock(std::get<ClockVariables>(targetVariable)), {}});
+              } else {
+                resets.push_back({std::get<double>(targetVariable), clock(resetVariable), 0, 0, {}});
+              }
+            }
+          }
+        }
+        states.back().numTransitions = static_cast<std::uint32_t>(transitions.size()) - states.back().firstTransition;
+      }
+
+      Header header{};
+      std::copy(std::begin(magic), std::end(magic), header.magic);
+      header.version = version;
+      header.numClocks = static_cast<std::uint32_t>(automaton.maxConstraints.size());
+      header.numStates = static_cast<std::uint32_t>(states.size());
+      header.initialState = automaton.states.empty() ? noState : index(automaton.initialStates.front().get());
+      header.numTransitions = static_cast<std::uint32_t>(transitions.size());
+      header.numConstraints = static_cast<std::uint32_t>(constraints.size());
+      header.numResets = static_cast<std::uint32_t>(resets.size());
+
+      std::string body;
+      append(body, header);
+      pad(body);
+      for (const int maxConstraint: automaton.maxConstraints) {
+        append(body, static_cast<std::int32_t>(maxConstraint));
+      }
+      pad(body);
+      for (const auto &record: states) {
+        append(body, record);
+      }
+      for (const auto &record: transitions) {
+        append(body, record);
+      }
+      for (const auto &record: constraints) {
+        append(body, record);
+      }
+      for (const auto &record: resets) {
+        append(body, record);
+      }
+      header.checksum = checksum(body.data() + sizeof(Header), body.data() + body.size());
+      std::memcpy(body.data(), &header, sizeof(Header));
+      os.write(body.data(), static_cast<std::streamsize>(body.size()));
+    }
+
+    /*!
+     * @brief Load the DTA from the bytes written by write
+     *
+     * @throws std::runtime_error if the bytes are broken or in another version of the format
+     */
+    static CompiledTimedAutomaton fromBytes(std::string bytes) {
+      CompiledTimedAutomaton result;
+      auto owned = std::make_shared<const std::string>(std::move(bytes));
+      result.data = owned->data();
+      result.size = owned->size();
+      result.storage = std::move(owned);
+      result.validate();
+      return result;
+    }
+
+    /*!
+     * @brief Map the file written by write without copying it
+     *
+     * @throws std::runtime_error if the file cannot be mapped, or it is broken or in another version of the format
+     */
+    static CompiledTimedAutomaton map(const std::string &path) {
+      const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) {
+        throw std::runtime_error("Failed to open the compiled timed automaton " + path + ": " + std::strerror(errno));
+      }
+      struct stat status{};
+      if (fstat(fd, &status) != 0) {
+        const int error = errno;
+        close(fd);
+        throw std::runtime_error("Failed to stat the compiled timed automaton " + path + ": " + std::strerror(error));
+      }
+      const auto fileSize = static_cast<std::size_t>(status.st_size);
+      // mmap does not accept the empty mapping, which is anyway not a compiled timed automaton
+      void *mapped = fileSize == 0 ? MAP_FAILED : mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+      const int error = errno;
+      // The mapping is valid after closing the file
+      close(fd);
+      if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Failed to map the compiled timed automaton " + path + ": " +
+                                 (fileSize == 0 ? "the file is empty" : std::strerror(error)));
+      }
+      CompiledTimedAutomaton result;
+      result.storage = std::shared_ptr<const void>(mapped, [fileSize](const void *pointer) {
+        munmap(const_cast<void *>(pointer), fileSize);
+      });
+      result.data = static_cast<const char *>(mapped);
+      result.size = fileSize;
+      result.validate();
+      return result;
+    }
+
+    [[nodiscard]] std::size_t stateSize() const {
+      return header->numStates;
+    }
+
+    [[nodiscard]] std::size_t clockSize() const {
+      return header->numClocks;
+    }
+
+    [[nodiscard]] std::uint32_t initialState() const {
+      return header->initialState;
+    }
+
+    [[nodiscard]] bool isMatch(std::uint32_t state) const {
+      return statesBegin[state].isMatch;
+    }
+
+    [[nodiscard]] int maxConstraint(ClockVariables x) const {
+      return maxConstraintsBegin[x];
+    }
+
+    //! @brief The transitions from the state labelled with the action
+    [[nodiscard]] std::pair<const Transition *, const Transition *> transitions(std::uint32_t state,
+                                                                                  Alphabet action) const {
+      const Transition *begin = transitionsBegin + statesBegin[state].firstTransition;
+      const Transition *end = begin + statesBegin[state].numTransitions;
+      return std::equal_range(begin, end, Transition{0, 0, 0, 0, 0, action, {}},
+                              [](const Transition &left, const Transition &right) {
+                                return left.action < right.action;
+                              });
+    }
+
+    [[nodiscard]] std::pair<const Constraint *, const Constraint *> guard(const Transition &transition) const {
+      const Constraint *begin = constraintsBegin + transition.firstConstraint;
+      return {begin, begin + transition.numConstraints};
+    }
+
+    [[nodiscard]] std::pair<const Reset *, const Reset *> resets(const Transition &transition) const {
+      const Reset *begin = resetsBegin + transition.firstReset;
+      return {begin, begin + transition.numResets};
+    }
+
+    //! @brief Reconstruct the DTA as TimedAutomaton
+    [[nodiscard]] TimedAutomaton toTimedAutomaton() const {
+      TimedAutomaton automaton;
+      automaton.states.reserve(stateSize());
+      for (std::size_t i = 0; i < stateSize(); ++i) {
+        automaton.states.push_back(std::make_shared<TAState>(isMatch(i)));
+      }
+      for (std::size_t i = 0; i < stateSize(); ++i) {
+        const Transition *begin = transitionsBegin + statesBegin[i].firstTransition;
+        for (auto it = begin; it != begin + statesBegin[i].numTransitions; ++it) {
+          std::vector<learnta::Constraint> guardConstraints;
+          const auto [guardBegin, guardEnd] = guard(*it);
+          std::transform(guardBegin, guardEnd, std::back_inserter(guardConstraints), [](const Constraint &record) {
+            return record.toConstraint();
+          });
+          TATransition::Resets resetVars;
+          const auto [resetBegin, resetEnd] = resets(*it);
+          std::transform(resetBegin, resetEnd, std::back_inserter(resetVars), [](const Reset &record) {
+            return record.fromClock ? TATransition::Resets::value_type{record.x, record.source} :
+                   TATransition::Resets::value_type{record.x, record.value};
+          });
+          automaton.states.at(i)->next[it->action].emplace_back(automaton.states.at(it->target).get(),
+                                                                std::move(resetVars), std::move(guardConstraints));
+        }
+      }
+      if (stateSize() > 0) {
+        automaton.initialStates.push_back(automaton.states.at(initialState()));
+      }
+      automaton.maxConstraints.assign(maxConstraintsBegin, maxConstraintsBegin + clockSize());
+
+      return automaton;
+    }
+  };
+
+  /*!
+   * @brief Class to execute a compiled timed automaton
+   *
+   * This has the same semantics as TimedAutomatonRunner, and many runners can share the same compiled timed automaton.
+   */
+  class CompiledTimedAutomatonRunner : public SUL {
+  private:
+    std::shared_ptr<const CompiledTimedAutomaton> automaton;
+    std::uint32_t state = CompiledTimedAutomaton::noState;
+    std::vector<double> clockValuation;
+    std::vector<double> oldValuation;
+    std::size_t numQueries = 0;
+
+    [[nodiscard]] bool isMatch() const {
+      return state != CompiledTimedAutomaton::noState && automaton->isMatch(state);
+    }
+
+    void take(const CompiledTimedAutomaton::Transition &transition) {
+      const auto [begin, end] = automaton->resets(transition);
+      if (std::any_of(begin, end, [](const auto &reset) { return reset.fromClock; })) {
+        oldValuation = clockValuation;
+      }
+      for (auto it = begin; it != end; ++it) {
+        clockValuation[it->x] = it->fromClock ? oldValuation[it->source] : it->value;
+      }
+      state = transition.target;
+    }
+
+    /*!
+     * @brief The same as lowerBoundDurationToSatisfy for the guards
+     *
+     * As in the monitors made by generateMonitor, the empty guard is satisfied immediately.
+     */
+    [[nodiscard]] Bounds lowerBoundDurationToSatisfy(const CompiledTimedAutomaton::Transition &transition) const {
+      const auto [begin, end] = automaton->guard(transition);
+      if (begin == end) {
+        return {0.0, true};
+      }
+      Bounds result{std::numeric_limits<double>::infinity(), false};
+      for (auto it = begin; it != end; ++it) {
+        const double value = clockValuation[it->x];
+        switch (static_cast<Constraint::Order>(it->odr)) {
+          case Constraint::Order::lt:
+          case Constraint::Order::le:
+            result = std::min(result, value <= it->c ? Bounds{0.0, true} :
+                                      Bounds{-std::numeric_limits<double>::infinity(), false});
+            break;
+          case Constraint::Order::ge:
+          case Constraint::Order::gt: {
+            const bool closed = static_cast<Constraint::Order>(it->odr) == Constraint::Order::ge;
+            result = std::min({result, Bounds{0.0, true}, Bounds{-it->c + value, closed}});
+            break;
+          }
+        }
+      }
+      return result;
+    }
+
+  public:
+    explicit CompiledTimedAutomatonRunner(std::shared_ptr<const CompiledTimedAutomaton> automaton) :
+            automaton(std::move(automaton)), clockValuation(this->automaton->clockSize()) {
+      this->state = this->automaton->initialState();
+    }
+
+    void pre() override {
+      state = automaton->initialState();
+      std::fill(clockValuation.begin(), clockValuation.end(), 0);
+      numQueries++;
+    }
+
+    void post() override {
+    }
+
+    //! @brief The current state. This is CompiledTimedAutomaton::noState if we are at the sink state.
+    [[nodiscard]] std::uint32_t getState() const {
+      return state;
+    }
+
+    [[nodiscard]] const std::vector<double> &getClockValuation() const {
+      return clockValuation;
+    }
+
+    bool step(Alphabet action) override {
+      if (state == CompiledTimedAutomaton::noState) {
+        return false;
+      }
+      const auto [begin, end] = automaton->transitions(state, action);
+      for (auto it = begin; it != end; ++it) {
+        const auto [guardBegin, guardEnd] = automaton->guard(*it);
+        if (std::all_of(guardBegin, guardEnd, [&](const CompiledTimedAutomaton::Constraint &constraint) {
+          return constraint.toConstraint().satisfy(clockValuation[constraint.x]);
+        })) {
+          take(*it);
+          return isMatch();
+        }
+      }
+      // If there is no outgoing transition, we go to the sink state
+      state = CompiledTimedAutomaton::noState;
+      return false;
+    }
+
+    bool step(double duration) override {
+      if (state == CompiledTimedAutomaton::noState) {
+        return false;
+      }
+      using Candidate = std::pair<Bounds, const CompiledTimedAutomaton::Transition *>;
+      elapseWithUnobservable(duration, clockValuation, [&]() -> std::optional<Candidate> {
+        const auto [begin, end] = automaton->transitions(state, UNOBSERVABLE);
+        if (begin == end) {
+          return std::nullopt;
+        }
+        Candidate candidate{lowerBoundDurationToSatisfy(*begin), begin};
+        for (auto it = std::next(begin); it != end; ++it) {
+          const auto bound = lowerBoundDurationToSatisfy(*it);
+          if (bound < candidate.first) {
+            candidate = {bound, it};
+          }
+        }
+        return candidate;
+      }, [&](const CompiledTimedAutomaton::Transition *transition) {
+        take(*transition);
+      });
+      return isMatch();
+    }
+
+    [[nodiscard]] std::size_t count() const override {
+      return numQueries;
+    }
+  };
+}
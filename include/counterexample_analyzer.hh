@@ -9,23 +9,43 @@
 
 #include "recognizable_languages.hh"
 #include "membership_oracle.hh"
+#include "logging.hh"
 
 
 namespace learnta {
+  /*!
+   * @brief How analyzeCEX searches for the breakpoint of the counterexample
+   */
+  enum class CEXAnalysisMode {
+    //! @brief Scan the mapped words from the beginning. It takes O(n) membership queries.
+    LINEAR,
+    //! @brief Binary search over the mapped words. It takes O(log n) membership queries.
+    BINARY,
+    /*!
+     * @brief Exponential search from the end followed by binary search
+     *
+     * It takes O(log k) membership queries, where k is the distance of the breakpoint from the end.
+     */
+    EXPONENTIAL
+  };
+
   /*!
    * @brief Rivest-Schapire-style counterexample analysis
    *
    * @param[in] word The analyzed counterexample
    * @param[in] oracle The membership oracle
    * @param[in] hypothesis The hypothesis recognizable language
+   * @param[in] mode How we search for the breakpoint. If the suffix found by BINARY or EXPONENTIAL is not fresh, we
+   *            fall back to the linear search.
    *
    * @pre word is a counterexample. Namely, we should have oracle->answerQuery(word) != hypothesis.contains(word)
    */
   static inline std::optional<TimedWord> analyzeCEX(const TimedWord &word,
                                                    MembershipOracle &oracle,
                                                    const RecognizableLanguage &hypothesis,
-                                                   const std::vector<BackwardRegionalElementaryLanguage> &currentSuffixes = {}) {
-    BOOST_LOG_TRIVIAL(debug) << "hypothesis: " << hypothesis;
+                                                   const std::vector<BackwardRegionalElementaryLanguage> &currentSuffixes = {},
+                                                   const CEXAnalysisMode mode = CEXAnalysisMode::LINEAR) {
+    LEARNTA_LOG(debug) << "hypothesis: " << hypothesis;
     std::vector<TimedWord> mappedWords = {word};
     std::vector<TimedWord> suffixes = {TimedWord{}};
     std::vector<SingleMorphism> morphisms;
@@ -36,14 +56,18 @@ namespace learnta {
       morphisms.push_back(tripleOpt->morphism);
       mappedWords.push_back(tripleOpt->apply());
     }
-    // Conduct linear search
     bool hypothesisResult = hypothesis.contains(mappedWords.back());
-    const auto eval = [&] (const TimedWord &w) -> bool {
-      return oracle.answerQuery(w) == hypothesisResult;
+    // We memoize the evaluation so that each mapped word is queried at most once
+    std::vector<std::optional<bool>> evaluated(mappedWords.size());
+    const auto eval = [&] (const std::size_t index) -> bool {
+      if (!evaluated.at(index)) {
+        evaluated.at(index) = oracle.answerQuery(mappedWords.at(index)) == hypothesisResult;
+      }
+      return *evaluated.at(index);
     };
-    assert(eval(mappedWords.back()));
-    // assert(!eval(mappedWords.front()));
-    if (eval(mappedWords.front())) {
+    assert(eval(mappedWords.size() - 1));
+    // assert(!eval(0));
+    if (eval(0)) {
       // This happens when the given DTA is not row-faithful. This should not happen.
       BOOST_LOG_TRIVIAL(error) << "DTA construction is not working well. hypothesis: " << hypothesis;
       for (const auto &morphism: morphisms) {
@@ -67,14 +91,44 @@ namespace learnta {
       }
       return std::nullopt;
     }
+    const auto isFresh = [&] (const TimedWord &suffix) {
+      return std::all_of(currentSuffixes.begin(), currentSuffixes.end(), [&](const ElementaryLanguage &current) {
+        return !current.contains(suffix);
+      });
+    };
+    if (mode != CEXAnalysisMode::LINEAR) {
+      // Invariant: !eval(low) && eval(high)
+      std::size_t low = 0, high = mappedWords.size() - 1;
+      if (mode == CEXAnalysisMode::EXPONENTIAL) {
+        for (std::size_t step = 1; high - low > step; step *= 2) {
+          if (eval(high - step)) {
+            high -= step;
+          } else {
+            low = high - step;
+            break;
+          }
+        }
+      }
+      while (high - low > 1) {
+        const std::size_t middle = low + (high - low) / 2;
+        if (eval(middle)) {
+          high = middle;
+        } else {
+          low = middle;
+        }
+      }
+      if (isFresh(suffixes.at(high))) {
+        return suffixes.at(high);
+      }
+      LEARNTA_LOG(debug) << suffixes.at(high) << " is a counterexample but not fresh!! We use linear search";
+    }
+    // Conduct linear search
     for (std::size_t index = 0; index + 1 < mappedWords.size(); ++index) {
-      if (eval(mappedWords.at(index)) != eval(mappedWords.at(index + 1))) {
-        if (std::all_of(currentSuffixes.begin(), currentSuffixes.end(), [&](const ElementaryLanguage &suffix) {
-          return !suffix.contains(suffixes.at(index + 1));
-        })) {
+      if (eval(index) != eval(index + 1)) {
+        if (isFresh(suffixes.at(index + 1))) {
           return suffixes.at(index + 1);
         } else {
-          BOOST_LOG_TRIVIAL(debug) << suffixes.at(index + 1) << " is a counterexample but not fresh!!";
+          LEARNTA_LOG(debug) << suffixes.at(index + 1) << " is a counterexample but not fresh!!";
         }
       }
     }
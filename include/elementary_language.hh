@@ -22,21 +22,27 @@ namespace learnta {
    */
   class ElementaryLanguage {
   protected:
-    std::string word;
+    Word word;
     TimedCondition timedCondition;
   public:
     ElementaryLanguage() = default;
 
-    ElementaryLanguage(std::string word, TimedCondition timedCondition) :
+    ElementaryLanguage(Word word, TimedCondition timedCondition) :
             word(std::move(word)), timedCondition(std::move(timedCondition)) {
       assert(this->word.size() + 1 == this->timedCondition.size());
     }
 
+#ifdef LEARNTA_WIDE_ALPHABET
+    //! @brief Constructor of elementary languages of ASCII actions
+    ElementaryLanguage(const std::string &word, TimedCondition timedCondition) :
+            ElementaryLanguage(Word(word.begin(), word.end()), std::move(timedCondition)) {}
+#endif
+
     /*!
      * @brief Construct the empty elementary language containing only 0.
      */
     static ElementaryLanguage empty() {
-      ElementaryLanguage elementary {"", TimedCondition::empty()};
+      ElementaryLanguage elementary {Word{}, TimedCondition::empty()};
       assert(elementary.word.size() + 1 == elementary.timedCondition.size());
       return elementary;
     }
@@ -195,7 +201,7 @@ namespace learnta {
       return static_cast<bool>(condition);
     }
 
-    [[nodiscard]] const std::string &getWord() const {
+    [[nodiscard]] const Word &getWord() const {
       return word;
     }
 
@@ -31,8 +31,42 @@ namespace learnta {
       return std::nullopt;
     }
 
+    /*!
+     * @brief Make an equivalence query returning the counterexamples of the first oracle finding any
+     */
+    [[nodiscard]] std::vector<TimedWord> findCounterExamples(const TimedAutomaton &hypothesis,
+                                                             std::size_t maxCounterExamples) override {
+      ++eqQueryCount;
+      for (const auto &oracle: this->oracles) {
+        auto result = oracle->findCounterExamples(hypothesis, maxCounterExamples);
+        if (!result.empty()) {
+          return result;
+        }
+      }
+
+      return {};
+    }
+
     void push_back(std::unique_ptr<EquivalenceOracle> &&oracle) {
+      oracle->setCancellation(this->cancelled);
       oracles.push_back(std::move(oracle));
     }
+
+    void setCancellation(const std::atomic<bool> *flag) override {
+      EquivalenceOracle::setCancellation(flag);
+      for (const auto &oracle: this->oracles) {
+        oracle->setCancellation(flag);
+      }
+    }
+
+    //! @brief Print the statistics of the chain and of each oracle
+    std::ostream &printStatistics(std::ostream &stream) const override {
+      EquivalenceOracle::printStatistics(stream);
+      for (const auto &oracle: this->oracles) {
+        oracle->printStatistics(stream);
+      }
+
+      return stream;
+    }
   };
 }
\ No newline at end of file
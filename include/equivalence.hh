@@ -12,6 +12,8 @@
 #include "timed_condition_set.hh"
 #include "juxtaposed_zone_set.hh"
 #include "renaming_relation.hh"
+#include "instrumentation.hh"
+#include "logging.hh"
 
 namespace learnta {
   /*!
@@ -26,12 +28,12 @@ namespace learnta {
                           const std::vector<BackwardRegionalElementaryLanguage> &suffixes,
                           const RenamingRelation &renaming) {
 #ifdef LEARNTA_DEBUG_EQUIVALENCE
-    BOOST_LOG_TRIVIAL(trace) << "left: " << left;
-    BOOST_LOG_TRIVIAL(trace) << "right: " << right;
-    BOOST_LOG_TRIVIAL(trace) << "leftRowSize: " << leftRow.back().size();
-    // BOOST_LOG_TRIVIAL(trace) << "leftRowBack: " << leftRow.back().front();
-    BOOST_LOG_TRIVIAL(trace) << "rightRowSize: " << rightRow.back().size();
-    BOOST_LOG_TRIVIAL(trace) << "suffix.back(): " << suffixes.back();
+    LEARNTA_LOG(trace) << "left: " << left;
+    LEARNTA_LOG(trace) << "right: " << right;
+    LEARNTA_LOG(trace) << "leftRowSize: " << leftRow.back().size();
+    // LEARNTA_LOG(trace) << "leftRowBack: " << leftRow.back().front();
+    LEARNTA_LOG(trace) << "rightRowSize: " << rightRow.back().size();
+    LEARNTA_LOG(trace) << "suffix.back(): " << suffixes.back();
 #endif
     assert(leftRow.size() == rightRow.size());
     assert(rightRow.size() == suffixes.size());
@@ -75,12 +77,12 @@ namespace learnta {
                           const std::vector<BackwardRegionalElementaryLanguage> &suffixes,
                           const RenamingRelation &renaming) {
 #ifdef LEARNTA_DEBUG_EQUIVALENCE
-    BOOST_LOG_TRIVIAL(trace) << "left: " << left;
-    BOOST_LOG_TRIVIAL(trace) << "right: " << right;
-    BOOST_LOG_TRIVIAL(trace) << "leftRowSize: " << leftRow.back().size();
-    // BOOST_LOG_TRIVIAL(trace) << "leftRowBack: " << leftRow.back().front();
-    BOOST_LOG_TRIVIAL(trace) << "rightRowSize: " << rightRow.back().size();
-    BOOST_LOG_TRIVIAL(trace) << "suffix.back(): " << suffixes.back();
+    LEARNTA_LOG(trace) << "left: " << left;
+    LEARNTA_LOG(trace) << "right: " << right;
+    LEARNTA_LOG(trace) << "leftRowSize: " << leftRow.back().size();
+    // LEARNTA_LOG(trace) << "leftRowBack: " << leftRow.back().front();
+    LEARNTA_LOG(trace) << "rightRowSize: " << rightRow.back().size();
+    LEARNTA_LOG(trace) << "suffix.back(): " << suffixes.back();
 #endif
     assert(leftRow.size() == rightRow.size());
     assert(rightRow.size() == suffixes.size());
@@ -450,6 +452,10 @@ namespace learnta {
     auto it = std::find_if(candidates.begin(), candidates.end(), [&](const auto &candidate) {
       return equivalence(leftRightJuxtaposition, leftJuxtapositions, rightJuxtapositions, candidate);
     });
+    // The number of the candidates we tried
+    LEARNTA_COUNT("equivalence.renaming_candidates", std::distance(candidates.begin(), it) + (it != candidates.end()));
+    LEARNTA_RECORD("equivalence.renaming_candidates_per_search",
+                   std::distance(candidates.begin(), it) + (it != candidates.end()));
 
     if (it != candidates.end()) {
       return *it;
@@ -544,6 +550,10 @@ namespace learnta {
     auto it = std::find_if(candidates.begin(), candidates.end(), [&](const auto &candidate) {
       return equivalence(leftRightJuxtaposition, leftJuxtapositions, rightJuxtapositions, candidate);
     });
+    // The number of the candidates we tried
+    LEARNTA_COUNT("equivalence.renaming_candidates", std::distance(candidates.begin(), it) + (it != candidates.end()));
+    LEARNTA_RECORD("equivalence.renaming_candidates_per_search",
+                   std::distance(candidates.begin(), it) + (it != candidates.end()));
 
     if (it != candidates.end()) {
       return *it;
@@ -715,6 +725,10 @@ namespace learnta {
     auto it = std::find_if(candidates.begin(), candidates.end(), [&](const auto &candidate) {
       return equivalence(leftRightJuxtaposition, leftJuxtapositions, rightJuxtapositions, candidate);
     });
+    // The number of the candidates we tried
+    LEARNTA_COUNT("equivalence.renaming_candidates", std::distance(candidates.begin(), it) + (it != candidates.end()));
+    LEARNTA_RECORD("equivalence.renaming_candidates_per_search",
+                   std::distance(candidates.begin(), it) + (it != candidates.end()));
     if (it == candidates.end()) {
       // We add other equations in this case
       while (!candidates.empty()) {
@@ -5,10 +5,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <optional>
+#include <vector>
 
 #include "timed_automaton.hh"
 #include "timed_word.hh"
+#include "serialization.hh"
 
 namespace learnta {
   /*!
@@ -17,6 +20,14 @@ namespace learnta {
   class EquivalenceOracle {
   protected:
     std::size_t eqQueryCount = 0;
+    // If it is set and becomes true, the running query may give up and return no counterexample
+    const std::atomic<bool> *cancelled = nullptr;
+
+    //! @brief Check if the running query is cancelled
+    [[nodiscard]] bool isCancelled() const {
+      return cancelled && cancelled->load(std::memory_order_relaxed);
+    }
+
   public:
     virtual ~EquivalenceOracle() = default;
 
@@ -25,6 +36,31 @@ namespace learnta {
      */
     [[nodiscard]] virtual std::optional<TimedWord> findCounterExample(const TimedAutomaton &hypothesis) = 0;
 
+    /*!
+     * @brief Make an equivalence query returning at most maxCounterExamples counterexamples
+     *
+     * The oracles finding many counterexamples at once should override this. By default, we return the result of
+     * findCounterExample.
+     */
+    [[nodiscard]] virtual std::vector<TimedWord> findCounterExamples(const TimedAutomaton &hypothesis,
+                                                                     std::size_t maxCounterExamples) {
+      auto counterExample = this->findCounterExample(hypothesis);
+      if (counterExample && maxCounterExamples > 0) {
+        return {std::move(*counterExample)};
+      } else {
+        return {};
+      }
+    }
+
+    /*!
+     * @brief Set the flag to cancel the running queries cooperatively
+     *
+     * The oracles wrapping other oracles must pass the flag to them.
+     */
+    virtual void setCancellation(const std::atomic<bool> *flag) {
+      this->cancelled = flag;
+    }
+
     //! @brief Return the number of the executed equivalence queries
     [[nodiscard]] std::size_t numEqQueries() const {
       return eqQueryCount;
@@ -36,5 +72,11 @@ namespace learnta {
 
       return stream;
     }
+
+    //! @brief Write the memorized information to a checkpoint. The oracles without memory write nothing.
+    virtual void save(std::ostream &) const {}
+
+    //! @brief Restore the memorized information from a checkpoint written by save
+    virtual void load(std::istream &) {}
   };
 }
\ No newline at end of file
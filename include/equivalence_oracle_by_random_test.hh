@@ -5,18 +5,33 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
 #include <optional>
 #include <utility>
-#include <random>
+#include <vector>
 
 #include "timed_automaton.hh"
 #include "timed_word.hh"
 #include "equivalence_oracle.hh"
 #include "timed_automaton_runner.hh"
+#include "thread_pool.hh"
+#include "split_mix64.hh"
 
 namespace learnta {
   /*!
    * @brief The equivalence oracle by random test
+   *
+   * The i-th test of the q-th query is generated from a random stream determined by (seed, q, i). Therefore, the
+   * result depends only on the seed and not on the number of the threads. When we find counterexamples, we return the
+   * ones with the smallest test indices. The threads skip the tests after the found counterexamples but finish the ones
+   * before them.
    */
   class EquivalenceOracleByRandomTest : public EquivalenceOracle {
     const std::vector<Alphabet> alphabet;
@@ -24,57 +39,164 @@ namespace learnta {
     const int maxTests;
     const int maxLength;
     const double maxDuration;
+    const std::uint64_t seed;
+    // The worker threads. This is nullptr if we test sequentially.
+    std::unique_ptr<ThreadPool> threadPool;
+    // Statistics
+    std::size_t numTests = 0;
+    double testingSeconds = 0;
+
+    //! @brief The random stream of the given test
+    [[nodiscard]] SplitMix64 stream(std::size_t testIndex) const {
+      SplitMix64 mixer{seed};
+      SplitMix64 queryMixer{mixer() ^ static_cast<std::uint64_t>(eqQueryCount)};
+      return SplitMix64{queryMixer() ^ static_cast<std::uint64_t>(testIndex)};
+    }
+
+    /*!
+     * @brief Execute the given test
+     *
+     * @returns The counterexample if the test finds one
+     */
+    [[nodiscard]] std::optional<TimedWord> test(std::size_t testIndex, TimedAutomatonRunner &runner,
+                                                TimedAutomatonRunner &hypothesisRunner) const {
+      auto engine = stream(testIndex);
+
+      runner.pre();
+      hypothesisRunner.pre();
+      Word word;
+      std::vector<double> durations;
+      std::optional<TimedWord> result;
+      for (int j = 0; j < maxLength && !result; ++j) {
+        const double duration = engine.uniformReal() * maxDuration;
+        durations.push_back(duration);
+        if (runner.step(duration) != hypothesisRunner.step(duration)) {
+          result = TimedWord{word, durations};
+          break;
+        }
+        const auto wordIndex = engine.uniformIndex(alphabet.size());
+        word.push_back(alphabet.at(wordIndex));
+        if (runner.step(alphabet.at(wordIndex)) != hypothesisRunner.step(alphabet.at(wordIndex))) {
+          durations.push_back(0);
+          result = TimedWord{word, durations};
+        }
+      }
+      if (!result) {
+        const double duration = engine.uniformReal() * maxDuration;
+        durations.push_back(duration);
+        if (runner.step(duration) != hypothesisRunner.step(duration)) {
+          result = TimedWord{word, durations};
+        }
+      }
+      runner.post();
+      hypothesisRunner.post();
+
+      return result;
+    }
+
   public:
+    /*!
+     * @param seed The seed of all the random tests. The default is fixed so that the runs are reproducible.
+     * @param numThreads The number of the threads for the tests. If it is 0, we use all the hardware threads.
+     */
     EquivalenceOracleByRandomTest(std::vector<Alphabet> alphabet, TimedAutomaton automaton,
-                                  const int maxTests, const int maxLength, const int maxDuration) :
+                                  const int maxTests, const int maxLength, const int maxDuration,
+                                  const std::uint64_t seed = 0,
+                                  const std::size_t numThreads = 1) :
             alphabet(std::move(alphabet)),
             automaton(std::move(automaton)),
             maxTests(maxTests),
             maxLength(maxLength),
-            maxDuration(maxDuration) {}
+            maxDuration(maxDuration),
+            seed(seed) {
+      if (numThreads != 1) {
+        threadPool = std::make_unique<ThreadPool>(numThreads);
+        if (threadPool->size() == 1) {
+          threadPool.reset();
+        }
+      }
+    }
 
     /*!
      * @brief Make an equivalence query
      */
     [[nodiscard]] std::optional<TimedWord> findCounterExample(const TimedAutomaton &hypothesis) override {
-      ++eqQueryCount;
-      static std::random_device rng;
-      std::mt19937 engine(rng());
-
-      TimedAutomatonRunner runner(automaton);
-      TimedAutomatonRunner hypothesisRunner(hypothesis);
-      auto durationDist = std::uniform_real_distribution<double>(0, maxDuration);
-      auto actionDist = std::uniform_int_distribution(0, int(alphabet.size() - 1));
-
-      for (int i = 0; i < maxTests; ++i) {
-        runner.pre();
-        hypothesisRunner.pre();
-        std::string word;
-        std::vector<double> durations;
-        for (int j = 0; j < maxLength; ++j) {
-          const double duration = durationDist(engine);
-          durations.push_back(duration);
-          if (runner.step(duration) != hypothesisRunner.step(duration)) {
-            return TimedWord{word, durations};
+      auto result = findCounterExamples(hypothesis, 1);
+      if (result.empty()) {
+        return std::nullopt;
+      } else {
+        return result.front();
+      }
+    }
+
+    /*!
+     * @brief Make an equivalence query returning at most maxCounterExamples counterexamples
+     *
+     * We return the counterexamples with the smallest test indices.
+     */
+    [[nodiscard]] std::vector<TimedWord> findCounterExamples(const TimedAutomaton &hypothesis,
+                                                             std::size_t maxCounterExamples) override {
+      const auto startTime = std::chrono::steady_clock::now();
+      if (maxCounterExamples == 0) {
+        return {};
+      }
+      // The found counterexamples ordered by the test indices
+      std::map<std::size_t, TimedWord> found;
+      std::mutex foundMutex;
+      // We do not need to execute the tests after this index
+      std::atomic<std::size_t> cutoff{std::numeric_limits<std::size_t>::max()};
+      std::atomic<std::size_t> nextTest{0};
+      std::atomic<std::size_t> executedTests{0};
+      const auto numTestsLimit = static_cast<std::size_t>(std::max(maxTests, 0));
+
+      const std::function<void(std::size_t)> work = [&](std::size_t) {
+        TimedAutomatonRunner runner(automaton);
+        TimedAutomatonRunner hypothesisRunner(hypothesis);
+        for (std::size_t testIndex = nextTest++; testIndex < numTestsLimit && testIndex < cutoff;
+             testIndex = nextTest++) {
+          if (isCancelled()) {
+            break;
           }
-          const auto wordIndex = actionDist(engine);
-          word.push_back(alphabet.at(wordIndex));
-          if (runner.step(alphabet.at(wordIndex)) != hypothesisRunner.step(alphabet.at(wordIndex))) {
-            durations.push_back(0);
-            return TimedWord{word, durations};
+          ++executedTests;
+          auto cex = test(testIndex, runner, hypothesisRunner);
+          if (cex) {
+            std::lock_guard<std::mutex> lock{foundMutex};
+            found.emplace(testIndex, std::move(*cex));
+            if (found.size() > maxCounterExamples) {
+              found.erase(std::prev(found.end()));
+            }
+            if (found.size() == maxCounterExamples) {
+              cutoff = found.rbegin()->first;
+            }
           }
         }
-        const double duration = durationDist(engine);
-        durations.push_back(duration);
-        if (runner.step(duration) != hypothesisRunner.step(duration)) {
-          return TimedWord{word, durations};
-        }
+      };
+      if (threadPool) {
+        threadPool->parallelFor(threadPool->size(), work);
+      } else {
+        work(0);
+      }
 
-        runner.post();
-        hypothesisRunner.post();
+      ++eqQueryCount;
+      numTests += executedTests;
+      testingSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+      std::vector<TimedWord> result;
+      result.reserve(found.size());
+      for (auto &[testIndex, cex]: found) {
+        result.push_back(std::move(cex));
       }
 
-      return std::nullopt;
+      return result;
+    }
+
+    //! @brief Print the statistics including the throughput of the random tests
+    std::ostream &printStatistics(std::ostream &stream) const override {
+      EquivalenceOracle::printStatistics(stream);
+      stream << "Number of random tests: " << numTests << "\n";
+      stream << "Throughput of random tests: " << (testingSeconds > 0 ? numTests / testingSeconds : 0)
+             << " [words/s]\n";
+
+      return stream;
     }
   };
-}
\ No newline at end of file
+}
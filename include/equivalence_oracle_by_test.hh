@@ -5,63 +5,199 @@
 
 #pragma once
 
+#include <algorithm>
 #include <optional>
 #include <utility>
+#include <variant>
+#include <vector>
 
 #include "timed_automaton.hh"
 #include "timed_word.hh"
 #include "equivalence_oracle.hh"
 #include "timed_automaton_runner.hh"
+#include "logging.hh"
 
 namespace learnta {
   /*!
-   * @brief Interface of the equivalence oracle
+   * @brief Equivalence oracle by the given test words
+   *
+   * The test words are kept in a trie whose edges are the durations and the actions, i.e., the steps of the runners.
+   * Since the output of the target never changes, we execute the target only once when we add a word and keep its
+   * output after each step in the trie. In each query, we only execute the hypothesis by a depth-first traversal of
+   * the trie, taking a snapshot of the runner at the branching nodes. Thus, the shared prefixes are executed once.
+   *
+   * The counterexamples are the same as the ones when we test the words one by one in the order of the addition: the
+   * shortest prefix witnessing the difference of the first such word.
    */
   class EquivalenceOracleByTest : public EquivalenceOracle {
+    //! @brief A node of the trie of the test words
+    struct Node {
+      //! @brief The step from the parent, which is either a duration or an action
+      std::variant<double, Alphabet> step;
+      std::size_t parent;
+      //! @brief The smallest index of the test words including this node
+      std::size_t firstWord;
+      //! @brief The output of the target after the step
+      bool targetOutput;
+      //! @brief The children ordered by firstWord
+      std::vector<std::size_t> children;
+    };
     std::vector<TimedWord> words;
     TimedAutomaton automaton;
+    // The root is trie.front(), representing the empty word
+    std::vector<Node> trie;
+
+    //! @brief Add a word to the trie and execute the target only once for it
+    void insert(const TimedWord &word) {
+      const std::size_t wordIndex = words.size();
+      TimedAutomatonRunner runner{automaton};
+      runner.pre();
+      std::size_t current = 0;
+      const auto descend = [&](std::variant<double, Alphabet> step) {
+        const bool output = std::visit([&](auto value) {
+          return runner.step(value);
+        }, step);
+        const auto &children = trie.at(current).children;
+        auto it = std::find_if(children.begin(), children.end(), [&](std::size_t child) {
+          return trie.at(child).step == step;
+        });
+        if (it != children.end()) {
+          current = *it;
+        } else {
+          trie.push_back(Node{step, current, wordIndex, output, {}});
+          trie.at(current).children.push_back(trie.size() - 1);
+          current = trie.size() - 1;
+        }
+      };
+      for (std::size_t i = 0; i < word.wordSize(); ++i) {
+        descend(word.getDurations().at(i));
+        descend(word.getWord().at(i));
+      }
+      descend(word.getDurations().at(word.wordSize()));
+      runner.post();
+    }
+
+    //! @brief The timed word represented by the given node
+    [[nodiscard]] TimedWord wordOf(std::size_t node) const {
+      std::vector<std::variant<double, Alphabet>> steps;
+      for (; node != 0; node = trie.at(node).parent) {
+        steps.push_back(trie.at(node).step);
+      }
+      Word word;
+      std::vector<double> durations;
+      for (auto it = steps.rbegin(); it != steps.rend(); ++it) {
+        if (std::holds_alternative<double>(*it)) {
+          durations.push_back(std::get<double>(*it));
+        } else {
+          word.push_back(std::get<Alphabet>(*it));
+        }
+      }
+      if (durations.size() == word.size()) {
+        // The difference is witnessed just after an action
+        durations.push_back(0);
+      }
+
+      return TimedWord{word, durations};
+    }
+
+    /*!
+     * @brief Traverse the subtrie from the given node to find the nodes witnessing the difference
+     *
+     * @param [in,out] found The pairs of the firstWord and the index of the nodes witnessing the difference. This
+     * contains at most maxCounterExamples pairs with the smallest firstWord. We do not explore the descendants of
+     * these nodes because they do not give the shortest witnesses.
+     * @pre The runner is at the configuration after the given node
+     */
+    void explore(std::size_t node, TimedAutomatonRunner &hypothesisRunner,
+                 std::vector<std::pair<std::size_t, std::size_t>> &found, std::size_t maxCounterExamples) const {
+      const auto &children = trie.at(node).children;
+      std::optional<TimedAutomatonRunner::Snapshot> snapshot;
+      if (children.size() > 1) {
+        snapshot = hypothesisRunner.snapshot();
+      }
+      for (std::size_t i = 0; i < children.size(); ++i) {
+        const Node &child = trie.at(children.at(i));
+        if (isCancelled() || (found.size() >= maxCounterExamples && child.firstWord >= found.back().first)) {
+          // Since the children are ordered by firstWord, the remaining ones do not give better counterexamples
+          break;
+        }
+        if (i > 0) {
+          hypothesisRunner.restore(*snapshot);
+        }
+        const bool output = std::visit([&](auto value) {
+          return hypothesisRunner.step(value);
+        }, child.step);
+        if (output != child.targetOutput) {
+          found.insert(std::upper_bound(found.begin(), found.end(), std::make_pair(child.firstWord, children.at(i))),
+                       std::make_pair(child.firstWord, children.at(i)));
+          if (found.size() > maxCounterExamples) {
+            found.pop_back();
+          }
+        } else {
+          explore(children.at(i), hypothesisRunner, found, maxCounterExamples);
+        }
+      }
+    }
+
   public:
-    explicit EquivalenceOracleByTest(TimedAutomaton automaton) : automaton(std::move(automaton)) {}
+    explicit EquivalenceOracleByTest(TimedAutomaton automaton) : automaton(std::move(automaton)),
+                                                                 trie({Node{0.0, 0, 0, false, {}}}) {}
 
     /*!
      * @brief Make an equivalence query
      */
     [[nodiscard]] std::optional<TimedWord> findCounterExample(const TimedAutomaton &hypothesis) override {
+      auto result = findCounterExamples(hypothesis, 1);
+      if (result.empty()) {
+        return std::nullopt;
+      } else {
+        return result.front();
+      }
+    }
+
+    /*!
+     * @brief Make an equivalence query returning at most maxCounterExamples distinct counterexamples
+     */
+    [[nodiscard]] std::vector<TimedWord> findCounterExamples(const TimedAutomaton &hypothesis,
+                                                             std::size_t maxCounterExamples) override {
       ++eqQueryCount;
-      TimedAutomatonRunner runner(automaton);
-      TimedAutomatonRunner hypothesisRunner(hypothesis);
-      for (const auto &word: words) {
-        runner.pre();
+      std::vector<std::pair<std::size_t, std::size_t>> found;
+      if (maxCounterExamples > 0) {
+        TimedAutomatonRunner hypothesisRunner(hypothesis);
         hypothesisRunner.pre();
-        for (std::size_t i = 0; i < word.wordSize(); ++i) {
-          if (runner.step(word.getDurations().at(i)) != hypothesisRunner.step(word.getDurations().at(i))) {
-            // Minimize the counter example
-            auto cex = TimedWord{word.getWord().substr(0, i),
-                                 std::vector<double>{word.getDurations().begin(), word.getDurations().begin() + i + 1}};
-            BOOST_LOG_TRIVIAL(debug) << "EquivalenceOracleByTest found a counter example: " << cex;
-            return cex;
-          }
-          if (runner.step(word.getWord().at(i)) != hypothesisRunner.step(word.getWord().at(i))) {
-            // Minimize the counter example
-            auto durations = std::vector<double>{word.getDurations().begin(), word.getDurations().begin() + i + 1};
-            durations.push_back(0);
-            auto cex = TimedWord{word.getWord().substr(0, i + 1), durations};
-            BOOST_LOG_TRIVIAL(debug) << "EquivalenceOracleByTest found a counter example: " << cex;
-            return cex;
-          }
-        }
-        if (runner.step(word.getDurations().at(word.wordSize())) !=
-            hypothesisRunner.step(word.getDurations().at(word.wordSize()))) {
-          BOOST_LOG_TRIVIAL(debug) << "EquivalenceOracleByTest found a counter example: " << word;
-          return word;
-        }
+        explore(0, hypothesisRunner, found, maxCounterExamples);
+        hypothesisRunner.post();
+      }
+      std::vector<TimedWord> result;
+      result.reserve(found.size());
+      for (const auto &[firstWord, node]: found) {
+        result.push_back(wordOf(node));
+        LEARNTA_LOG(debug) << "EquivalenceOracleByTest found a counter example: " << result.back();
       }
 
-      return std::nullopt;
+      return result;
     }
 
     void push_back(TimedWord word) {
+      insert(word);
       words.push_back(std::move(word));
     }
+
+    void save(std::ostream &os) const override {
+      Serializer::writeTag(os, "EquivalenceOracleByTest");
+      Serializer::write(os, words);
+    }
+
+    void load(std::istream &is) override {
+      Serializer::readTag(is, "EquivalenceOracleByTest");
+      std::vector<TimedWord> loadedWords;
+      Serializer::read(is, loadedWords);
+      words.clear();
+      trie.resize(1);
+      trie.front().children.clear();
+      for (auto &word: loadedWords) {
+        push_back(std::move(word));
+      }
+    }
   };
 }
\ No newline at end of file
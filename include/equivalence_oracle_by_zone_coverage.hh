@@ -0,0 +1,366 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/06.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_set.hpp>
+
+#include "timed_automaton.hh"
+#include "timed_word.hh"
+#include "zone_automaton.hh"
+#include "ta2za.hh"
+#include "equivalence_oracle.hh"
+#include "split_mix64.hh"
+#include "timed_automaton_runner.hh"
+
+namespace learnta {
+  /*!
+   * @brief The equivalence oracle by tests covering the zone graph of the target
+   *
+   * We construct the zone graph of the target DTA once and generate the following covering tests.
+   * - For each reachable symbolic state, a timed word reaching it, reconstructed from a shortest symbolic run.
+   * - For each edge from such a state and each constraint \f$x \bowtie c\f$ in its guard, the timed words taking the
+   *   edge when \f$x\f$ is \f$c\f$, \f$c - 0.5\f$, and \f$c + 0.5\f$, i.e., on the boundary and in the open regions just
+   *   inside and just outside the guard.
+   *
+   * In each query, we first execute the covering tests. Then, we extend them by random suffixes of increasing length,
+   * where the delays are again chosen on and around the guard boundaries from the current configuration of the target.
+   * We track the coverage of the pairs of the states of the target and the hypothesis with the region of the clock
+   * valuation of the target, and we stop when a round of extensions adds no new pair.
+   *
+   * @note The tests only depend on the seed, the target, and the hypothesis.
+   */
+  class EquivalenceOracleByZoneCoverage : public EquivalenceOracle {
+  private:
+    using CoverageItem = std::tuple<const TAState *, const TAState *, std::vector<int>>;
+    const std::vector<Alphabet> alphabet;
+    const TimedAutomaton automaton;
+    const int maxTests;
+    const int maxSuffixLength;
+    const std::uint64_t seed;
+    // The largest constant in the guards of the target
+    int maxConstant = 0;
+    std::vector<TimedWord> coveringTests;
+    // Statistics
+    std::size_t numSymbolicStates = 0;
+    std::size_t numCoveredSymbolicStates = 0;
+    std::size_t numBoundaries = 0;
+    std::size_t numCoveredBoundaries = 0;
+    std::size_t numTests = 0;
+    std::size_t numRounds = 0;
+
+    //! @brief The random stream of the given extension
+    [[nodiscard]] SplitMix64 stream(std::size_t round, std::size_t testIndex) const {
+      SplitMix64 mixer{seed};
+      SplitMix64 queryMixer{mixer() ^ static_cast<std::uint64_t>(eqQueryCount)};
+      SplitMix64 roundMixer{queryMixer() ^ static_cast<std::uint64_t>(round)};
+      return SplitMix64{roundMixer() ^ static_cast<std::uint64_t>(testIndex)};
+    }
+
+    //! @brief The offsets from the constant of a guard to be on, just inside, and just outside its boundary
+    static constexpr std::array<double, 3> boundaryOffsets = {0.0, -0.5, 0.5};
+
+    //! @brief If the value is in the region of c + offset for the constant c of the constraint
+    static bool inBoundaryRegion(const Constraint &constraint, double offset, double value) {
+      if (offset == 0) {
+        return value == constraint.c;
+      } else if (offset < 0) {
+        return constraint.c - 1 < value && value < constraint.c;
+      } else {
+        return constraint.c < value && value < constraint.c + 1;
+      }
+    }
+
+    //! @brief The delays making x in the given constraint on and around its boundary
+    static void boundaryDelays(const Constraint &constraint, const std::vector<double> &valuation,
+                               std::vector<std::optional<double>> &delays) {
+      for (const double offset: boundaryOffsets) {
+        const double delay = constraint.c + offset - valuation.at(constraint.x);
+        delays.push_back(delay >= 0 ? std::optional<double>{delay} : std::nullopt);
+      }
+    }
+
+    //! @brief A delay on or around a guard boundary from the current configuration of the target
+    double chooseDelay(const TimedAutomatonRunner &runner, SplitMix64 &engine) const {
+      std::vector<std::optional<double>> delays;
+      if (const TAState *state = runner.getState()) {
+        // We follow the order of the alphabet rather than of the unordered map for a reproducible choice
+        const auto addDelays = [&](Alphabet action) {
+          const auto it = state->next.find(action);
+          if (it == state->next.end()) {
+            return;
+          }
+          for (const auto &transition: it->second) {
+            for (const auto &constraint: transition.guard) {
+              boundaryDelays(constraint, runner.getClockValuation(), delays);
+            }
+          }
+        };
+        addDelays(UNOBSERVABLE);
+        std::for_each(alphabet.begin(), alphabet.end(), addDelays);
+      }
+      delays.erase(std::remove(delays.begin(), delays.end(), std::nullopt), delays.end());
+      if (delays.empty()) {
+        return engine.uniformReal() * (maxConstant + 1);
+      }
+      return *delays.at(engine.uniformIndex(delays.size()));
+    }
+
+    //! @brief The region of the given clock valuation ignoring the order of the fractional parts
+    [[nodiscard]] std::vector<int> region(const std::vector<double> &valuation) const {
+      std::vector<int> result;
+      result.reserve(valuation.size());
+      for (const double value: valuation) {
+        if (value > maxConstant) {
+          result.push_back(2 * maxConstant + 1);
+        } else {
+          const double integral = std::floor(value);
+          result.push_back(2 * static_cast<int>(integral) + (value == integral ? 0 : 1));
+        }
+      }
+
+      return result;
+    }
+
+    //! @brief Generate the covering tests from the zone graph of the target
+    void generateCoveringTests() {
+      ZoneAutomaton zoneAutomaton;
+      ta2za(automaton, zoneAutomaton, false);
+      numSymbolicStates = zoneAutomaton.states.size();
+      boost::unordered_set<TimedWord> generated;
+      const auto addTest = [&](TimedWord word) {
+        if (generated.insert(word).second) {
+          coveringTests.push_back(std::move(word));
+        }
+      };
+      TimedAutomatonRunner runner{automaton};
+
+      // BFS over the zone graph so that each symbolic state is reached by a shortest symbolic run
+      std::vector<SymbolicRun> currentRuns;
+      std::unordered_set<std::shared_ptr<ZAState>> visited;
+      for (const auto &initialState: zoneAutomaton.initialStates) {
+        currentRuns.emplace_back(initialState);
+        visited.insert(initialState);
+      }
+      while (!currentRuns.empty()) {
+        std::vector<SymbolicRun> nextRuns;
+        for (const auto &run: currentRuns) {
+          // The word reconstruction may fail due to the state merging
+          const auto word = run.reconstructWord();
+          std::optional<TimedAutomatonRunner::Snapshot> reached;
+          if (word) {
+            ++numCoveredSymbolicStates;
+            addTest(*word);
+            runner.pre();
+            for (std::size_t i = 0; i < word->wordSize(); ++i) {
+              runner.step(word->getDurations().at(i));
+              runner.step(word->getWord().at(i));
+            }
+            reached = runner.snapshot();
+          }
+          for (const auto &[action, transitions]: run.back()->next) {
+            for (const auto &[transition, weakTarget]: transitions) {
+              const auto target = weakTarget.lock();
+              if (!target) {
+                continue;
+              }
+              if (action != UNOBSERVABLE) {
+                numBoundaries += 3 * transition.guard.size();
+              }
+              if (word && action != UNOBSERVABLE) {
+                for (const auto &constraint: transition.guard) {
+                  for (const double offset: boundaryOffsets) {
+                    const double delay = constraint.c + offset - reached->clockValuation.at(constraint.x);
+                    if (delay < 0) {
+                      continue;
+                    }
+                    auto durations = word->getDurations();
+                    durations.back() = delay;
+                    durations.push_back(0);
+                    addTest(TimedWord{word->getWord() + action, durations});
+                    // The boundary is covered only if the delay reaches it, e.g., without an unobservable reset
+                    runner.restore(*reached);
+                    runner.step(delay);
+                    if (runner.getState() &&
+                        inBoundaryRegion(constraint, offset, runner.getClockValuation().at(constraint.x))) {
+                      ++numCoveredBoundaries;
+                    }
+                  }
+                }
+              }
+              if (visited.insert(target).second) {
+                auto newRun = run;
+                newRun.push_back(transition, action, target);
+                nextRuns.push_back(std::move(newRun));
+              }
+            }
+          }
+        }
+        currentRuns = std::move(nextRuns);
+      }
+      if (coveringTests.empty()) {
+        coveringTests.emplace_back();
+      }
+    }
+
+    /*!
+     * @brief Execute the given prefix followed by a suffix of the given length
+     *
+     * @returns The counterexample if the test finds one
+     */
+    std::optional<TimedWord> test(const TimedWord &prefix, int suffixLength, SplitMix64 &engine,
+                                  TimedAutomatonRunner &runner, TimedAutomatonRunner &hypothesisRunner,
+                                  boost::unordered_set<CoverageItem> &coverage) const {
+      Word word;
+      std::vector<double> durations;
+      std::optional<TimedWord> result;
+      const auto record = [&] {
+        coverage.emplace(runner.getState(), hypothesisRunner.getState(), region(runner.getClockValuation()));
+      };
+      const auto stepDuration = [&](double duration) {
+        durations.push_back(duration);
+        if (runner.step(duration) != hypothesisRunner.step(duration)) {
+          result = TimedWord{word, durations};
+          return false;
+        }
+        record();
+        return true;
+      };
+      const auto stepAction = [&](Alphabet action) {
+        word.push_back(action);
+        if (runner.step(action) != hypothesisRunner.step(action)) {
+          durations.push_back(0);
+          result = TimedWord{word, durations};
+          return false;
+        }
+        record();
+        return true;
+      };
+      runner.pre();
+      hypothesisRunner.pre();
+      record();
+      bool consistent = true;
+      for (std::size_t i = 0; consistent && i < prefix.wordSize(); ++i) {
+        consistent = stepDuration(prefix.getDurations().at(i)) && stepAction(prefix.getWord().at(i));
+      }
+      for (int j = 0; consistent && j < suffixLength; ++j) {
+        consistent = stepDuration(chooseDelay(runner, engine)) && stepAction(alphabet.at(engine.uniformIndex(alphabet.size())));
+      }
+      if (consistent) {
+        stepDuration(suffixLength == 0 ? prefix.getDurations().back() : chooseDelay(runner, engine));
+      }
+      runner.post();
+      hypothesisRunner.post();
+
+      return result;
+    }
+
+  public:
+    /*!
+     * @param maxTests The maximum number of the tests in each query
+     * @param maxSuffixLength The maximum length of the random suffixes appended to the covering tests
+     * @param seed The seed of the random suffixes. The default is fixed so that the runs are reproducible.
+     */
+    EquivalenceOracleByZoneCoverage(std::vector<Alphabet> alphabet, TimedAutomaton automaton, const int maxTests,
+                                    const int maxSuffixLength, const std::uint64_t seed = 0) :
+            alphabet(std::move(alphabet)),
+            automaton(std::move(automaton)),
+            maxTests(maxTests),
+            maxSuffixLength(maxSuffixLength),
+            seed(seed) {
+      for (const int constant: this->automaton.maxConstraints) {
+        maxConstant = std::max(maxConstant, constant);
+      }
+      if (!this->automaton.states.empty()) {
+        generateCoveringTests();
+      }
+    }
+
+    /*!
+     * @brief Make an equivalence query
+     */
+    [[nodiscard]] std::optional<TimedWord> findCounterExample(const TimedAutomaton &hypothesis) override {
+      auto result = findCounterExamples(hypothesis, 1);
+      if (result.empty()) {
+        return std::nullopt;
+      } else {
+        return result.front();
+      }
+    }
+
+    /*!
+     * @brief Make an equivalence query returning at most maxCounterExamples counterexamples
+     */
+    [[nodiscard]] std::vector<TimedWord> findCounterExamples(const TimedAutomaton &hypothesis,
+                                                             std::size_t maxCounterExamples) override {
+      std::vector<TimedWord> result;
+      if (maxCounterExamples == 0 || automaton.states.empty() || alphabet.empty()) {
+        ++eqQueryCount;
+        return result;
+      }
+      TimedAutomatonRunner runner{automaton};
+      TimedAutomatonRunner hypothesisRunner{hypothesis};
+      boost::unordered_set<CoverageItem> coverage;
+      std::size_t executedTests = 0;
+      // Execute a test and returns if we continue the testing
+      const auto execute = [&](const TimedWord &prefix, int suffixLength, SplitMix64 engine) {
+        if (executedTests >= static_cast<std::size_t>(std::max(maxTests, 0)) || isCancelled()) {
+          return false;
+        }
+        ++executedTests;
+        auto counterExample = test(prefix, suffixLength, engine, runner, hypothesisRunner, coverage);
+        if (counterExample && std::find(result.begin(), result.end(), *counterExample) == result.end()) {
+          result.push_back(std::move(*counterExample));
+        }
+        return result.size() < maxCounterExamples;
+      };
+
+      bool running = true;
+      for (std::size_t i = 0; running && i < coveringTests.size(); ++i) {
+        running = execute(coveringTests.at(i), 0, stream(0, i));
+      }
+      for (int suffixLength = 1; running && suffixLength <= maxSuffixLength; ++suffixLength) {
+        ++numRounds;
+        const std::size_t coveredBefore = coverage.size();
+        for (std::size_t i = 0; running && i < coveringTests.size(); ++i) {
+          running = execute(coveringTests.at(i), suffixLength, stream(suffixLength, i));
+        }
+        if (coverage.size() == coveredBefore) {
+          // The coverage is saturated
+          break;
+        }
+      }
+
+      ++eqQueryCount;
+      numTests += executedTests;
+
+      return result;
+    }
+
+    //! @brief Print the statistics including the coverage of the zone graph of the target
+    std::ostream &printStatistics(std::ostream &stream) const override {
+      EquivalenceOracle::printStatistics(stream);
+      stream << "Number of zone-coverage tests: " << numTests << "\n";
+      stream << "Number of rounds of the zone-coverage tests: " << numRounds << "\n";
+      stream << "Symbolic states covered by the zone-coverage tests: "
+             << numCoveredSymbolicStates << "/" << numSymbolicStates << "\n";
+      stream << "Guard boundaries covered by the zone-coverage tests: "
+             << numCoveredBoundaries << "/" << numBoundaries << "\n";
+
+      return stream;
+    }
+  };
+}
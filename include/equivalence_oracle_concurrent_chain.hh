@@ -0,0 +1,146 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/05.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "equivalence_oracle.hh"
+
+namespace learnta {
+  /*!
+   * @brief Equivalence oracles executed in parallel, returning the first counterexample found
+   *
+   * Each oracle runs in its own thread against the same hypothesis. Once one of them finds a counterexample, we cancel
+   * the others through the flag given by EquivalenceOracle::setCancellation and wait for them. Thus, the time for an
+   * equivalence query is roughly the minimum over the oracles if there is a counterexample. While the oracles run, the
+   * calling thread polls the flag given to this chain and cancels them when it is set.
+   *
+   * @note Which counterexample is returned depends on the scheduling. The oracles must not share mutable state.
+   */
+  class EquivalenceOracleConcurrentChain : public EquivalenceOracle {
+  private:
+    std::vector<std::unique_ptr<EquivalenceOracle>> oracles;
+    // Set when one of the oracles finds a counterexample or the whole query is cancelled
+    std::atomic<bool> found{false};
+    // The number of the queries answered by each oracle
+    std::vector<std::size_t> numWins;
+
+  public:
+    /*!
+     * @brief Make an equivalence query
+     */
+    [[nodiscard]] std::optional<TimedWord> findCounterExample(const TimedAutomaton &hypothesis) override {
+      auto result = findCounterExamples(hypothesis, 1);
+      if (result.empty()) {
+        return std::nullopt;
+      } else {
+        return result.front();
+      }
+    }
+
+    /*!
+     * @brief Make an equivalence query returning the counterexamples of the first oracle finding any
+     */
+    [[nodiscard]] std::vector<TimedWord> findCounterExamples(const TimedAutomaton &hypothesis,
+                                                             std::size_t maxCounterExamples) override {
+      ++eqQueryCount;
+      found = this->isCancelled();
+      std::vector<TimedWord> result;
+      std::exception_ptr exception;
+      std::mutex resultMutex;
+      std::condition_variable finished;
+      std::size_t numRunning = oracles.size();
+      const auto runOracle = [&](const std::size_t index) {
+        std::vector<TimedWord> counterExamples;
+        std::exception_ptr oracleException;
+        try {
+          counterExamples = oracles.at(index)->findCounterExamples(hypothesis, maxCounterExamples);
+        } catch (...) {
+          oracleException = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock{resultMutex};
+        if (oracleException) {
+          if (!exception) {
+            exception = oracleException;
+          }
+          found = true;
+        } else if (!counterExamples.empty() && result.empty()) {
+          result = std::move(counterExamples);
+          ++numWins.at(index);
+          found = true;
+        }
+        --numRunning;
+        finished.notify_one();
+      };
+
+      std::vector<std::thread> threads;
+      threads.reserve(oracles.size());
+      for (std::size_t i = 0; i < oracles.size(); ++i) {
+        threads.emplace_back(runOracle, i);
+      }
+      {
+        // We forward the cancellation of the whole query to the oracles
+        std::unique_lock<std::mutex> lock{resultMutex};
+        while (!finished.wait_for(lock, std::chrono::milliseconds{1}, [&] { return numRunning == 0; })) {
+          if (this->isCancelled()) {
+            found = true;
+          }
+        }
+      }
+      for (auto &thread: threads) {
+        thread.join();
+      }
+      if (exception) {
+        std::rethrow_exception(exception);
+      }
+
+      return result;
+    }
+
+    /*!
+     * @brief Add an oracle
+     *
+     * @post The oracle is cancelled when another oracle finds a counterexample
+     */
+    void push_back(std::unique_ptr<EquivalenceOracle> &&oracle) {
+      oracle->setCancellation(&found);
+      oracles.push_back(std::move(oracle));
+      numWins.push_back(0);
+    }
+
+    std::ostream &printStatistics(std::ostream &stream) const override {
+      EquivalenceOracle::printStatistics(stream);
+      stream << "Number of counterexamples found by each concurrent oracle:";
+      for (const auto wins: numWins) {
+        stream << " " << wins;
+      }
+      stream << "\n";
+      for (const auto &oracle: oracles) {
+        oracle->printStatistics(stream);
+      }
+
+      return stream;
+    }
+
+    void save(std::ostream &os) const override {
+      for (const auto &oracle: oracles) {
+        oracle->save(os);
+      }
+    }
+
+    void load(std::istream &is) override {
+      for (const auto &oracle: oracles) {
+        oracle->load(is);
+      }
+    }
+  };
+}
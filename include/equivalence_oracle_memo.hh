@@ -40,12 +40,48 @@ namespace learnta {
       }
     }
 
+    /*!
+     * @brief Make an equivalence query returning at most maxCounterExamples counterexamples
+     */
+    [[nodiscard]] std::vector<TimedWord> findCounterExamples(const TimedAutomaton &hypothesis,
+                                                             std::size_t maxCounterExamples) override {
+      ++eqQueryCount;
+      auto result = oracleByTest.findCounterExamples(hypothesis, maxCounterExamples);
+      if (result.empty()) {
+        result = oracle->findCounterExamples(hypothesis, maxCounterExamples);
+        for (const auto &counterExample: result) {
+          oracleByTest.push_back(counterExample);
+        }
+      }
+
+      return result;
+    }
+
+    void setCancellation(const std::atomic<bool> *flag) override {
+      EquivalenceOracle::setCancellation(flag);
+      oracleByTest.setCancellation(flag);
+      oracle->setCancellation(flag);
+    }
+
     //! @brief Print the statistics
     std::ostream &printStatistics(std::ostream &stream) const override {
       stream << "Number of equivalence queries: " << this->numEqQueries() << "\n";
       stream << "Number of equivalence queries (with cache): " << this->oracle->numEqQueries() << "\n";
+      this->oracle->printStatistics(stream);
 
       return stream;
     }
+
+    //! @brief Write the memorized counterexamples to a checkpoint
+    void save(std::ostream &os) const override {
+      oracleByTest.save(os);
+      oracle->save(os);
+    }
+
+    //! @brief Restore the memorized counterexamples from a checkpoint
+    void load(std::istream &is) override {
+      oracleByTest.load(is);
+      oracle->load(is);
+    }
   };
 }
\ No newline at end of file
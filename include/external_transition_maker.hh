@@ -17,6 +17,7 @@
 #include "timed_automaton.hh"
 #include "renaming_relation.hh"
 #include "timed_condition_set.hh"
+#include "logging.hh"
 
 namespace learnta {
   /*!
@@ -87,7 +88,7 @@ namespace learnta {
 
       for (const auto &[targetWithRenaming, sourceConditions]: sourceMap) {
         const auto &[target, currentRenamingRelation] = targetWithRenaming;
-        BOOST_LOG_TRIVIAL(debug) << "currentRenamingRelation: " << currentRenamingRelation;
+        LEARNTA_LOG(debug) << "currentRenamingRelation: " << currentRenamingRelation;
         const auto targetConditions = targetMap.at(targetWithRenaming);
         assert(sourceConditions.size() == targetConditions.size());
         for (std::size_t i = 0; i < sourceConditions.size(); ++i) {
@@ -105,12 +106,12 @@ namespace learnta {
                                                 [] (const auto &left, const auto &right) {
             return left.second == right.second;
           }), newRenamingRelation.end());
-          BOOST_LOG_TRIVIAL(debug) << "Constructing a transition with " << sourceCondition << " and "
+          LEARNTA_LOG(debug) << "Constructing a transition with " << sourceCondition << " and "
                                    << newRenamingRelation;
-          BOOST_LOG_TRIVIAL(debug) << "target condition: " << targetCondition;
+          LEARNTA_LOG(debug) << "target condition: " << targetCondition;
           // Generate transitions
           auto resets = newRenamingRelation.toReset(sourceCondition, targetCondition);
-          BOOST_LOG_TRIVIAL(debug) << "Resets: " << resets;
+          LEARNTA_LOG(debug) << "Resets: " << resets;
           result.emplace_back(target.get(), clean(resets), sourceCondition.toGuard());
         }
       }
@@ -136,9 +137,9 @@ namespace learnta {
           result[inactiveClock] = fabs(targetCondition.getUpperBound(inactiveClock, lastClock).first);
         }
       }
-      BOOST_LOG_TRIVIAL(debug) << "inactiveClockVariables: " << renamingRelation << ", " << targetCondition;
+      LEARNTA_LOG(debug) << "inactiveClockVariables: " << renamingRelation << ", " << targetCondition;
       for (const auto &[inactiveClock, bound]: result) {
-        BOOST_LOG_TRIVIAL(debug) << "inactiveClockVariables: " << int(inactiveClock) << ", " << bound;
+        LEARNTA_LOG(debug) << "inactiveClockVariables: " << int(inactiveClock) << ", " << bound;
       }
 
       return result;
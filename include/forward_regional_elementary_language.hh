@@ -62,7 +62,7 @@ namespace learnta {
     /*!
      * @brief Construct the discrete successor
      */
-    [[nodiscard]] ForwardRegionalElementaryLanguage successor(char action) const {
+    [[nodiscard]] ForwardRegionalElementaryLanguage successor(Alphabet action) const {
       return {{this->word + action, this->timedCondition.extendN()}, fractionalOrder.extendN()};
     }
 
@@ -153,7 +153,7 @@ namespace learnta {
 
       const std::size_t suffixWordSize = this->wordSize() - prefix.wordSize();
       // Generate the word of the suffix
-      const std::string suffixWord = this->word.substr(prefix.wordSize(), suffixWordSize);
+      const Word suffixWord = this->word.substr(prefix.wordSize(), suffixWordSize);
       auto suffixDurations = fullWord.getDurations();
       suffixDurations.erase(suffixDurations.begin(), suffixDurations.begin() + prefix.wordSize());
       suffixDurations.front() -= prefixWord.getDurations().back();
@@ -190,7 +190,7 @@ namespace learnta {
      * @pre newWord.size() + 1 == targetClockSize
      * @post There is a clock valuation corresponding to a word in this language such that its value after reset corresponds to a word in the resulting language.
      */
-    [[nodiscard]] ForwardRegionalElementaryLanguage applyResets(const std::string &newWord,
+    [[nodiscard]] ForwardRegionalElementaryLanguage applyResets(const Word &newWord,
                                                                 const TATransition::Resets &resets,
                                                                 const std::size_t targetClockSize) const {
       assert(newWord.size() + 1 == targetClockSize);
@@ -198,6 +198,10 @@ namespace learnta {
                                               this->timedCondition.applyResets(resets, targetClockSize)}.sample());
     }
 
+    [[nodiscard]] const FractionalOrder &getFractionalOrder() const {
+      return fractionalOrder;
+    }
+
     bool operator==(const ForwardRegionalElementaryLanguage &another) const {
       return this->getWord() == another.getWord() && this->getTimedCondition() == another.getTimedCondition() &&
              this->fractionalOrder == another.fractionalOrder;
@@ -184,6 +184,8 @@ namespace learnta {
       return this->size == another.size && this->order == another.order;
     }
 
+    friend class Serializer;
+
     std::ostream &print(std::ostream &os) const {
       auto it = order.begin();
       if (it->empty()) {
@@ -13,6 +13,7 @@
 #include "forward_regional_elementary_language.hh"
 #include "neighbor_conditions.hh"
 #include "timed_automaton_runner.hh"
+#include "logging.hh"
 
 namespace learnta {
   /*!
@@ -29,12 +30,12 @@ namespace learnta {
       if (neighbor.match(transition)) {
         noMatch = false;
 #ifdef DEBUG
-        BOOST_LOG_TRIVIAL(debug) << "matched! " << "guard: " << transition.guard;
+        LEARNTA_LOG(debug) << "matched! " << "guard: " << transition.guard;
 #endif
         const bool upperBounded = std::any_of(transition.guard.begin(), transition.guard.end(),
                                               std::mem_fn(&Constraint::isUpperBound));
         matchBounded = matchBounded || upperBounded;
-        BOOST_LOG_TRIVIAL(debug) << "matchBounded: " << matchBounded;
+        LEARNTA_LOG(debug) << "matchBounded: " << matchBounded;
         auto relaxedGuard = neighbor.toRelaxedGuard();
         if (!upperBounded) {
           // Remove upper bound if the matched guard has no upper bound
@@ -43,10 +44,10 @@ namespace learnta {
                                               return constraint.isUpperBound();
                                             }), relaxedGuard.end());
         }
-        BOOST_LOG_TRIVIAL(debug) << "relaxed guard: " << relaxedGuard;
+        LEARNTA_LOG(debug) << "relaxed guard: " << relaxedGuard;
         if (isWeaker(relaxedGuard, transition.guard) && !isWeaker(transition.guard, relaxedGuard)) {
 #ifdef DEBUG
-          BOOST_LOG_TRIVIAL(debug) << "Relaxed!!";
+          LEARNTA_LOG(debug) << "Relaxed!!";
 #endif
           const auto preciseClocksAfterReset = neighbor.preciseClocksAfterReset(transition);
           const auto neighborAfterTransition = neighbor.makeAfterTransition(action, transition);
@@ -75,7 +76,7 @@ namespace learnta {
               const ForwardRegionalElementaryLanguage &targetElementary) {
       // There are imprecise clocks
       if (renamingRelation.hasImpreciseClocks(targetElementary.getTimedCondition())) {
-        BOOST_LOG_TRIVIAL(debug) << "new imprecise neighbors set is added: " << jumpedState << ", "
+        LEARNTA_LOG(debug) << "new imprecise neighbors set is added: " << jumpedState << ", "
                                  << targetElementary << ", " << renamingRelation;
         impreciseNeighbors.emplace(jumpedState, NeighborConditions{targetElementary, renamingRelation.rightVariables()});
       }
@@ -87,8 +88,8 @@ namespace learnta {
     void run() {
       std::unordered_set<std::size_t> visitedImpreciseNeighborsHash;
       while (!impreciseNeighbors.empty()) {
-        BOOST_LOG_TRIVIAL(debug) << "visitedImpreciseNeighborsHash size: " << visitedImpreciseNeighborsHash.size();
-        BOOST_LOG_TRIVIAL(debug) << "impreciseNeighbors size: " << this->impreciseNeighbors.size();
+        LEARNTA_LOG(debug) << "visitedImpreciseNeighborsHash size: " << visitedImpreciseNeighborsHash.size();
+        LEARNTA_LOG(debug) << "impreciseNeighbors size: " << this->impreciseNeighbors.size();
         auto [state, neighbor] = *impreciseNeighbors.begin();
         const auto hash = boost::hash_value(*impreciseNeighbors.begin());
         impreciseNeighbors.erase(impreciseNeighbors.begin());
@@ -101,7 +102,7 @@ namespace learnta {
         bool noMatch = true;
         do {
 #ifdef DEBUG
-          BOOST_LOG_TRIVIAL(debug) << "current imprecise neighbors: " << state << ", " << neighbor;
+          LEARNTA_LOG(debug) << "current imprecise neighbors: " << state << ", " << neighbor;
 #endif
           matchBounded = false;
           // Loop over successors
@@ -111,7 +112,7 @@ namespace learnta {
             for (const auto &transition: transitions) {
               const auto result = handleOne(neighbor, action, transition, newTransitions, matchBounded, noMatch);
               if (result) {
-                BOOST_LOG_TRIVIAL(debug) << "New imprecise neighbors by recursion: " << *result;
+                LEARNTA_LOG(debug) << "New imprecise neighbors by recursion: " << *result;
                 this->impreciseNeighbors.insert(*result);
               }
             }
@@ -128,20 +129,20 @@ namespace learnta {
           neighbor.successorAssign();
         } while (matchBounded || noMatch);
       }
-      BOOST_LOG_TRIVIAL(debug) << "ImpreciseClockHandler: finished!";
+      LEARNTA_LOG(debug) << "ImpreciseClockHandler: finished!";
     }
 
 
     static TATransition::Resets embedIfImprecise(TATransition::Resets resets,
-                                                 const std::unordered_set<ClockVariables> &preciseClocks,
+                                                 const ClockSet &preciseClocks,
                                                  const std::vector<double> &embeddedValuation) {
       // Remove imprecise clocks
       resets.erase(std::remove_if(resets.begin(), resets.end(), [&](const auto &reset) {
-        return preciseClocks.find(reset.first) == preciseClocks.end();
+        return !preciseClocks.contains(reset.first);
       }), resets.end());
       // Add valuations if imprecise
       for (ClockVariables clock = 0; clock < static_cast<ClockVariables>(embeddedValuation.size()); ++clock) {
-        if (preciseClocks.find(clock) == preciseClocks.end()) {
+        if (!preciseClocks.contains(clock)) {
           resets.emplace_back(clock, embeddedValuation.at(clock));
         }
       }
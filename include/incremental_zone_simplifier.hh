@@ -0,0 +1,281 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/20.
+ * @brief The zone-based simplification of the hypotheses reusing the zone graph of the previous round
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "compiled_timed_automaton.hh"
+#include "logging.hh"
+#include "ta2za.hh"
+#include "timed_automaton.hh"
+#include "zone_automaton.hh"
+
+namespace learnta {
+  /*!
+   * @brief The zone-based simplification of the hypotheses reusing the result of the previous round
+   *
+   * A refinement of the observation table often changes only a part of the hypothesis. We reuse the previous round as
+   * follows.
+   * - If the hypothesis is not changed at all, we reuse the simplified hypothesis.
+   * - Otherwise, we identify the states of the two hypotheses by their index in TimedAutomaton::states, which follows
+   *   the rows of the observation table. A state is unchanged if its acceptance and its outgoing transitions, with the
+   *   targets as indices, are the same as the previous round. A zone constructed from an initial zone only through
+   *   the transitions of unchanged states is also the same. We reuse such zones and construct only the rest of the
+   *   zone graph by ta2zaFrom.
+   *
+   * The removal of the dead states and the pruning of the hypothesis still use the whole zone graph.
+   */
+  class IncrementalZoneSimplifier {
+  private:
+    static constexpr std::size_t noNode = std::numeric_limits<std::size_t>::max();
+
+    //! @brief A state of the zone graph, where the states, the transitions, and the nodes are referred by the indices
+    struct Node {
+      std::size_t taState;
+      Zone zone;
+      //! @brief The node whose exploration constructed this node, or noNode for an initial node
+      std::size_t parent;
+      //! @brief The action, the index of the transition in TAState::next, and the target node
+      std::vector<std::tuple<Alphabet, std::size_t, std::size_t>> edges;
+    };
+
+    // The hypothesis of the previous round before and after the simplification in the binary format of
+    // CompiledTimedAutomaton. They are empty if the format cannot represent the hypothesis.
+    std::string previousHypothesisKey;
+    std::string previousSimplifiedHypothesis;
+    // The zone graph of the previous round before the removal of the dead states
+    std::vector<std::string> previousSignatures;
+    std::vector<int> previousMaxConstraints;
+    std::vector<std::size_t> previousInitialStates;
+    std::vector<Node> previousNodes;
+
+    std::size_t numReusedHypotheses = 0;
+    std::size_t numReusedZones = 0;
+
+    //! @brief The index of each state in TimedAutomaton::states
+    static std::unordered_map<const TAState *, std::size_t> makeIndices(const TimedAutomaton &automaton) {
+      std::unordered_map<const TAState *, std::size_t> indices;
+      indices.reserve(automaton.stateSize());
+      for (std::size_t i = 0; i < automaton.stateSize(); ++i) {
+        indices[automaton.states.at(i).get()] = i;
+      }
+      return indices;
+    }
+
+    //! @brief The acceptance and the outgoing transitions of each state, where the targets are shown by the indices
+    static std::vector<std::string> makeSignatures(const TimedAutomaton &automaton,
+                                                   const std::unordered_map<const TAState *, std::size_t> &indices) {
+      std::vector<std::string> signatures;
+      signatures.reserve(automaton.stateSize());
+      for (const auto &state: automaton.states) {
+        std::ostringstream stream;
+        stream << std::hexfloat << state->isMatch;
+        std::vector<Alphabet> actions;
+        actions.reserve(state->next.size());
+        for (const auto &[action, transitions]: state->next) {
+          actions.push_back(action);
+        }
+        std::sort(actions.begin(), actions.end());
+        for (const Alphabet action: actions) {
+          stream << '|' << static_cast<int>(action);
+          for (const TATransition &transition: state->next.at(action)) {
+            auto it = indices.find(transition.target);
+            stream << ';' << (it == indices.end() ? noNode : it->second) << '[';
+            for (const Constraint &constraint: transition.guard) {
+              stream << int(constraint.x) << ',' << int(constraint.odr) << ',' << constraint.c << ' ';
+            }
+            stream << ']';
+            for (const auto &[resetVariable, targetVariable]: transition.resetVars) {
+              stream << int(resetVariable);
+              if (targetVariable.index() == 1) {
+                stream << "=x" << int(std::get<ClockVariables>(targetVariable)) << ' ';
+              } else {
+                stream << '=' << std::get<double>(targetVariable) << ' ';
+              }
+            }
+          }
+        }
+        signatures.push_back(std::move(stream).str());
+      }
+      return signatures;
+    }
+
+    /*!
+     * @brief Restore the reusable part of the previous zone graph for the given hypothesis
+     *
+     * @returns The nodes to explore again because some of their transitions may lead to a new zone
+     */
+    std::deque<std::shared_ptr<ZAState>> restore(const TimedAutomaton &hypothesis,
+                                                 const std::vector<std::string> &signatures,
+                                                 ZoneAutomaton &zoneAutomaton,
+                                                 std::vector<std::size_t> &parents) const {
+      auto unchanged = [&](std::size_t index) {
+        return index < signatures.size() && index < previousSignatures.size() &&
+               signatures.at(index) == previousSignatures.at(index);
+      };
+      // A node is reusable if all of its ancestors are at the unchanged states
+      std::vector<std::size_t> toNewNode(previousNodes.size(), noNode);
+      for (std::size_t i = 0; i < previousNodes.size(); ++i) {
+        const Node &node = previousNodes.at(i);
+        const bool reusable = node.taState < hypothesis.stateSize() &&
+                              (node.parent == noNode ||
+                               (toNewNode.at(node.parent) != noNode &&
+                                unchanged(previousNodes.at(node.parent).taState)));
+        if (reusable) {
+          toNewNode.at(i) = zoneAutomaton.states.size();
+          zoneAutomaton.states.push_back(
+                  std::make_shared<ZAState>(hypothesis.states.at(node.taState).get(), node.zone));
+          parents.push_back(node.parent == noNode ? noNode : toNewNode.at(node.parent));
+          if (node.parent == noNode) {
+            zoneAutomaton.initialStates.push_back(zoneAutomaton.states.back());
+          }
+        }
+      }
+
+      // The edges of an unchanged node are reused if all of them lead to reused nodes
+      std::deque<std::shared_ptr<ZAState>> frontier;
+      for (std::size_t i = 0; i < previousNodes.size(); ++i) {
+        if (toNewNode.at(i) == noNode) {
+          continue;
+        }
+        const Node &node = previousNodes.at(i);
+        const auto &state = zoneAutomaton.states.at(toNewNode.at(i));
+        const bool complete = unchanged(node.taState) &&
+                              std::all_of(node.edges.begin(), node.edges.end(), [&](const auto &edge) {
+                                return toNewNode.at(std::get<2>(edge)) != noNode;
+                              });
+        if (complete) {
+          for (const auto &[action, transition, target]: node.edges) {
+            state->next[action].emplace_back(state->taState->next.at(action).at(transition),
+                                             zoneAutomaton.states.at(toNewNode.at(target)));
+          }
+        } else {
+          frontier.push_back(state);
+        }
+      }
+
+      return frontier;
+    }
+
+    //! @brief Keep the zone graph before the removal of the dead states for the next round
+    void save(const TimedAutomaton &hypothesis, std::vector<std::string> signatures,
+              const std::unordered_map<const TAState *, std::size_t> &indices,
+              const ZoneAutomaton &zoneAutomaton, std::vector<std::size_t> parents) {
+      std::unordered_map<const ZAState *, std::size_t> nodeIndices;
+      nodeIndices.reserve(zoneAutomaton.stateSize());
+      for (std::size_t i = 0; i < zoneAutomaton.stateSize(); ++i) {
+        nodeIndices[zoneAutomaton.states.at(i).get()] = i;
+      }
+      // The parent of a constructed node is the first explored node with a transition to it. Since we explore the
+      // nodes in the order of ZoneAutomaton::states and a reused node never leads to a constructed one, it is the
+      // predecessor with the least index. The reused nodes come first and keep their parents.
+      const std::size_t numReused = parents.size();
+      parents.resize(zoneAutomaton.stateSize(), noNode);
+      std::vector<bool> isInitial(zoneAutomaton.stateSize(), false);
+      for (const auto &initialState: zoneAutomaton.initialStates) {
+        isInitial.at(nodeIndices.at(initialState.get())) = true;
+      }
+      std::vector<Node> nodes;
+      nodes.reserve(zoneAutomaton.stateSize());
+      for (std::size_t i = 0; i < zoneAutomaton.stateSize(); ++i) {
+        const auto &state = zoneAutomaton.states.at(i);
+        nodes.push_back(Node{indices.at(state->taState), state->zone, noNode, {}});
+        for (const auto &[action, edges]: state->next) {
+          const auto &transitions = state->taState->next.at(action);
+          for (const auto &[transition, target]: edges) {
+            const std::size_t targetIndex = nodeIndices.at(target.lock().get());
+            const auto position = std::find(transitions.begin(), transitions.end(), transition);
+            nodes.back().edges.emplace_back(action, position - transitions.begin(), targetIndex);
+            if (targetIndex >= numReused && i < targetIndex && !isInitial.at(targetIndex) &&
+                parents.at(targetIndex) == noNode) {
+              parents.at(targetIndex) = i;
+            }
+          }
+        }
+      }
+      for (std::size_t i = 0; i < nodes.size(); ++i) {
+        nodes.at(i).parent = parents.at(i);
+      }
+      previousSignatures = std::move(signatures);
+      previousMaxConstraints = hypothesis.maxConstraints;
+      previousInitialStates.clear();
+      for (const auto &initialState: hypothesis.initialStates) {
+        previousInitialStates.push_back(indices.at(initialState.get()));
+      }
+      previousNodes = std::move(nodes);
+    }
+
+  public:
+    /*!
+     * @brief Apply the zone-based simplification to the hypothesis
+     *
+     * The result is the same as TimedAutomaton::simplifyWithZones.
+     */
+    void simplify(TimedAutomaton &hypothesis) {
+      // The key is empty if the hypothesis is not in the binary format. Then, we do not use the memo.
+      const auto toBytes = [](const TimedAutomaton &automaton) {
+        std::ostringstream stream;
+        try {
+          CompiledTimedAutomaton::write(stream, automaton);
+        } catch (const std::invalid_argument &) {
+          return std::string{};
+        }
+        return stream.str();
+      };
+      auto key = toBytes(hypothesis);
+      if (!key.empty() && key == previousHypothesisKey) {
+        LEARNTA_LOG(debug) << "The hypothesis is not changed. We reuse the zone-based simplification";
+        ++numReusedHypotheses;
+        hypothesis = CompiledTimedAutomaton::fromBytes(previousSimplifiedHypothesis).toTimedAutomaton();
+        return;
+      }
+
+      const auto indices = makeIndices(hypothesis);
+      auto signatures = makeSignatures(hypothesis, indices);
+      std::vector<std::size_t> initialStates;
+      for (const auto &initialState: hypothesis.initialStates) {
+        initialStates.push_back(indices.at(initialState.get()));
+      }
+      ZoneAutomaton zoneAutomaton;
+      std::vector<std::size_t> parents;
+      if (initialStates == previousInitialStates && hypothesis.maxConstraints == previousMaxConstraints &&
+          !previousNodes.empty()) {
+        auto frontier = restore(hypothesis, signatures, zoneAutomaton, parents);
+        LEARNTA_LOG(debug) << "Reuse " << zoneAutomaton.stateSize() << " zones of the previous hypothesis";
+        numReusedZones += zoneAutomaton.stateSize();
+        ta2zaFrom(zoneAutomaton, std::move(frontier));
+      } else {
+        ta2za(hypothesis, zoneAutomaton, false);
+      }
+      save(hypothesis, std::move(signatures), indices, zoneAutomaton, std::move(parents));
+      hypothesis.simplifyWithZones(zoneAutomaton);
+
+      previousSimplifiedHypothesis = toBytes(hypothesis);
+      previousHypothesisKey = previousSimplifiedHypothesis.empty() ? std::string{} : std::move(key);
+    }
+
+    //! @brief The number of the hypotheses reusing the whole simplified hypothesis of the previous round
+    [[nodiscard]] std::size_t getNumReusedHypotheses() const {
+      return numReusedHypotheses;
+    }
+
+    //! @brief The total number of the zones reused from the zone graph of the previous round
+    [[nodiscard]] std::size_t getNumReusedZones() const {
+      return numReusedZones;
+    }
+  };
+}
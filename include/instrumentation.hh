@@ -0,0 +1,244 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/10.
+ * @brief Scoped timers, counters, and histograms to profile the learning
+ *
+ * The instrumentation is enabled only if LEARNTA_INSTRUMENTATION is defined, e.g., by the CMake option of the same
+ * name. Otherwise, the macros below expand to no-ops and their arguments are not evaluated.
+ *
+ * - LEARNTA_SCOPED_TIMER(name) measures the time until the end of the current scope
+ * - LEARNTA_COUNT(name, value) adds value to a counter
+ * - LEARNTA_RECORD(name, value) records a non-negative integer to a histogram
+ *
+ * The name must be a string literal. Each macro looks up its entry only once and then updates it with atomic
+ * operations. Therefore, they are safe to use in the worker threads.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#ifdef LEARNTA_INSTRUMENTATION
+#define LEARNTA_INSTRUMENTATION_CONCAT_(left, right) left##right
+#define LEARNTA_INSTRUMENTATION_CONCAT(left, right) LEARNTA_INSTRUMENTATION_CONCAT_(left, right)
+#define LEARNTA_SCOPED_TIMER(name) \
+  static auto &LEARNTA_INSTRUMENTATION_CONCAT(learntaTimer, __LINE__) = ::learnta::Instrumentation::global().timer(name); \
+  const ::learnta::Instrumentation::ScopedTimer LEARNTA_INSTRUMENTATION_CONCAT(learntaScopedTimer, __LINE__) {LEARNTA_INSTRUMENTATION_CONCAT(learntaTimer, __LINE__)}
+#define LEARNTA_COUNT(name, value) do { \
+  static auto &learntaCounter = ::learnta::Instrumentation::global().counter(name); \
+  learntaCounter.fetch_add(static_cast<std::uint64_t>(value), std::memory_order_relaxed); \
+} while (false)
+#define LEARNTA_RECORD(name, value) do { \
+  static auto &learntaHistogram = ::learnta::Instrumentation::global().histogram(name); \
+  learntaHistogram.record(static_cast<std::uint64_t>(value)); \
+} while (false)
+#else
+#define LEARNTA_SCOPED_TIMER(name) static_cast<void>(0)
+#define LEARNTA_COUNT(name, value) static_cast<void>(0)
+#define LEARNTA_RECORD(name, value) static_cast<void>(0)
+#endif
+
+namespace learnta {
+  /*!
+   * @brief The registry of the timers, counters, and histograms
+   *
+   * The entries are never removed once they are registered, so that the references cached by the macros remain valid.
+   * The values are accumulated over the process until reset is called.
+   */
+  class Instrumentation {
+  public:
+#ifdef LEARNTA_INSTRUMENTATION
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    //! @brief The accumulated time of a scope
+    struct Timer {
+      std::atomic<std::uint64_t> count{0};
+      std::atomic<std::uint64_t> nanoseconds{0};
+
+      //! @brief Add one execution of the given duration
+      void add(std::chrono::nanoseconds duration) {
+        count.fetch_add(1, std::memory_order_relaxed);
+        nanoseconds.fetch_add(static_cast<std::uint64_t>(duration.count()), std::memory_order_relaxed);
+      }
+    };
+
+    //! @brief Add the time until the destruction to the timer
+    class ScopedTimer {
+      Timer &timer;
+      const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    public:
+      explicit ScopedTimer(Timer &timer) : timer(timer) {}
+
+      ScopedTimer(const ScopedTimer &) = delete;
+
+      ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+      ~ScopedTimer() {
+        timer.add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime));
+      }
+    };
+
+    using Counter = std::atomic<std::uint64_t>;
+
+    /*!
+     * @brief The distribution of non-negative integers
+     *
+     * The i-th bucket counts the values v such that \f$2^{i-1} \leq v < 2^i\f$. The 0-th bucket counts 0.
+     */
+    class Histogram {
+      std::array<std::atomic<std::uint64_t>, 65> buckets{};
+      std::atomic<std::uint64_t> count{0};
+      std::atomic<std::uint64_t> sum{0};
+      std::atomic<std::uint64_t> max{0};
+
+      friend class Instrumentation;
+    public:
+      void record(std::uint64_t value) {
+        std::size_t bucket = 0;
+        while (bucket < 64 && (value >> bucket) != 0) {
+          ++bucket;
+        }
+        buckets.at(bucket).fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+        auto currentMax = max.load(std::memory_order_relaxed);
+        while (currentMax < value && !max.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {}
+      }
+    };
+
+    //! @brief The values of all the entries at some point
+    struct Snapshot {
+      struct TimerValue {
+        std::uint64_t count;
+        double seconds;
+      };
+      struct HistogramValue {
+        std::uint64_t count;
+        std::uint64_t sum;
+        std::uint64_t max;
+        // The exclusive upper bound of each non-empty bucket and the number of the values in it
+        std::map<std::uint64_t, std::uint64_t> buckets;
+      };
+      std::map<std::string, TimerValue> timers;
+      std::map<std::string, std::uint64_t> counters;
+      std::map<std::string, HistogramValue> histograms;
+
+      //! @brief Print the snapshot as a JSON object in a single line
+      std::ostream &printJson(std::ostream &stream) const {
+        stream << "{\"timers\":{";
+        bool first = true;
+        for (const auto &[name, value]: timers) {
+          stream << (first ? "" : ",") << "\"" << name << "\":{\"count\":" << value.count
+                 << ",\"seconds\":" << value.seconds << "}";
+          first = false;
+        }
+        stream << "},\"counters\":{";
+        first = true;
+        for (const auto &[name, value]: counters) {
+          stream << (first ? "" : ",") << "\"" << name << "\":" << value;
+          first = false;
+        }
+        stream << "},\"histograms\":{";
+        first = true;
+        for (const auto &[name, value]: histograms) {
+          stream << (first ? "" : ",") << "\"" << name << "\":{\"count\":" << value.count << ",\"sum\":" << value.sum
+                 << ",\"max\":" << value.max << ",\"buckets\":{";
+          bool firstBucket = true;
+          for (const auto &[upperBound, bucketCount]: value.buckets) {
+            stream << (firstBucket ? "" : ",") << "\"<" << upperBound << "\":" << bucketCount;
+            firstBucket = false;
+          }
+          stream << "}}";
+          first = false;
+        }
+        return stream << "}}";
+      }
+    };
+
+    //! @brief The registry shared by the whole process
+    static Instrumentation &global() {
+      static Instrumentation instance;
+      return instance;
+    }
+
+    //! @brief The timer of the given name. It is registered if it does not exist.
+    Timer &timer(const std::string &name) {
+      std::lock_guard<std::mutex> lock{mutex};
+      return timers[name];
+    }
+
+    //! @brief The counter of the given name. It is registered if it does not exist.
+    Counter &counter(const std::string &name) {
+      std::lock_guard<std::mutex> lock{mutex};
+      return counters[name];
+    }
+
+    //! @brief The histogram of the given name. It is registered if it does not exist.
+    Histogram &histogram(const std::string &name) {
+      std::lock_guard<std::mutex> lock{mutex};
+      return histograms[name];
+    }
+
+    //! @brief Take the current values of all the entries
+    [[nodiscard]] Snapshot snapshot() const {
+      std::lock_guard<std::mutex> lock{mutex};
+      Snapshot result;
+      for (const auto &[name, value]: timers) {
+        result.timers[name] = {value.count.load(), value.nanoseconds.load() / 1e9};
+      }
+      for (const auto &[name, value]: counters) {
+        result.counters[name] = value.load();
+      }
+      for (const auto &[name, value]: histograms) {
+        auto &histogramValue = result.histograms[name];
+        histogramValue = {value.count.load(), value.sum.load(), value.max.load(), {}};
+        for (std::size_t i = 0; i < value.buckets.size(); ++i) {
+          if (const auto bucketCount = value.buckets.at(i).load(); bucketCount > 0) {
+            // The upper bound of the last bucket does not fit in 64 bits. We saturate it.
+            histogramValue.buckets[i < 64 ? std::uint64_t{1} << i : UINT64_MAX] = bucketCount;
+          }
+        }
+      }
+      return result;
+    }
+
+    //! @brief Set all the values to zero. The registered entries remain valid.
+    void reset() {
+      std::lock_guard<std::mutex> lock{mutex};
+      for (auto &[name, value]: timers) {
+        value.count = 0;
+        value.nanoseconds = 0;
+      }
+      for (auto &[name, value]: counters) {
+        value = 0;
+      }
+      for (auto &[name, value]: histograms) {
+        for (auto &bucket: value.buckets) {
+          bucket = 0;
+        }
+        value.count = 0;
+        value.sum = 0;
+        value.max = 0;
+      }
+    }
+
+  private:
+    Instrumentation() = default;
+
+    mutable std::mutex mutex;
+    // We use std::map because its references are not invalidated by insertion
+    std::map<std::string, Timer> timers;
+    std::map<std::string, Counter> counters;
+    std::map<std::string, Histogram> histograms;
+  };
+}
@@ -16,6 +16,7 @@
 #include "timed_automaton.hh"
 #include "renaming_relation.hh"
 #include "timed_condition_set.hh"
+#include "logging.hh"
 
 namespace learnta {
   /*!
@@ -34,7 +35,7 @@ namespace learnta {
      *     - \f$\Lambda\f$ is sourceCondition.
      */
     void add(const std::shared_ptr<TAState> &targetState, const TimedCondition &sourceCondition) {
-      BOOST_LOG_TRIVIAL(trace) << "sourceCondition: " << sourceCondition;
+      LEARNTA_LOG(trace) << "sourceCondition: " << sourceCondition;
 
       auto it = sourceMap.find(targetState);
       if (it == sourceMap.end()) {
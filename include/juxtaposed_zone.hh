@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <mutex>
+#include <shared_mutex>
+
 #include "zone.hh"
 
 namespace learnta {
@@ -28,11 +31,15 @@ namespace learnta {
             leftSize(static_cast<Eigen::Index>(left.getNumOfVar())),
             rightSize(static_cast<Eigen::Index>(right.getNumOfVar())) {
       static boost::unordered_map<std::pair<Zone, Zone>, Eigen::Matrix<Bounds, Eigen::Dynamic, Eigen::Dynamic>> memo;
+      // The memo is shared by the threads filling the observation table
+      static std::shared_mutex memoMutex;
       const auto key = std::make_pair(left, right);
+      std::shared_lock<std::shared_mutex> readLock{memoMutex};
       auto it = memo.find(key);
       if (it != memo.end()) {
         this->value = it->second;
       } else {
+        readLock.unlock();
         this->value.resize(leftSize + rightSize + 1, leftSize + rightSize + 1);
         this->value.fill(Bounds(std::numeric_limits<double>::max(), false));
         // Copy the constraints in left
@@ -46,6 +53,7 @@ namespace learnta {
                 right.value.block(1, 0, right.value.cols() - 1, 1);
 
         this->canonize();
+        std::lock_guard<std::shared_mutex> writeLock{memoMutex};
         memo[key] = this->value;
       }
     }
@@ -63,11 +71,14 @@ namespace learnta {
             leftSize(static_cast<Eigen::Index>(left.getNumOfVar())),
             rightSize(static_cast<Eigen::Index>(right.getNumOfVar())) {
       static boost::unordered_map<std::tuple<Zone, Zone, Eigen::Index>, Eigen::Matrix<Bounds, Eigen::Dynamic, Eigen::Dynamic>> memoWithCommon;
+      static std::shared_mutex memoWithCommonMutex;
       const auto key = std::make_tuple(left, right, commonVariableSize);
+      std::shared_lock<std::shared_mutex> readLock{memoWithCommonMutex};
       auto it = memoWithCommon.find(key);
       if (it != memoWithCommon.end()) {
         this->value = it->second;
       } else {
+        readLock.unlock();
         const auto M = leftSize;
         const auto N = rightSize;
         const auto L = commonVariableSize;
@@ -112,6 +123,7 @@ namespace learnta {
         }
 
         this->canonize();
+        std::lock_guard<std::shared_mutex> writeLock{memoWithCommonMutex};
         memoWithCommon[key] = this->value;
       }
     }
@@ -5,11 +5,24 @@
 
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "equivalence_oracle.hh"
+#include "incremental_zone_simplifier.hh"
+#include "instrumentation.hh"
+#include "learner_observer.hh"
 #include "symbolic_membership_oracle.hh"
 #include "observation_table.hh"
+#include "logging.hh"
 
 namespace learnta {
   /*!
@@ -19,44 +32,337 @@ namespace learnta {
   private:
     std::unique_ptr<EquivalenceOracle> eqOracle;
     ObservationTable observationTable;
+    // The path to write the checkpoints. If it is empty, we do not write checkpoints.
+    std::string checkpointPath;
+    // We write a checkpoint once in checkpointInterval equivalence queries
+    std::size_t checkpointInterval = 1;
+    std::size_t numIterations = 0;
+    // The maximum number of the counterexamples handled in one refinement
+    std::size_t maxCounterExamples = 1;
+    // The zone-based simplification reusing the hypothesis and the zone graph of the previous round
+    IncrementalZoneSimplifier zoneSimplifier;
+    /*
+     * The time spent in each phase of the learning in seconds. They are always measured because printStatistics and
+     * the events of the observers report them. With LEARNTA_INSTRUMENTATION, measure also adds each phase to the timer
+     * of Instrumentation named in run, so that the phases are timed only once.
+     */
+    struct PhaseTimes {
+      double table = 0;
+      double hypothesis = 0;
+      double zones = 0;
+      double equivalence = 0;
+      double counterExample = 0;
+    } phaseTimes;
+    // The instrumentation after each equivalence query. This is empty unless LEARNTA_INSTRUMENTATION is defined.
+    std::vector<Instrumentation::Snapshot> iterationStatistics;
+    std::ofstream instrumentationStream;
+    // The observers of the learning loop
+    std::vector<std::shared_ptr<LearnerObserver>> observers;
+    // The number of the hypotheses constructed in run
+    std::size_t iteration = 0;
+    std::chrono::steady_clock::time_point runStartTime;
+
+    //! @brief Make an event filled with the current status of the observation table
+    [[nodiscard]] LearnerEvent makeEvent(LearnerEvent::Kind kind, double duration) const {
+      LearnerEvent event{};
+      event.kind = kind;
+      event.iteration = iteration;
+      event.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStartTime).count();
+      event.duration = duration;
+      event.numP = observationTable.numP();
+      event.numPrefixes = observationTable.numPrefixes();
+      event.numSuffixes = observationTable.numSuffixes();
+      event.numMembershipQueries = observationTable.numMembershipQueries();
+      return event;
+    }
+
+    void notify(const LearnerEvent &event) {
+      for (const auto &observer: observers) {
+        observer->notify(event);
+      }
+    }
+
+    //! @brief Record the instrumentation after an equivalence query
+    void recordIteration() {
+      if constexpr (Instrumentation::enabled) {
+        iterationStatistics.push_back(Instrumentation::global().snapshot());
+        if (instrumentationStream.is_open()) {
+          instrumentationStream << "{\"iteration\":" << iterationStatistics.size() << ",\"statistics\":";
+          iterationStatistics.back().printJson(instrumentationStream) << "}" << std::endl;
+        }
+      }
+    }
+
+    //! @brief Flush the file or the directory at the path to the disk
+    static bool sync(const std::string &path, int flags) {
+      const int fd = ::open(path.c_str(), flags | O_CLOEXEC);
+      if (fd < 0) {
+        return false;
+      }
+      const bool synced = ::fsync(fd) == 0;
+      ::close(fd);
+      return synced;
+    }
+
+    /*!
+     * @brief Execute the given function and add its execution time to the given phase
+     *
+     * @param timerName The name of the timer of Instrumentation for the phase. It is used only with
+     * LEARNTA_INSTRUMENTATION.
+     */
+    template<class Function>
+    static auto measure(double &phaseTime, const char *timerName, Function &&function) {
+      struct Stopwatch {
+        double &phaseTime;
+        const char *timerName;
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+        ~Stopwatch() {
+          const auto duration = std::chrono::steady_clock::now() - startTime;
+          phaseTime += std::chrono::duration<double>(duration).count();
+          if constexpr (Instrumentation::enabled) {
+            Instrumentation::global().timer(timerName).add(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(duration));
+          }
+        }
+      } stopwatch{phaseTime, timerName};
+
+      return function();
+    }
+
+    // The checkpoints with 8-bit and 16-bit actions are not compatible
+    static constexpr const char *checkpointMagic =
+            sizeof(Alphabet) == 1 ? "LearnTA checkpoint v1" : "LearnTA checkpoint v1 (16-bit actions)";
   public:
+    /*!
+     * @param numThreads The number of the threads to fill the observation table. If it is 0, we use all the hardware threads.
+     * @param lazyTable If true, the cells of the observation table are filled only when they are used
+     */
     Learner(const std::vector<Alphabet> &alphabet,
             std::unique_ptr<SymbolicMembershipOracle> memOracle,
-            std::unique_ptr<EquivalenceOracle> eqOracle) : eqOracle(std::move(eqOracle)),
-                                                           observationTable(alphabet, std::move(memOracle)) {}
+            std::unique_ptr<EquivalenceOracle> eqOracle,
+            std::size_t numThreads = 1,
+            bool lazyTable = false) : eqOracle(std::move(eqOracle)),
+                                      observationTable(alphabet, std::move(memOracle), numThreads, lazyTable) {}
 
     TimedAutomaton run() {
+      runStartTime = std::chrono::steady_clock::now();
       while (true) {
-        bool notUpdated;
-        do {
-          notUpdated = observationTable.close();
-          notUpdated = notUpdated && observationTable.consistent();
-          notUpdated = notUpdated && observationTable.exteriorConsistent();
-          notUpdated = notUpdated && observationTable.timeSaturate();
-          // notUpdated = notUpdated && observationTable.renameConsistent();
-        } while (!notUpdated);
-        BOOST_LOG_TRIVIAL(debug) << "Start DTA generation";
-        auto hypothesis = observationTable.generateHypothesis();
-        BOOST_LOG_TRIVIAL(debug) << "Hypothesis before simplification\n" << hypothesis;
-        hypothesis.simplifyStrong();
-        BOOST_LOG_TRIVIAL(debug) << "Hypothesis before zone-based simplification\n" << hypothesis;
-        hypothesis.simplifyWithZones();
+        const double tableStartTime = phaseTimes.table;
+        measure(phaseTimes.table, "learner.table", [&] {
+          bool notUpdated;
+          do {
+            notUpdated = observationTable.close();
+            notUpdated = notUpdated && observationTable.consistent();
+            notUpdated = notUpdated && observationTable.exteriorConsistent();
+            notUpdated = notUpdated && observationTable.timeSaturate();
+            // notUpdated = notUpdated && observationTable.renameConsistent();
+          } while (!notUpdated);
+        });
+        ++iteration;
+        if (!observers.empty()) {
+          notify(makeEvent(LearnerEvent::Kind::TABLE_CLOSED, phaseTimes.table - tableStartTime));
+        }
+        const double hypothesisStartTime = phaseTimes.hypothesis;
+        LEARNTA_LOG(debug) << "Start DTA generation";
+        auto hypothesis = measure(phaseTimes.hypothesis, "learner.hypothesis", [&] {
+          auto hypothesis = observationTable.generateHypothesis();
+          LEARNTA_LOG(debug) << "Hypothesis before simplification\n" << hypothesis;
+          {
+            LEARNTA_SCOPED_TIMER("learner.simplify_strong");
+            hypothesis.simplifyStrong();
+          }
+          return hypothesis;
+        });
+        LEARNTA_LOG(debug) << "Hypothesis before zone-based simplification\n" << hypothesis;
+        const double zonesStartTime = phaseTimes.zones;
+        measure(phaseTimes.zones, "learner.simplify_with_zones", [&] {
+          zoneSimplifier.simplify(hypothesis);
+        });
+        if (!observers.empty()) {
+          auto event = makeEvent(LearnerEvent::Kind::HYPOTHESIS,
+                                 phaseTimes.hypothesis - hypothesisStartTime + phaseTimes.zones - zonesStartTime);
+          event.numStates = hypothesis.stateSize();
+          for (const auto &state: hypothesis.states) {
+            for (const auto &[action, transitions]: state->next) {
+              event.numTransitions += transitions.size();
+            }
+          }
+          notify(event);
+        }
         BOOST_LOG_TRIVIAL(info) << "The learner generated a hypothesis\n" << hypothesis;
         assert(hypothesis.deterministic());
-        const auto counterExample = eqOracle->findCounterExample(hypothesis);
+        const double equivalenceStartTime = phaseTimes.equivalence;
+        const auto counterExamples = measure(phaseTimes.equivalence, "learner.find_counter_examples", [&] {
+          return eqOracle->findCounterExamples(hypothesis, maxCounterExamples);
+        });
+        this->recordIteration();
 
-        if (counterExample) {
-          BOOST_LOG_TRIVIAL(info) << "Equivalence oracle returned a counter example: " << counterExample.value();
-          observationTable.handleCEX(counterExample.value());
+        if (!counterExamples.empty()) {
+          for (const auto &counterExample: counterExamples) {
+            BOOST_LOG_TRIVIAL(info) << "Equivalence oracle returned a counter example: " << counterExample;
+          }
+          if (!observers.empty()) {
+            auto event = makeEvent(LearnerEvent::Kind::COUNTER_EXAMPLE, phaseTimes.equivalence - equivalenceStartTime);
+            event.numCounterExamples = counterExamples.size();
+            event.counterExampleLength = counterExamples.front().wordSize();
+            notify(event);
+          }
+          measure(phaseTimes.counterExample, "learner.handle_counter_examples", [&] {
+            observationTable.handleCEXs(counterExamples);
+          });
+          if (!checkpointPath.empty() && ++numIterations % checkpointInterval == 0) {
+            saveCheckpoint(checkpointPath);
+          }
         } else {
           return hypothesis;
         }
       }
     }
 
+    /*!
+     * @brief Add an observer of the learning loop
+     *
+     * The observer is notified on the thread running run. Since the notification is in the middle of the learning, it
+     * should return quickly. Use AsyncReporter to write the events to a file or a socket.
+     */
+    void addObserver(std::shared_ptr<LearnerObserver> observer) {
+      if (observers.empty()) {
+        observationTable.setCellsFilledCallback([this](std::size_t numCells, double seconds) {
+          auto event = makeEvent(LearnerEvent::Kind::MEMBERSHIP_BATCH, seconds);
+          event.numCells = numCells;
+          notify(event);
+        });
+      }
+      observers.push_back(std::move(observer));
+    }
+
+    /*!
+     * @brief Handle up to the given number of counterexamples per equivalence query
+     *
+     * All the counterexamples are analyzed against the same hypothesis and their new suffixes are added to the table at
+     * once. This reduces the number of the hypothesis constructions and the equivalence queries.
+     */
+    void setMaxCounterExamples(std::size_t max) {
+      this->maxCounterExamples = std::max<std::size_t>(max, 1);
+    }
+
+    /*!
+     * @brief Set how we search for the breakpoint of the counterexamples
+     *
+     * The binary and exponential searches take fewer membership queries for long counterexamples.
+     */
+    void setCEXAnalysisMode(CEXAnalysisMode mode) {
+      this->observationTable.setCEXAnalysisMode(mode);
+    }
+
+    /*!
+     * @brief Write a checkpoint periodically during run
+     *
+     * @param path The path to the checkpoint. The previous checkpoint is replaced atomically.
+     * @param interval We write a checkpoint once in this number of the counterexamples
+     */
+    void setCheckpoint(std::string path, std::size_t interval = 1) {
+      this->checkpointPath = std::move(path);
+      this->checkpointInterval = std::max<std::size_t>(interval, 1);
+    }
+
+    /*!
+     * @brief Write the instrumentation after each equivalence query to the given path
+     *
+     * Each line is a JSON object with the iteration number and the values accumulated so far. Nothing is written
+     * unless LEARNTA_INSTRUMENTATION is defined.
+     *
+     * @throws std::runtime_error if we cannot open the file
+     */
+    void setInstrumentationOutput(const std::string &path) {
+      if constexpr (Instrumentation::enabled) {
+        instrumentationStream.open(path, std::ios::trunc);
+        if (!instrumentationStream) {
+          throw std::runtime_error("Failed to open the instrumentation output " + path);
+        }
+      } else {
+        BOOST_LOG_TRIVIAL(warning) << "The instrumentation is disabled. Build with LEARNTA_INSTRUMENTATION to enable it";
+      }
+    }
+
+    //! @brief The instrumentation after each equivalence query
+    [[nodiscard]] const std::vector<Instrumentation::Snapshot> &getIterationStatistics() const {
+      return iterationStatistics;
+    }
+
+    /*!
+     * @brief Write the observation table, the caches of the oracles, and the memorized counterexamples
+     *
+     * We first write to a temporary file and rename it so that a killed run never leaves a broken checkpoint. The
+     * temporary file is flushed to the disk before the rename and the directory after it, so that the checkpoint is
+     * either the old one or the new one even after a power loss.
+     *
+     * @returns If we successfully wrote the checkpoint
+     */
+    bool saveCheckpoint(const std::string &path) const {
+      const std::string temporaryPath = path + ".tmp";
+      {
+        std::ofstream stream{temporaryPath, std::ios::binary | std::ios::trunc};
+        Serializer::write(stream, std::string{checkpointMagic});
+        observationTable.save(stream);
+        eqOracle->save(stream);
+        stream.flush();
+        if (!stream) {
+          BOOST_LOG_TRIVIAL(error) << "Failed to write a checkpoint to " << temporaryPath;
+          return false;
+        }
+      }
+      if (!sync(temporaryPath, O_RDONLY)) {
+        BOOST_LOG_TRIVIAL(error) << "Failed to flush the checkpoint " << temporaryPath;
+        return false;
+      }
+      if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        BOOST_LOG_TRIVIAL(error) << "Failed to rename the checkpoint to " << path;
+        return false;
+      }
+      const auto separator = path.find_last_of('/');
+      const std::string directory = separator == std::string::npos ? "." :
+                                    path.substr(0, std::max<std::size_t>(separator, 1));
+      if (!sync(directory, O_RDONLY | O_DIRECTORY)) {
+        BOOST_LOG_TRIVIAL(error) << "Failed to flush the directory of the checkpoint " << path;
+        return false;
+      }
+      LEARNTA_LOG(debug) << "Wrote a checkpoint to " << path;
+      return true;
+    }
+
+    /*!
+     * @brief Resume the learning from a checkpoint written by saveCheckpoint
+     *
+     * @pre The learner is constructed with the same alphabet and the same kinds of oracles
+     * @throws std::runtime_error if the checkpoint is broken or incompatible
+     */
+    void loadCheckpoint(const std::string &path) {
+      std::ifstream stream{path, std::ios::binary};
+      if (!stream) {
+        throw std::runtime_error("Failed to open the checkpoint " + path);
+      }
+      Serializer::readTag(stream, checkpointMagic);
+      observationTable.load(stream);
+      eqOracle->load(stream);
+      BOOST_LOG_TRIVIAL(info) << "Resumed the learning from " << path;
+    }
+
     std::ostream &printStatistics(std::ostream &stream) const {
       this->observationTable.printStatistics(stream);
+      stream << "Number of hypotheses reusing the previous zone-based simplification: "
+             << zoneSimplifier.getNumReusedHypotheses() << "\n";
+      stream << "Number of zones reused from the previous zone graph: " << zoneSimplifier.getNumReusedZones() << "\n";
+      stream << "Phase Time (observation table): " << phaseTimes.table * 1000 << " [ms]\n";
+      stream << "Phase Time (hypothesis construction): " << phaseTimes.hypothesis * 1000 << " [ms]\n";
+      stream << "Phase Time (zone-based simplification): " << phaseTimes.zones * 1000 << " [ms]\n";
+      stream << "Phase Time (equivalence queries): " << phaseTimes.equivalence * 1000 << " [ms]\n";
+      stream << "Phase Time (counterexample analysis): " << phaseTimes.counterExample * 1000 << " [ms]\n";
       this->eqOracle->printStatistics(stream);
+      if constexpr (Instrumentation::enabled) {
+        Instrumentation::global().snapshot().printJson(stream << "Instrumentation: ") << "\n";
+      }
 
       return stream;
     }
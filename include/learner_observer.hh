@@ -0,0 +1,81 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/12.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+
+namespace learnta {
+  /*!
+   * @brief An event in the learning loop
+   *
+   * This is a plain value so that observers can copy it to a queue without allocation. The fields irrelevant to the
+   * kind of the event are zero.
+   */
+  struct LearnerEvent {
+    enum class Kind {
+      //! @brief The observation table became closed, consistent, exterior-consistent, and time-saturated
+      TABLE_CLOSED,
+      //! @brief The learner constructed a hypothesis
+      HYPOTHESIS,
+      //! @brief The equivalence oracle returned counterexamples
+      COUNTER_EXAMPLE,
+      //! @brief The learner filled a batch of cells of the observation table by membership queries
+      MEMBERSHIP_BATCH,
+    };
+    Kind kind;
+    //! @brief The number of the hypotheses constructed so far, including the current one
+    std::size_t iteration;
+    //! @brief The seconds since the learning started
+    double time;
+    //! @brief The seconds of the operation reported by this event, e.g., the equivalence query for COUNTER_EXAMPLE
+    double duration;
+    //! @brief The number of the prefixes in P
+    std::size_t numP;
+    //! @brief The number of all the prefixes, i.e., the rows in P and ext(P)
+    std::size_t numPrefixes;
+    std::size_t numSuffixes;
+    //! @brief The number of the membership queries to the system under learning so far
+    std::size_t numMembershipQueries;
+    //! @brief The number of the states of the hypothesis for HYPOTHESIS
+    std::size_t numStates;
+    //! @brief The number of the transitions of the hypothesis for HYPOTHESIS
+    std::size_t numTransitions;
+    //! @brief The number of the counterexamples for COUNTER_EXAMPLE
+    std::size_t numCounterExamples;
+    //! @brief The number of the actions in the first counterexample for COUNTER_EXAMPLE
+    std::size_t counterExampleLength;
+    //! @brief The number of the filled cells for MEMBERSHIP_BATCH
+    std::size_t numCells;
+  };
+
+  static inline std::ostream &operator<<(std::ostream &os, const LearnerEvent::Kind kind) {
+    switch (kind) {
+      case LearnerEvent::Kind::TABLE_CLOSED:
+        return os << "table_closed";
+      case LearnerEvent::Kind::HYPOTHESIS:
+        return os << "hypothesis";
+      case LearnerEvent::Kind::COUNTER_EXAMPLE:
+        return os << "counterexample";
+      case LearnerEvent::Kind::MEMBERSHIP_BATCH:
+        return os << "membership_batch";
+    }
+    return os;
+  }
+
+  /*!
+   * @brief Interface to observe the learning loop
+   *
+   * The learner calls notify on its own thread in the middle of the learning. Therefore, the implementation must
+   * return quickly, e.g., by passing the event to another thread as AsyncReporter.
+   */
+  class LearnerObserver {
+  public:
+    virtual ~LearnerObserver() = default;
+
+    virtual void notify(const LearnerEvent &event) = 0;
+  };
+}
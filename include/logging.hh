@@ -0,0 +1,47 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/14.
+ * @brief Logging with a compile-time minimum severity
+ *
+ * LEARNTA_LOG(severity) is a drop-in replacement of BOOST_LOG_TRIVIAL(severity). If the severity is lower than
+ * LEARNTA_MIN_LOG_LEVEL, the statement, including the formatting of its arguments, is removed at compile time.
+ * Otherwise, it is passed to Boost.Log and filtered at runtime as usual.
+ *
+ * LEARNTA_MIN_LOG_LEVEL is one of the LEARNTA_LOG_LEVEL_* below. By default, it is LEARNTA_LOG_LEVEL_INFO if NDEBUG is
+ * defined and LEARNTA_LOG_LEVEL_TRACE otherwise, matching the runtime filters in the examples.
+ */
+
+#pragma once
+
+#include <boost/log/trivial.hpp>
+
+#define LEARNTA_LOG_LEVEL_TRACE 0
+#define LEARNTA_LOG_LEVEL_DEBUG 1
+#define LEARNTA_LOG_LEVEL_INFO 2
+#define LEARNTA_LOG_LEVEL_WARNING 3
+#define LEARNTA_LOG_LEVEL_ERROR 4
+#define LEARNTA_LOG_LEVEL_FATAL 5
+
+#ifndef LEARNTA_MIN_LOG_LEVEL
+#ifdef NDEBUG
+#define LEARNTA_MIN_LOG_LEVEL LEARNTA_LOG_LEVEL_INFO
+#else
+#define LEARNTA_MIN_LOG_LEVEL LEARNTA_LOG_LEVEL_TRACE
+#endif
+#endif
+
+// The empty branch comes first so that a following else binds to the enclosing if as for BOOST_LOG_TRIVIAL
+#define LEARNTA_LOG(severity) \
+  if constexpr (!::learnta::logEnabled(::boost::log::trivial::severity)) {} else BOOST_LOG_TRIVIAL(severity)
+
+namespace learnta {
+  //! @brief If the statements of the given severity are compiled
+  constexpr bool logEnabled(boost::log::trivial::severity_level severity) {
+    // The enumerators of Boost.Log are in the same order as LEARNTA_LOG_LEVEL_*
+    return static_cast<int>(severity) >= LEARNTA_MIN_LOG_LEVEL;
+  }
+
+  static_assert(static_cast<int>(boost::log::trivial::trace) == LEARNTA_LOG_LEVEL_TRACE &&
+                static_cast<int>(boost::log::trivial::fatal) == LEARNTA_LOG_LEVEL_FATAL,
+                "The log levels must match the severity levels of Boost.Log");
+}
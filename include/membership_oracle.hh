@@ -4,11 +4,20 @@
  */
 
 #pragma once
+#include <atomic>
+#include <cmath>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 #include <boost/unordered_map.hpp>
 
 #include "sul.hh"
 #include "timed_word.hh"
+#include "serialization.hh"
 
 namespace learnta {
   /*!
@@ -25,29 +34,46 @@ namespace learnta {
 
       return stream;
     }
+
+    //! @brief Write the cached results to a checkpoint. The oracles without cache write nothing.
+    virtual void save(std::ostream &) const {}
+
+    //! @brief Restore the cached results from a checkpoint written by save
+    virtual void load(std::istream &) {}
   };
 
+  /*!
+   * @brief Feed a timed word to an SUL and return the final output
+   */
+  static inline bool feedTimedWord(SUL &sul, const TimedWord &timedWord) {
+    sul.pre();
+    const Word &word = timedWord.getWord();
+    const std::vector<double> &duration = timedWord.getDurations();
+    bool result = sul.step(duration[0]);
+    for (std::size_t i = 0; i < timedWord.wordSize(); i++) {
+      sul.step(word[i]);
+      result = sul.step(duration[i + 1]);
+    }
+    sul.post();
+
+    return result;
+  }
+
   /*!
    * @brief Membership oracle defined by an SUL
+   *
+   * @note The queries are serialized so that this oracle can be used from multiple threads.
    */
   class SULMembershipOracle final : public MembershipOracle {
   private:
     std::unique_ptr<SUL> sul;
+    std::mutex sulMutex;
   public:
     explicit SULMembershipOracle(std::unique_ptr<SUL> &&sul) : sul(std::move(sul)) {}
 
     bool answerQuery(const learnta::TimedWord &timedWord) override {
-      sul->pre();
-      std::string word = timedWord.getWord();
-      std::vector<double> duration = timedWord.getDurations();
-      bool result = sul->step(duration[0]);
-      for (std::size_t i = 0; i < timedWord.wordSize(); i++) {
-        sul->step(word[i]);
-        result = sul->step(duration[i + 1]);
-      }
-      sul->post();
-
-      return result;
+      std::lock_guard<std::mutex> lock{sulMutex};
+      return feedTimedWord(*sul, timedWord);
     }
 
     [[nodiscard]] size_t count() const override {
@@ -55,24 +81,73 @@ namespace learnta {
     }
   };
 
+  /*!
+   * @brief Membership oracle defined by a pool of SULs, which answers the queries from multiple threads in parallel
+   *
+   * Each query is fed to one of the SULs not used by the other threads. All the SULs must behave in the same way.
+   */
+  class SULPoolMembershipOracle final : public MembershipOracle {
+  private:
+    std::vector<std::unique_ptr<SUL>> suls;
+    std::vector<std::mutex> sulMutexes;
+    std::atomic<std::size_t> nextSUL{0};
+  public:
+    /*!
+     * @pre suls is not empty
+     */
+    explicit SULPoolMembershipOracle(std::vector<std::unique_ptr<SUL>> &&suls) : suls(std::move(suls)),
+                                                                                 sulMutexes(this->suls.size()) {
+      assert(!this->suls.empty());
+    }
+
+    bool answerQuery(const learnta::TimedWord &timedWord) override {
+      const std::size_t start = nextSUL++;
+      // We first try to find an SUL not used by the other threads
+      for (std::size_t i = 0; i < suls.size(); ++i) {
+        const std::size_t index = (start + i) % suls.size();
+        std::unique_lock<std::mutex> lock{sulMutexes.at(index), std::try_to_lock};
+        if (lock.owns_lock()) {
+          return feedTimedWord(*suls.at(index), timedWord);
+        }
+      }
+      // If all of them are busy, we wait for one of them
+      const std::size_t index = start % suls.size();
+      std::lock_guard<std::mutex> lock{sulMutexes.at(index)};
+      return feedTimedWord(*suls.at(index), timedWord);
+    }
+
+    [[nodiscard]] size_t count() const override {
+      return std::accumulate(suls.begin(), suls.end(), std::size_t{0}, [](std::size_t sum, const auto &sul) {
+        return sum + sul->count();
+      });
+    }
+  };
+
   /*!
    * @brief Wrapper of a membership oracle to cache the result
+   *
+   * @note This oracle is thread-safe if the wrapped oracle is thread-safe. The wrapped oracle is called without locking.
    */
   class MembershipOracleCache final : public MembershipOracle {
     std::unique_ptr<MembershipOracle> oracle;
     boost::unordered_map<TimedWord, bool> membershipCache;
-    std::size_t countNoCache = 0;
+    mutable std::mutex cacheMutex;
+    std::atomic<std::size_t> countNoCache{0};
 
   public:
     explicit MembershipOracleCache(std::unique_ptr<MembershipOracle> &&oracle) : oracle(std::move(oracle)) {}
 
     bool answerQuery(const TimedWord &timedWord) override {
       ++countNoCache;
-      auto it = this->membershipCache.find(timedWord);
-      if (it != membershipCache.end()) {
-        return it->second;
+      {
+        std::lock_guard<std::mutex> lock{cacheMutex};
+        auto it = this->membershipCache.find(timedWord);
+        if (it != membershipCache.end()) {
+          return it->second;
+        }
       }
       const auto result = this->oracle->answerQuery(timedWord);
+      std::lock_guard<std::mutex> lock{cacheMutex};
       this->membershipCache[timedWord] = result;
 
       return result;
@@ -88,5 +163,155 @@ namespace learnta {
 
       return stream;
     }
+
+    void save(std::ostream &os) const override {
+      {
+        std::lock_guard<std::mutex> lock{cacheMutex};
+        Serializer::writeTag(os, "MembershipOracleCache");
+        Serializer::write(os, membershipCache);
+      }
+      this->oracle->save(os);
+    }
+
+    void load(std::istream &is) override {
+      {
+        std::lock_guard<std::mutex> lock{cacheMutex};
+        Serializer::readTag(is, "MembershipOracleCache");
+        Serializer::read(is, membershipCache);
+      }
+      this->oracle->load(is);
+    }
+  };
+
+  /*!
+   * @brief Wrapper of a membership oracle to cache the result for each region of timed words
+   *
+   * Let \f$t_0 = 0, t_1, \dots, t_{n+1}\f$ be the timestamps of the events in a timed word, including the start and
+   * the end. The region of the timed word is the untimed word and, for each \f$i < j\f$, the integer part of
+   * \f$t_j - t_i\f$ and if it is an integer, where the differences larger than the maximal constant are not
+   * distinguished. If the maximal constant of the SUL is given, the timed words in the same region are accepted or
+   * rejected altogether, and we answer them by one query. Thus, the samples of the same simple elementary language
+   * hit each other even if they are different as timed words.
+   *
+   * If verification is enabled, we also query the wrapped oracle for the cache hits and report the mismatches, e.g.,
+   * because the given maximal constant is too small. This is for debugging and does not reduce the queries.
+   *
+   * @note This oracle is thread-safe if the wrapped oracle is thread-safe. The wrapped oracle is called without locking.
+   */
+  class RegionalMembershipOracleCache final : public MembershipOracle {
+  public:
+    using Region = std::pair<Word, std::vector<int>>;
+  private:
+    // The tolerance to judge if the accumulated durations are integers
+    static constexpr double epsilon = 1e-9;
+    std::unique_ptr<MembershipOracle> oracle;
+    const int maxConstant;
+    const bool verify;
+    boost::unordered_map<Region, bool> membershipCache;
+    mutable std::mutex cacheMutex;
+    std::atomic<std::size_t> countNoCache{0};
+    std::atomic<std::size_t> countHit{0};
+    std::atomic<std::size_t> countMismatch{0};
+
+  public:
+    /*!
+     * @param maxConstant The maximal constant in the guards of the SUL
+     * @param verify If it is true, we check the cache hits by the wrapped oracle
+     */
+    RegionalMembershipOracleCache(std::unique_ptr<MembershipOracle> &&oracle, int maxConstant, bool verify = false) :
+            oracle(std::move(oracle)), maxConstant(maxConstant), verify(verify) {}
+
+    //! @brief The region of the given timed word
+    [[nodiscard]] Region region(const TimedWord &timedWord) const {
+      const auto &durations = timedWord.getDurations();
+      Region result{timedWord.getWord(), {}};
+      result.second.reserve(durations.size() * (durations.size() + 1) / 2);
+      for (std::size_t i = 0; i < durations.size(); ++i) {
+        // We accumulate from each timestamp to reduce the rounding errors
+        double difference = 0;
+        for (std::size_t j = i; j < durations.size(); ++j) {
+          difference += durations.at(j);
+          const double rounded = std::round(difference);
+          if (difference > maxConstant + epsilon) {
+            result.second.push_back(2 * maxConstant + 1);
+          } else if (std::abs(difference - rounded) < epsilon) {
+            result.second.push_back(2 * static_cast<int>(rounded));
+          } else {
+            result.second.push_back(2 * static_cast<int>(std::floor(difference)) + 1);
+          }
+        }
+      }
+
+      return result;
+    }
+
+    bool answerQuery(const TimedWord &timedWord) override {
+      ++countNoCache;
+      auto key = region(timedWord);
+      std::optional<bool> cached;
+      {
+        std::lock_guard<std::mutex> lock{cacheMutex};
+        auto it = this->membershipCache.find(key);
+        if (it != membershipCache.end()) {
+          cached = it->second;
+        }
+      }
+      if (cached) {
+        ++countHit;
+        if (!verify) {
+          return *cached;
+        }
+        const auto result = this->oracle->answerQuery(timedWord);
+        if (result != *cached) {
+          ++countMismatch;
+          BOOST_LOG_TRIVIAL(error) << "RegionalMembershipOracleCache: the cached result " << *cached
+                                   << " is different from the result " << result << " of " << timedWord;
+        }
+        return result;
+      }
+      const auto result = this->oracle->answerQuery(timedWord);
+      std::lock_guard<std::mutex> lock{cacheMutex};
+      this->membershipCache.emplace(std::move(key), result);
+
+      return result;
+    }
+
+    [[nodiscard]] size_t count() const override {
+      return this->oracle->count();
+    }
+
+    //! @brief The number of the cache hits that were different from the wrapped oracle in the verification
+    [[nodiscard]] std::size_t numMismatches() const {
+      return countMismatch;
+    }
+
+    std::ostream &printStatistics(std::ostream &stream) const override {
+      stream << "Number of membership queries: " << countNoCache << "\n";
+      stream << "Number of membership queries answered by the regional cache: " << countHit << "\n";
+      if (verify) {
+        stream << "Number of mismatches in the regional cache: " << countMismatch << "\n";
+      }
+      stream << "Number of membership queries (with cache): " << this->count() << "\n";
+
+      return stream;
+    }
+
+    void save(std::ostream &os) const override {
+      {
+        std::lock_guard<std::mutex> lock{cacheMutex};
+        Serializer::writeTag(os, "RegionalMembershipOracleCache");
+        Serializer::write(os, membershipCache);
+      }
+      this->oracle->save(os);
+    }
+
+    void load(std::istream &is) override {
+      {
+        std::lock_guard<std::mutex> lock{cacheMutex};
+        Serializer::readTag(is, "RegionalMembershipOracleCache");
+        Serializer::read(is, membershipCache);
+      }
+      this->oracle->load(is);
+    }
   };
 }
@@ -0,0 +1,342 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/18.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "timed_automaton.hh"
+
+namespace learnta {
+  namespace internal {
+#ifdef LEARNTA_WIDE_ALPHABET
+    //! @brief The type of the actions in the generated code
+    static constexpr const char *actionType = "char16_t";
+
+    //! @brief The literal of an action in the generated code
+    static inline std::string actionLiteral(Alphabet action) {
+      return "static_cast<char16_t>(" + std::to_string(static_cast<unsigned int>(action)) + ")";
+    }
+#else
+    //! @brief The type of the actions in the generated code
+    static constexpr const char *actionType = "char";
+
+    //! @brief The character literal of an action in the generated code
+    static inline std::string actionLiteral(Alphabet action) {
+      const auto code = static_cast<unsigned char>(action);
+      if (std::isalnum(code) || (std::ispunct(code) && action != '\'' && action != '\\')) {
+        return std::string{"'"} + action + "'";
+      } else {
+        return "static_cast<char>(" + std::to_string(static_cast<int>(code)) + ")";
+      }
+    }
+#endif
+
+    /*!
+     * @brief Remove the constraints implied by another constraint in the same guard
+     *
+     * Both the satisfaction and lowerBoundDurationToSatisfy of the guard are unchanged because the removed constraints
+     * never decide them.
+     */
+    static inline std::vector<Constraint> foldGuard(const std::vector<Constraint> &guard) {
+      std::vector<Constraint> result;
+      for (std::size_t i = 0; i < guard.size(); ++i) {
+        bool implied = false;
+        for (std::size_t j = 0; j < guard.size() && !implied; ++j) {
+          // Among the equivalent constraints, we keep the first one
+          implied = i != j && guard.at(i).isWeaker(guard.at(j)) && (!guard.at(j).isWeaker(guard.at(i)) || j < i);
+        }
+        if (!implied) {
+          result.push_back(guard.at(i));
+        }
+      }
+
+      return result;
+    }
+
+    static inline std::string comparison(Constraint::Order odr) {
+      switch (odr) {
+        case Constraint::Order::lt:
+          return " < ";
+        case Constraint::Order::le:
+          return " <= ";
+        case Constraint::Order::ge:
+          return " >= ";
+        case Constraint::Order::gt:
+          return " > ";
+      }
+      throw std::range_error("Invalid order is used");
+    }
+  }
+
+  /*!
+   * @brief Generate a self-contained C++ header of a monitor executing the given DTA
+   *
+   * The generated class has the same semantics as TimedAutomatonRunner, including the unobservable transitions, but
+   * it depends only on the standard library. The states are the cases of switch statements, and the guards and the
+   * resets are inlined with their constants. The state indices in the generated code are the ones in
+   * TimedAutomaton::states, and the sink state is -1. The generated class provides the following members.
+   * - reset() to go back to the initial configuration
+   * - step(char) (step(char16_t) with LEARNTA_WIDE_ALPHABET) and step(double) returning if the current state is
+   *   accepting, as in SUL
+   * - accepting(), getState(), and getClockValuation() to observe the current configuration
+   *
+   * @note Unlike TimedAutomatonRunner, an unobservable transition with the empty guard is taken immediately.
+   * @throws std::invalid_argument if the DTA does not have exactly one initial state or refers to an unknown state or
+   * clock variable
+   */
+  static inline void generateMonitor(std::ostream &os, const TimedAutomaton &automaton, const std::string &className) {
+    using namespace internal;
+    const bool isEmpty = automaton.states.empty();
+    if (!isEmpty && automaton.initialStates.size() != 1) {
+      throw std::invalid_argument("The monitor requires exactly one initial state");
+    }
+    std::unordered_map<const TAState *, int> toIndex;
+    for (std::size_t i = 0; i < automaton.states.size(); ++i) {
+      toIndex[automaton.states.at(i).get()] = static_cast<int>(i);
+    }
+    const std::size_t numClocks = automaton.maxConstraints.size();
+    auto index = [&](const TAState *state) {
+      auto it = toIndex.find(state);
+      if (it == toIndex.end()) {
+        throw std::invalid_argument("The DTA refers to a state not in TimedAutomaton::states");
+      }
+      return it->second;
+    };
+    auto clockIndex = [&](ClockVariables x) {
+      if (x >= numClocks) {
+        throw std::invalid_argument("The DTA refers to an unknown clock variable x" + std::to_string(x));
+      }
+      return "[" + std::to_string(x) + "]";
+    };
+    auto clock = [&](ClockVariables x) {
+      return "clocks" + clockIndex(x);
+    };
+    std::stringstream constantStream;
+    constantStream << std::setprecision(std::numeric_limits<double>::max_digits10);
+    auto constant = [&](double value) {
+      constantStream.str("");
+      constantStream << value;
+      return constantStream.str();
+    };
+    // The condition of a guard
+    auto condition = [&](const std::vector<Constraint> &guard) {
+      const auto folded = foldGuard(guard);
+      if (folded.empty()) {
+        return std::string{"true"};
+      }
+      std::string result;
+      for (const auto &constraint: folded) {
+        result += (result.empty() ? "" : " && ") + clock(constraint.x) + comparison(constraint.odr) +
+                  std::to_string(constraint.c);
+      }
+      return result;
+    };
+    // The statements to take a transition
+    auto take = [&](const TATransition &transition, const std::string &indent) {
+      std::string result;
+      const bool copiesClock = std::any_of(transition.resetVars.begin(), transition.resetVars.end(),
+                                           [](const auto &reset) { return reset.second.index() == 1; });
+      if (copiesClock) {
+        result += indent + "const auto old = clocks;\n";
+      }
+      for (const auto &[resetVariable, targetVariable]: transition.resetVars) {
+        result += indent + clock(resetVariable) + " = ";
+        if (targetVariable.index() == 1) {
+          // We read the values before the resets as in TimedAutomatonRunner::applyReset
+          result += "old" + clockIndex(std::get<ClockVariables>(targetVariable)) + ";\n";
+        } else {
+          result += constant(std::get<double>(targetVariable)) + ";\n";
+        }
+      }
+      result += indent + "state = " + std::to_string(index(transition.target)) + ";\n";
+      return result;
+    };
+
+    os << "// Generated by LearnTA. Do not edit.\n"
+       << "#pragma once\n\n"
+       << "#include <algorithm>\n"
+       << "#include <array>\n"
+       << "#include <cmath>\n"
+       << "#include <cstddef>\n"
+       << "#include <limits>\n"
+       << "#include <utility>\n\n"
+       << "class " << className << " {\n"
+       << "public:\n"
+       << "  static constexpr std::size_t numClocks = " << numClocks << ";\n"
+       << "  static constexpr int sink = -1;\n\n"
+       << "  " << className << "() {\n"
+       << "    reset();\n"
+       << "  }\n\n"
+       << "  void reset() {\n"
+       << "    state = " << (isEmpty ? "sink" : std::to_string(index(automaton.initialStates.front().get()))) << ";\n"
+       << "    clocks.fill(0);\n"
+       << "  }\n\n";
+
+    // accepting()
+    os << "  [[nodiscard]] bool accepting() const {\n"
+       << "    switch (state) {\n";
+    for (std::size_t i = 0; i < automaton.states.size(); ++i) {
+      if (automaton.states.at(i)->isMatch) {
+        os << "      case " << i << ":\n";
+      }
+    }
+    if (std::any_of(automaton.states.begin(), automaton.states.end(), [](const auto &s) { return s->isMatch; })) {
+      os << "        return true;\n";
+    }
+    os << "      default:\n"
+       << "        return false;\n"
+       << "    }\n"
+       << "  }\n\n";
+
+    // step(char)
+    os << "  bool step(" << actionType << " action) {\n"
+       << "    switch (state) {\n";
+    for (std::size_t i = 0; i < automaton.states.size(); ++i) {
+      const auto &state = automaton.states.at(i);
+      if (state->next.empty()) {
+        continue;
+      }
+      os << "      case " << i << ":\n"
+         << "        switch (action) {\n";
+      for (const auto &[action, transitions]: state->next) {
+        if (transitions.empty()) {
+          continue;
+        }
+        os << "          case " << actionLiteral(action) << ":\n";
+        for (const auto &transition: transitions) {
+          const auto guard = condition(transition.guard);
+          os << (guard == "true" ? "            {\n" : "            if (" + guard + ") {\n")
+             << take(transition, "              ")
+             << "              return " << (transition.target->isMatch ? "true" : "false") << ";\n"
+             << "            }\n";
+        }
+        os << "            break;\n";
+      }
+      os << "          default:\n"
+         << "            break;\n"
+         << "        }\n"
+         << "        break;\n";
+    }
+    os << "      default:\n"
+       << "        break;\n"
+       << "    }\n"
+       << "    // If there is no outgoing transition, we go to the sink state\n"
+       << "    state = sink;\n"
+       << "    return false;\n"
+       << "  }\n\n";
+
+    // step(double)
+    const bool hasUnobservable = std::any_of(automaton.states.begin(), automaton.states.end(), [](const auto &s) {
+      auto it = s->next.find(UNOBSERVABLE);
+      return it != s->next.end() && !it->second.empty();
+    });
+    os << "  bool step(double duration) {\n"
+       << "    while (state != sink) {\n"
+       << "      if (duration == 0) {\n"
+       << "        return accepting();\n"
+       << "      }\n";
+    if (hasUnobservable) {
+      // As in TimedAutomatonRunner::step(double), we take the unobservable transition enabled first
+      os << "      switch (state) {\n";
+      for (std::size_t i = 0; i < automaton.states.size(); ++i) {
+        auto it = automaton.states.at(i)->next.find(UNOBSERVABLE);
+        if (it == automaton.states.at(i)->next.end() || it->second.empty()) {
+          continue;
+        }
+        const auto &transitions = it->second;
+        os << "        case " << i << ": {\n";
+        for (std::size_t j = 0; j < transitions.size(); ++j) {
+          const auto folded = foldGuard(transitions.at(j).guard);
+          os << "          const Bound bound" << j << " = ";
+          if (folded.empty()) {
+            os << "Bound{0.0, true}";
+          } else {
+            os << (folded.size() > 1 ? "std::min({" : "");
+            for (std::size_t k = 0; k < folded.size(); ++k) {
+              const auto &constraint = folded.at(k);
+              os << (k > 0 ? ",\n                                    " : "");
+              if (constraint.isUpperBound()) {
+                os << "(" << clock(constraint.x) << " <= " << constraint.c << " ? Bound{0.0, true} : Bound{"
+                   << "-std::numeric_limits<double>::infinity(), false})";
+              } else {
+                os << "std::min(Bound{0.0, true}, Bound{" << clock(constraint.x) << " - " << constraint.c << ", "
+                   << (constraint.odr == Constraint::Order::ge ? "true" : "false") << "})";
+              }
+            }
+            os << (folded.size() > 1 ? "})" : "");
+          }
+          os << ";\n";
+        }
+        os << "          Bound minimum = bound0;\n";
+        if (transitions.size() > 1) {
+          os << "          int chosen = 0;\n";
+          for (std::size_t j = 1; j < transitions.size(); ++j) {
+            os << "          if (bound" << j << " < minimum) {\n"
+               << "            minimum = bound" << j << ";\n"
+               << "            chosen = " << j << ";\n"
+               << "          }\n";
+          }
+        }
+        os << "          if (std::isfinite(minimum.first) && minimum.first <= 0 &&\n"
+           << "              Bound{-duration, true} <= minimum) {\n"
+           << "            elapse(-minimum.first);\n";
+        if (transitions.size() > 1) {
+          os << "            switch (chosen) {\n";
+          for (std::size_t j = 0; j < transitions.size(); ++j) {
+            os << "              case " << j << ":\n"
+               << take(transitions.at(j), "                ")
+               << "                break;\n";
+          }
+          os << "              default:\n"
+             << "                break;\n"
+             << "            }\n";
+        } else {
+          os << take(transitions.front(), "            ");
+        }
+        os << "            duration -= (minimum.first == 0 && !minimum.second) ? 1.0e-10 : -minimum.first;\n"
+           << "            continue;\n"
+           << "          }\n"
+           << "          break;\n"
+           << "        }\n";
+      }
+      os << "        default:\n"
+         << "          break;\n"
+         << "      }\n";
+    }
+    os << "      elapse(duration);\n"
+       << "      return accepting();\n"
+       << "    }\n"
+       << "    return false;\n"
+       << "  }\n\n";
+
+    os << "  //! @brief The current state. This is sink if we are at the sink state.\n"
+       << "  [[nodiscard]] int getState() const {\n"
+       << "    return state;\n"
+       << "  }\n\n"
+       << "  [[nodiscard]] const std::array<double, numClocks> &getClockValuation() const {\n"
+       << "    return clocks;\n"
+       << "  }\n\n"
+       << "private:\n"
+       << "  using Bound = std::pair<double, bool>;\n"
+       << "  int state = sink;\n"
+       << "  std::array<double, numClocks> clocks{};\n\n"
+       << "  void elapse(double duration) {\n"
+       << "    for (double &value: clocks) {\n"
+       << "      value += duration;\n"
+       << "    }\n"
+       << "  }\n"
+       << "};\n";
+  }
+}
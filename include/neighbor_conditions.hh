@@ -7,12 +7,13 @@
 
 #include <utility>
 #include <vector>
-#include <unordered_set>
 
 #include "common_types.hh"
+#include "clock_set.hh"
 #include "timed_automaton.hh"
 #include "forward_regional_elementary_language.hh"
 #include "external_transition_maker.hh"
+#include "logging.hh"
 
 namespace learnta {
 
@@ -32,7 +33,7 @@ namespace learnta {
     // The original elementary language
     ForwardRegionalElementaryLanguage original;
     // The precise clock variables
-    std::unordered_set<ClockVariables> preciseClocks;
+    ClockSet preciseClocks;
     // The neighbor elementary languages due to imprecise clocks
     std::vector<ForwardRegionalElementaryLanguage> neighbors;
     std::size_t clockSize;
@@ -61,15 +62,7 @@ namespace learnta {
 
     NeighborConditions(ForwardRegionalElementaryLanguage &&original,
                        std::vector<ForwardRegionalElementaryLanguage> &&neighbors,
-                       const std::unordered_set<ClockVariables> &preciseClocks,
-                       size_t clockSize) : original(original), preciseClocks(preciseClocks),
-                                           neighbors(neighbors), clockSize(clockSize) {
-      assertInvariants();
-    }
-
-    NeighborConditions(ForwardRegionalElementaryLanguage &&original,
-                       std::vector<ForwardRegionalElementaryLanguage> &&neighbors,
-                       std::unordered_set<ClockVariables> &&preciseClocks,
+                       const ClockSet &preciseClocks,
                        size_t clockSize) : original(original), preciseClocks(preciseClocks),
                                            neighbors(neighbors), clockSize(clockSize) {
       assertInvariants();
@@ -81,13 +74,13 @@ namespace learnta {
      * A clock variable x is implicitly precise if we have c <= x <= c in original.
      */
     void addImplicitPreciseClocks() {
-      BOOST_LOG_TRIVIAL(debug) << "explicit precise clocks: ";
+      LEARNTA_LOG(debug) << "explicit precise clocks: ";
       for (const auto &preciseClock: preciseClocks) {
-        BOOST_LOG_TRIVIAL(debug) << "x" << static_cast<int>(preciseClock);
+        LEARNTA_LOG(debug) << "x" << static_cast<int>(preciseClock);
       }
       for (std::size_t i = 0; i < clockSize; ++i) {
         // We skip explicitly precise clocks
-        if (this->preciseClocks.find(i) != this->preciseClocks.end()) {
+        if (this->preciseClocks.contains(i)) {
           continue;
         }
         const auto lowerBound = this->original.getTimedCondition().getLowerBound(i, clockSize - 1);
@@ -99,14 +92,14 @@ namespace learnta {
           this->preciseClocks.insert(i);
         }
       }
-      BOOST_LOG_TRIVIAL(debug) << "appended precise clocks: ";
+      LEARNTA_LOG(debug) << "appended precise clocks: ";
       for (const auto &preciseClock: preciseClocks) {
-        BOOST_LOG_TRIVIAL(debug) << "x" << static_cast<int>(preciseClock);
+        LEARNTA_LOG(debug) << "x" << static_cast<int>(preciseClock);
       }
     }
 
     [[nodiscard]] auto updateNeighborsWithContinuousSuccessors(const ForwardRegionalElementaryLanguage &originalSuccessor) const {
-      BOOST_LOG_TRIVIAL(debug) << "originalSuccessor: " << originalSuccessor;
+      LEARNTA_LOG(debug) << "originalSuccessor: " << originalSuccessor;
       // The neighbor elementary languages due to imprecise clocks
       std::vector<ForwardRegionalElementaryLanguage> newNeighbors;
       newNeighbors.reserve(neighbors.size());
@@ -144,16 +137,15 @@ namespace learnta {
     /*!
      * @brief Make precise clocks after applying a reset
      */
-    static auto preciseClocksAfterReset(const std::unordered_set<ClockVariables>& preciseClocks,
-                                        const TATransition &transition) {
-      std::unordered_set<ClockVariables> newPreciseClocks;
+    static ClockSet preciseClocksAfterReset(const ClockSet &preciseClocks, const TATransition &transition) {
+      ClockSet newPreciseClocks;
       const auto targetClockSize = computeTargetClockSize(transition);
       for (const auto &[targetVariable, assignedValue]: transition.resetVars) {
         if (targetVariable >= targetClockSize) {
           continue;
         }
         if (assignedValue.index() == 1 &&
-            preciseClocks.find(std::get<ClockVariables>(assignedValue)) != preciseClocks.end()) {
+            preciseClocks.contains(std::get<ClockVariables>(assignedValue))) {
           // targetVariable is precise if its value is updated to a precise variable
           newPreciseClocks.insert(targetVariable);
         } else if (assignedValue.index() == 0 &&
@@ -164,7 +156,7 @@ namespace learnta {
       }
       for (const auto &preciseClock: preciseClocks) {
         // Check if the precise clock is in the range and not updated
-        if (preciseClock >= targetClockSize || newPreciseClocks.find(preciseClock) != newPreciseClocks.end()) {
+        if (preciseClock >= targetClockSize || newPreciseClocks.contains(preciseClock)) {
           continue;
         }
         auto it = std::find_if(transition.resetVars.begin(), transition.resetVars.end(), [&] (const auto &reset) {
@@ -182,27 +174,21 @@ namespace learnta {
     /*!
      * @brief Make precise clocks after applying a reset
      */
-    [[nodiscard]] auto preciseClocksAfterReset(const TATransition &transition) const {
+    [[nodiscard]] ClockSet preciseClocksAfterReset(const TATransition &transition) const {
       return NeighborConditions::preciseClocksAfterReset(this->preciseClocks, transition);
     }
 
     /*!
      * @brief Reconstruct the neighbor conditions with new precise clocks
      */
-    [[nodiscard]] NeighborConditions reconstruct(std::unordered_set<ClockVariables> currentPreciseClocks) const {
+    [[nodiscard]] NeighborConditions reconstruct(ClockSet currentPreciseClocks) const {
       // Restrict the range of precise clocks
-      for (auto it = currentPreciseClocks.begin(); it != currentPreciseClocks.end();) {
-        if (*it > this->original.wordSize()) {
-          it = currentPreciseClocks.erase(it);
-        } else {
-          ++it;
-        }
-      }
-      return NeighborConditions{this->original, std::move(currentPreciseClocks)};
+      currentPreciseClocks &= ClockSet::range(this->original.wordSize() + 1);
+      return NeighborConditions{this->original, currentPreciseClocks};
     }
 
     static auto makeNeighbors(const ForwardRegionalElementaryLanguage &original,
-                              const std::unordered_set<ClockVariables> &preciseClocks) {
+                              const ClockSet &preciseClocks) {
       const auto clockSize = original.getTimedCondition().size();
       std::vector<ForwardRegionalElementaryLanguage> neighbors;
 
@@ -215,8 +201,7 @@ namespace learnta {
         neighborsCondition.restrictUpperBound(i, clockSize - 1,
                                               original.getTimedCondition().getUpperBound(i, clockSize - 1));
         for (std::size_t j = i + 1; j < clockSize; ++j) {
-          if ((preciseClocks.find(i) == preciseClocks.end()) ==
-              (preciseClocks.find(j) == preciseClocks.end())) {
+          if (preciseClocks.contains(i) == preciseClocks.contains(j)) {
             // The constraints of the form x - y \in I is used if both are precise or imprecise
             neighborsCondition.restrictLowerBound(i, j - 1, original.getTimedCondition().getLowerBound(i, j - 1));
             neighborsCondition.restrictUpperBound(i, j - 1, original.getTimedCondition().getUpperBound(i, j - 1));
@@ -239,8 +224,8 @@ namespace learnta {
     NeighborConditions& operator=(const NeighborConditions& conditions) = default;
     NeighborConditions& operator=(NeighborConditions&& conditions) = default;
     NeighborConditions(ForwardRegionalElementaryLanguage original,
-                       std::unordered_set<ClockVariables> preciseClocks) : original(std::move(original)),
-                                                                           preciseClocks(std::move(preciseClocks)),
+                       const ClockSet &preciseClocks) : original(std::move(original)),
+                                                                           preciseClocks(preciseClocks),
                                                                            neighbors(makeNeighbors(this->original,
                                                                                                    this->preciseClocks)),
                                                                            clockSize(
@@ -254,10 +239,8 @@ namespace learnta {
 
     NeighborConditions(ForwardRegionalElementaryLanguage original,
                        const std::vector<ClockVariables> &preciseClocks) : original(std::move(original)),
-                                                                           preciseClocks(
-                                                                                   std::unordered_set<ClockVariables>(
-                                                                                           preciseClocks.begin(),
-                                                                                           preciseClocks.end())),
+                                                                           preciseClocks(preciseClocks.begin(),
+                                                                                         preciseClocks.end()),
                                                                            neighbors(makeNeighbors(this->original,
                                                                                                    this->preciseClocks)),
                                                                            clockSize(
@@ -364,7 +347,7 @@ namespace learnta {
       std::vector<ClockVariables> impreciseClockVec;
       impreciseClockVec.reserve(this->clockSize);
       for (std::size_t clock = 0; clock < this->clockSize; ++clock) {
-        if (this->preciseClocks.find(clock) == this->preciseClocks.end()) {
+        if (!this->preciseClocks.contains(clock)) {
           impreciseClockVec.push_back(clock);
         }
       }
@@ -425,21 +408,21 @@ namespace learnta {
 
     [[nodiscard]] ForwardRegionalElementaryLanguage constructOriginalAfterTransition(const Alphabet action,
                                                                                      const TATransition &transition) const {
-      BOOST_LOG_TRIVIAL(debug) << "original before transition: " << this->original;
+      LEARNTA_LOG(debug) << "original before transition: " << this->original;
       if (isInternal(transition)) {
-        BOOST_LOG_TRIVIAL(debug) << "original after transition: " << this->original.successor(action);
+        LEARNTA_LOG(debug) << "original after transition: " << this->original.successor(action);
         return this->original.successor(action);
       } else {
         // make words
-        std::string newWord = this->original.getWord();
+        Word newWord = this->original.getWord();
         const auto targetClockSize = computeTargetClockSize(transition);
         assert(targetClockSize > 0);
         newWord.resize(targetClockSize - 1, this->original.getWord().back());
 
-        BOOST_LOG_TRIVIAL(debug) << "newWord: " << newWord;
-        BOOST_LOG_TRIVIAL(debug) << "resetVars: " << transition.resetVars;
-        BOOST_LOG_TRIVIAL(debug) << "targetClockSize: " << targetClockSize;
-        BOOST_LOG_TRIVIAL(debug) << "original after transition: "
+        LEARNTA_LOG(debug) << "newWord: " << newWord;
+        LEARNTA_LOG(debug) << "resetVars: " << transition.resetVars;
+        LEARNTA_LOG(debug) << "targetClockSize: " << targetClockSize;
+        LEARNTA_LOG(debug) << "original after transition: "
                                  << this->original.applyResets(newWord, transition.resetVars, targetClockSize);
         return this->original.applyResets(newWord, transition.resetVars, targetClockSize);
       }
@@ -463,16 +446,7 @@ namespace learnta {
     }
 
     std::ostream &print(std::ostream &os) const {
-      os << this->original << " {";
-      bool initial = true;
-      for (const auto &preciseClock: preciseClocks) {
-        if (!initial) {
-          os << ", ";
-        }
-        os << "x" << static_cast<int>(preciseClock);
-        initial = false;
-      }
-      os << "} {";
+      os << this->original << " " << preciseClocks << " {";
       for (const auto &neighbor: neighbors) {
         os << "\n" << neighbor;
       }
@@ -493,9 +467,7 @@ namespace learnta {
     }
 
     [[nodiscard]] std::size_t hash_value() const {
-      return boost::hash_value(std::make_tuple(original,
-                                               std::vector<ClockVariables>{preciseClocks.begin(), preciseClocks.end()},
-                                               neighbors, clockSize));
+      return boost::hash_value(std::make_tuple(original, preciseClocks, neighbors, clockSize));
     }
   };
 
@@ -5,12 +5,18 @@
 
 #pragma once
 
+#include <chrono>
+#include <functional>
 #include <utility>
 #include <vector>
 #include <stack>
 #include <list>
 #include <queue>
 #include <unordered_map>
+#include <array>
+#include <climits>
+#include <limits>
+#include <type_traits>
 
 #include <boost/unordered_map.hpp>
 #include <boost/unordered_set.hpp>
@@ -29,11 +35,15 @@
 #include "counterexample_analyzer.hh"
 #include "neighbor_conditions.hh"
 #include "imprecise_clock_handler.hh"
+#include "thread_pool.hh"
+#include "serialization.hh"
+#include "instrumentation.hh"
+#include "logging.hh"
 
 #ifdef PRINT_REFINEMENT_INFO
 #define LOG_REFINEMENT_INFO BOOST_LOG_TRIVIAL(info)
 #else
-#define LOG_REFINEMENT_INFO BOOST_LOG_TRIVIAL(debug)
+#define LOG_REFINEMENT_INFO LEARNTA_LOG(debug)
 #endif
 
 namespace learnta {
@@ -50,34 +60,197 @@ namespace learnta {
     std::vector<std::vector<TimedCondition>> concatenations;
     // The indexes of prefixes in P
     std::unordered_set<std::size_t> pIndices;
-    // prefixes[first] and prefixes[second.first] are in the same equivalence class witnessed by second.second
-    // Maybe we should use vector instead
-    std::unordered_map<std::size_t, std::unordered_map<std::size_t, RenamingRelation>> closedRelation;
+    // prefixes[i] and prefixes[j] are in the same equivalence class witnessed by closedRelation.at(i).at(j)
+    std::vector<std::unordered_map<std::size_t, RenamingRelation>> closedRelation;
     // The table containing the symbolic membership
     std::vector<std::vector<TimedConditionSet>> table;
-    std::unordered_map<std::size_t, std::size_t> continuousSuccessors;
-    boost::unordered_map<std::pair<std::size_t, Alphabet>, std::size_t> discreteSuccessors;
-    // The pair of prefixes such that we know that they are distinguished
-    boost::unordered_set<std::pair<std::size_t, std::size_t>> distinguishedPrefix;
+    // The index of the continuous successor of prefixes[i], or noSuccessor if it is not in the table
+    std::vector<std::size_t> continuousSuccessors;
+    // The index of the discrete successor of prefixes[i] with alphabet[k] is at i * alphabet.size() + k
+    std::vector<std::size_t> discreteSuccessors;
+    // actionIndices.at(c) is the index of the action c, cast to unsigned, in alphabet. It only covers the codes
+    // up to the largest one in alphabet. See actionIndex.
+    std::vector<std::size_t> actionIndices;
+    // The pair of prefixes such that we know that they are distinguished. See triangularIndex for the layout.
+    std::vector<bool> distinguishedPrefix;
+    static constexpr std::size_t noSuccessor = std::numeric_limits<std::size_t>::max();
+    // The worker threads to fill the cells. This is nullptr if we fill the cells sequentially.
+    std::unique_ptr<ThreadPool> threadPool;
+    // If true, the cells of ext(P) are filled only when they are used
+    bool lazy;
+    // filledColumns.at(i) is the number of the filled cells of the i-th row. The filled cells are always leftmost.
+    std::vector<std::size_t> filledColumns;
+    // The number of the cells we filled so far
+    std::size_t numFilledCells = 0;
+    // rowFingerprints.at(i) is the fingerprint of the leftmost fingerprintColumns.at(i) cells of the i-th row
+    std::vector<std::size_t> rowFingerprints;
+    std::vector<std::size_t> fingerprintColumns;
+    /*
+     * The results of the previous checks that we can reuse until we add a suffix.
+     * - consistentPairs: the pairs of P such that consistent() found no inconsistency
+     * - timeSaturatedRows: the rows of P such that timeSaturate() confirmed the saturation
+     * - renameConsistentClean: if renameConsistent() found no inconsistency after the last update of P
+     * The rows in exteriorConsistentRows never become exterior-inconsistent because P only grows.
+     */
+    std::size_t checkedSuffixSize = 1;
+    boost::unordered_set<std::pair<std::size_t, std::size_t>> consistentPairs;
+    std::unordered_set<std::size_t> timeSaturatedRows;
+    std::unordered_set<std::size_t> exteriorConsistentRows;
+    bool renameConsistentClean = false;
+    // Called with the number of the cells and the seconds after filling a batch of cells if it is set
+    std::function<void(std::size_t, double)> cellsFilledCallback;
+    // How we search for the breakpoint of the counterexamples
+    CEXAnalysisMode cexAnalysisMode = CEXAnalysisMode::LINEAR;
+
+    /*!
+     * @brief Fill the given cells of the observation table
+     *
+     * The cells are independent of each other. Therefore, we fill them in parallel if we have worker threads. Since
+     * each cell is written to its own slot, the resulting table does not depend on the scheduling.
+     *
+     * @pre The rows of table and concatenations are already resized
+     */
+    void fillCells(const std::vector<std::pair<std::size_t, std::size_t>> &cells) {
+      const std::function<void(std::size_t)> fill = [&](std::size_t cellIndex) {
+        const auto [prefixIndex, suffixIndex] = cells.at(cellIndex);
+        const auto concatenation = prefixes.at(prefixIndex) + suffixes.at(suffixIndex);
+        table.at(prefixIndex).at(suffixIndex) = this->memOracle->query(concatenation);
+        concatenations.at(prefixIndex).at(suffixIndex) = concatenation.getTimedCondition();
+      };
+      if (cells.empty()) {
+        return;
+      }
+      numFilledCells += cells.size();
+      LEARNTA_COUNT("observation_table.cells_filled", cells.size());
+      LEARNTA_RECORD("observation_table.cells_per_fill", cells.size());
+      const auto startTime = cellsFilledCallback ? std::chrono::steady_clock::now()
+                                                 : std::chrono::steady_clock::time_point{};
+      if (threadPool) {
+        threadPool->parallelFor(cells.size(), fill);
+      } else {
+        for (std::size_t cellIndex = 0; cellIndex < cells.size(); ++cellIndex) {
+          fill(cellIndex);
+        }
+      }
+      if (cellsFilledCallback) {
+        cellsFilledCallback(cells.size(),
+                            std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+      }
+    }
 
     /*!
      * @brief Fill the observation table
      *
+     * In the lazy mode, we only fill the rows in P. The cells of ext(P) are filled on demand by ensureCells.
+     *
      * @post The observation table is filled
      */
     void refreshTable() {
+      LEARNTA_SCOPED_TIMER("observation_table.refresh_table");
+      if (checkedSuffixSize != suffixes.size()) {
+        // The previous checks are invalidated by the new suffixes
+        checkedSuffixSize = suffixes.size();
+        consistentPairs.clear();
+        timeSaturatedRows.clear();
+        renameConsistentClean = false;
+      }
       table.resize(prefixes.size());
       concatenations.resize(prefixes.size());
+      filledColumns.resize(prefixes.size(), 0);
+      closedRelation.resize(prefixes.size());
+      distinguishedPrefix.resize(triangularIndex(prefixes.size(), 0), false);
+      std::vector<std::pair<std::size_t, std::size_t>> newCells;
       for (std::size_t prefixIndex = 0; prefixIndex < prefixes.size(); ++prefixIndex) {
-        const auto originalSize = table.at(prefixIndex).size();
         table.at(prefixIndex).resize(suffixes.size());
         concatenations.at(prefixIndex).resize(suffixes.size());
-        for (auto suffixIndex = originalSize; suffixIndex < suffixes.size(); ++suffixIndex) {
-          const auto concatenation = prefixes.at(prefixIndex) + suffixes.at(suffixIndex);
-          table.at(prefixIndex).at(suffixIndex) = this->memOracle->query(concatenation);
-          concatenations.at(prefixIndex).at(suffixIndex) = concatenation.getTimedCondition();
+        if (lazy && !this->inP(prefixIndex)) {
+          continue;
         }
+        for (auto suffixIndex = filledColumns.at(prefixIndex); suffixIndex < suffixes.size(); ++suffixIndex) {
+          newCells.emplace_back(prefixIndex, suffixIndex);
+        }
+        filledColumns.at(prefixIndex) = suffixes.size();
       }
+      fillCells(newCells);
+    }
+
+    /*!
+     * @brief Fill the leftmost cells of the given rows if they are not filled yet
+     *
+     * @post The leftmost size cells of the rows are filled
+     */
+    void ensureCells(std::initializer_list<std::size_t> rowIndices, const std::size_t size) {
+      std::vector<std::pair<std::size_t, std::size_t>> newCells;
+      for (const std::size_t prefixIndex: rowIndices) {
+        for (auto suffixIndex = filledColumns.at(prefixIndex); suffixIndex < size; ++suffixIndex) {
+          newCells.emplace_back(prefixIndex, suffixIndex);
+        }
+        filledColumns.at(prefixIndex) = std::max(filledColumns.at(prefixIndex), size);
+      }
+      fillCells(newCells);
+    }
+
+    /*!
+     * @brief Returns the i-th row of the observation table after filling it
+     */
+    const std::vector<TimedConditionSet> &row(const std::size_t i) {
+      ensureCells({i}, suffixes.size());
+      return this->table.at(i);
+    }
+
+    /*!
+     * @brief Returns the concatenations of the i-th prefix and the suffixes after filling the i-th row
+     */
+    const std::vector<TimedCondition> &rowConcatenations(const std::size_t i) {
+      ensureCells({i}, suffixes.size());
+      return this->concatenations.at(i);
+    }
+
+    //! @brief If all the cells of the i-th row are filled
+    [[nodiscard]] bool filled(const std::size_t i) const {
+      return filledColumns.at(i) == suffixes.size();
+    }
+
+    /*!
+     * @brief Returns if the i-th and j-th rows have a cell with different status
+     *
+     * We fill the cells from left to right and stop at the first cell with different status. Since such rows are never
+     * equivalent, this allows us to distinguish rows without filling the remaining cells.
+     */
+    bool statusDistinguished(const std::size_t i, const std::size_t j) {
+      for (std::size_t suffixIndex = 0; suffixIndex < suffixes.size(); ++suffixIndex) {
+        ensureCells({i, j}, suffixIndex + 1);
+        if (decideStatus(this->concatenations.at(i).at(suffixIndex), this->table.at(i).at(suffixIndex)) !=
+            decideStatus(this->concatenations.at(j).at(suffixIndex), this->table.at(j).at(suffixIndex))) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    //! @brief The index of the action in alphabet
+    [[nodiscard]] std::size_t actionIndex(const Alphabet action) const {
+      // We use all the range of Alphabet, including the negative values of char
+      return actionIndices.at(static_cast<std::make_unsigned_t<Alphabet>>(action));
+    }
+
+    /*!
+     * @brief Returns the index of the discrete successor of prefixes[i] with action
+     */
+    [[nodiscard]] std::size_t discreteSuccessor(const std::size_t i, const Alphabet action) const {
+      return this->discreteSuccessors.at(i * alphabet.size() + actionIndex(action));
+    }
+
+    /*!
+     * @brief The index of the unordered pair {i, j} in distinguishedPrefix
+     *
+     * We store the pairs in a lower triangular layout so that adding prefixes only appends the new pairs.
+     */
+    static std::size_t triangularIndex(std::size_t i, std::size_t j) {
+      if (i < j) {
+        std::swap(i, j);
+      }
+      return i * (i + 1) / 2 + j;
     }
 
     /*!
@@ -97,13 +270,17 @@ namespace learnta {
       // The index should be in a valid range
       assert(index < prefixes.size());
       pIndices.insert(index);
+      renameConsistentClean = false;
       // Add successors to the prefixes
-      prefixes.reserve(prefixes.size() + alphabet.size() + 1);
+      const auto newSize = prefixes.size() + alphabet.size() + 1;
+      prefixes.reserve(newSize);
+      continuousSuccessors.resize(newSize, noSuccessor);
+      discreteSuccessors.resize(newSize * alphabet.size(), noSuccessor);
       for (Alphabet c: alphabet) {
-        discreteSuccessors[std::make_pair(index, c)] = prefixes.size();
+        discreteSuccessors.at(index * alphabet.size() + actionIndex(c)) = prefixes.size();
         prefixes.emplace_back(prefixes.at(index).successor(c));
       }
-      continuousSuccessors[index] = prefixes.size();
+      continuousSuccessors.at(index) = prefixes.size();
       prefixes.emplace_back(prefixes.at(index).successor());
       // fill the observation table
       refreshTable();
@@ -111,11 +288,11 @@ namespace learnta {
       assert(this->inP(index));
       // the discrete successors of prefixes.at(index) should be in ext(P)
       assert(std::all_of(alphabet.begin(), alphabet.end(), [&](Alphabet c) {
-        return 0 <= discreteSuccessors.at(std::make_pair(index, c)) &&
-               discreteSuccessors.at(std::make_pair(index, c)) < prefixes.size();
+        return 0 <= this->discreteSuccessor(index, c) &&
+               this->discreteSuccessor(index, c) < prefixes.size();
       }));
       assert(std::all_of(alphabet.begin(), alphabet.end(), [&](Alphabet c) {
-        return !this->inP(discreteSuccessors.at(std::make_pair(index, c)));
+        return !this->inP(this->discreteSuccessor(index, c));
       }));
       // the continuous successor of prefixes.at(index) should be in ext(P)
       assert(continuousSuccessors.at(index) < prefixes.size());
@@ -126,34 +303,81 @@ namespace learnta {
       }
     }
 
+    /*!
+     * @brief Returns the fingerprint of the i-th row
+     *
+     * The fingerprint is the hash of the status (bottom, top, or middle) of each cell. Since
+     * findDeterministicEquivalentRenaming never finds a renaming for rows with different statuses, the rows with
+     * different fingerprints are not equivalent. We do not include the untimed word or the number of the clocks because
+     * the prefixes of different lengths can be equivalent.
+     *
+     * @note We update the fingerprint incrementally when we add suffixes.
+     * @note This fills the whole row. In the lazy mode, we use it only for the filled rows. See mayBeEquivalent.
+     */
+    std::size_t fingerprint(const std::size_t i) {
+      rowFingerprints.resize(prefixes.size(), 0);
+      fingerprintColumns.resize(prefixes.size(), 0);
+      if (fingerprintColumns.at(i) < suffixes.size()) {
+        const auto &cells = this->row(i);
+        const auto &cellConcatenations = this->rowConcatenations(i);
+        for (auto suffixIndex = fingerprintColumns.at(i); suffixIndex < suffixes.size(); ++suffixIndex) {
+          boost::hash_combine(rowFingerprints.at(i),
+                              static_cast<int>(decideStatus(cellConcatenations.at(suffixIndex), cells.at(suffixIndex))));
+        }
+        fingerprintColumns.at(i) = suffixes.size();
+      }
+      return rowFingerprints.at(i);
+    }
+
+    /*!
+     * @brief Returns false if we know that the i-th and j-th rows are not equivalent without the renaming search
+     *
+     * The memoized renaming relation may witness the equivalence even if the fingerprints are different. Therefore, we
+     * do not use the fingerprints for such pairs. In the lazy mode, we do not fingerprint partially filled rows because
+     * it fills them. Such rows are compared by statusDistinguished in equivalentWithMemo instead.
+     */
+    bool mayBeEquivalent(const std::size_t i, const std::size_t j) {
+      if (this->closedRelation.at(i).find(j) != this->closedRelation.at(i).end()) {
+        return true;
+      }
+      if (!filled(i) || !filled(j)) {
+        return true;
+      }
+      return fingerprint(i) == fingerprint(j);
+    }
+
     std::optional<RenamingRelation> equivalent(std::size_t i, std::size_t j) {
-      auto renamingRelation = findDeterministicEquivalentRenaming(this->prefixes.at(i), this->table.at(i), this->concatenations.at(i),
-                                                                  this->prefixes.at(j), this->table.at(j), this->concatenations.at(j),
+      LEARNTA_COUNT("observation_table.equivalence_checks", 1);
+      auto renamingRelation = findDeterministicEquivalentRenaming(this->prefixes.at(i), this->row(i), this->rowConcatenations(i),
+                                                                  this->prefixes.at(j), this->row(j), this->rowConcatenations(j),
                                                                   this->suffixes);
       if (renamingRelation) {
-        this->closedRelation[i][j] = renamingRelation.value();
+        this->closedRelation.at(i)[j] = renamingRelation.value();
         return renamingRelation;
       } else {
-        this->distinguishedPrefix.insert(std::make_pair(i, j));
+        this->distinguishedPrefix.at(triangularIndex(i, j)) = true;
         return std::nullopt;
       }
     }
 
     std::optional<RenamingRelation> equivalentWithMemo(std::size_t i, std::size_t j) {
 #if 1
-      if (this->distinguishedPrefix.find(std::make_pair(i, j)) != this->distinguishedPrefix.end() ||
-          this->distinguishedPrefix.find(std::make_pair(j, i)) != this->distinguishedPrefix.end()) {
+      if (this->distinguishedPrefix.at(triangularIndex(i, j))) {
         // we already know that they are not equivalent
         assert(!this->equivalent(i, j));
         return std::nullopt;
       }
 #endif
-      auto equivalentPrefixesIT = this->closedRelation.find(i);
-      if (equivalentPrefixesIT != this->closedRelation.end()) {
-        auto it = equivalentPrefixesIT->second.find(j);
+      // In the lazy mode, we fill the whole rows only if their statuses are the same
+      if (lazy && statusDistinguished(i, j)) {
+        this->distinguishedPrefix.at(triangularIndex(i, j)) = true;
+        return std::nullopt;
+      }
+      {
+        auto it = this->closedRelation.at(i).find(j);
         if (it != this->closedRelation.at(i).end()) {
-          if (equivalence(this->prefixes.at(i), this->table.at(i), this->concatenations.at(i),
-                          this->prefixes.at(j), this->table.at(j), this->concatenations.at(j),
+          if (equivalence(this->prefixes.at(i), this->row(i), this->rowConcatenations(i),
+                          this->prefixes.at(j), this->row(j), this->rowConcatenations(j),
                           this->suffixes, it->second)) {
             return it->second;
           }
@@ -178,25 +402,23 @@ namespace learnta {
       }
       // Then, we try the known renaming relations
       {
-        auto equivalentPrefixesIT = this->closedRelation.find(i);
-        if (equivalentPrefixesIT != this->closedRelation.end()) {
-          auto it = equivalentPrefixesIT->second.find(j);
-          if (it != this->closedRelation.at(i).end()) {
-            if (equivalent(i, j, newSuffix, it->second)) {
-              equivalentWithColumnCache[key] = std::make_pair(this->suffixes.size(), true);
-              return true;
-            }
+        auto it = this->closedRelation.at(i).find(j);
+        if (it != this->closedRelation.at(i).end()) {
+          if (equivalent(i, j, newSuffix, it->second)) {
+            equivalentWithColumnCache[key] = std::make_pair(this->suffixes.size(), true);
+            return true;
           }
         }
       }
       // Finally, we try to find an equivalent renaming
-      auto leftRow = this->table.at(i);
-      auto leftConcatenations = this->concatenations.at(i);
+      LEARNTA_COUNT("observation_table.equivalence_checks", 1);
+      auto leftRow = this->row(i);
+      auto leftConcatenations = this->rowConcatenations(i);
       const auto newLeftConcatenation = prefixes.at(i) + newSuffix;
       leftRow.emplace_back(this->memOracle->query(newLeftConcatenation));
       leftConcatenations.emplace_back(newLeftConcatenation.getTimedCondition());
-      auto rightRow = this->table.at(j);
-      auto rightConcatenations = this->concatenations.at(j);
+      auto rightRow = this->row(j);
+      auto rightConcatenations = this->rowConcatenations(j);
       const auto newRightConcatenation = prefixes.at(j) + newSuffix;
       rightRow.emplace_back(this->memOracle->query(newRightConcatenation));
       rightConcatenations.emplace_back(newRightConcatenation.getTimedCondition());
@@ -214,16 +436,16 @@ namespace learnta {
      * @brief Check if the given renaming relation remains an evidence of the equivalence with a new suffix
      */
     [[nodiscard]] bool equivalent(std::size_t i, std::size_t j, const BackwardRegionalElementaryLanguage &newSuffix,
-                                  const RenamingRelation &renaming) const {
+                                  const RenamingRelation &renaming) {
       const auto leftPrefix = this->prefixes.at(i);
-      auto leftRow = this->table.at(i);
-      auto leftConcatenation = this->concatenations.at(i);
+      auto leftRow = this->row(i);
+      auto leftConcatenation = this->rowConcatenations(i);
       auto newLeftConcatenation = prefixes.at(i) + newSuffix;
       leftRow.emplace_back(this->memOracle->query(newLeftConcatenation));
       leftConcatenation.emplace_back(newLeftConcatenation.getTimedCondition());
       const auto rightPrefix = this->prefixes.at(j);
-      auto rightRow = this->table.at(j);
-      auto rightConcatenation = this->concatenations.at(j);
+      auto rightRow = this->row(j);
+      auto rightConcatenation = this->rowConcatenations(j);
       auto newRightConcatenation = prefixes.at(j) + newSuffix;
       rightRow.emplace_back(this->memOracle->query(newRightConcatenation));
       rightConcatenation.emplace_back(newRightConcatenation.getTimedCondition());
@@ -259,7 +481,8 @@ namespace learnta {
     /*!
      * @brief Returns if row[i] is accepting or not
      */
-    [[nodiscard]] bool isMatch(std::size_t i) const {
+    [[nodiscard]] bool isMatch(std::size_t i) {
+      ensureCells({i}, 1);
       return !this->table.at(i).at(0).empty();
     }
 
@@ -274,14 +497,14 @@ namespace learnta {
      * @brief Returns if prefixes[i] has a discrete successor in the observation table
      */
     [[nodiscard]] bool hasDiscreteSuccessor(std::size_t i, Alphabet c) const {
-      return this->discreteSuccessors.find(std::make_pair(i, c)) != this->discreteSuccessors.end();
+      return i * alphabet.size() < this->discreteSuccessors.size() && this->discreteSuccessor(i, c) != noSuccessor;
     }
 
     /*!
      * @brief Returns if prefixes[i] has a continuous successor in the observation table
      */
     [[nodiscard]] bool hasContinuousSuccessor(std::size_t i) const {
-      return this->continuousSuccessors.find(i) != this->continuousSuccessors.end();
+      return i < this->continuousSuccessors.size() && this->continuousSuccessors.at(i) != noSuccessor;
     }
 
     /*!
@@ -297,12 +520,30 @@ namespace learnta {
   public:
     /*!
      * @brief Initialize the observation table
+     *
+     * @param numThreads The number of the threads to fill the table. If it is 0, we use all the hardware threads.
+     * @param lazy If true, the cells of ext(P) are filled only when they are used
      */
-    ObservationTable(std::vector<Alphabet> alphabet, std::unique_ptr<SymbolicMembershipOracle> memOracle) :
+    ObservationTable(std::vector<Alphabet> alphabet, std::unique_ptr<SymbolicMembershipOracle> memOracle,
+                     std::size_t numThreads = 1, bool lazy = false) :
             memOracle(std::move(memOracle)),
             alphabet(std::move(alphabet)),
             prefixes{ForwardRegionalElementaryLanguage{}},
-            suffixes{BackwardRegionalElementaryLanguage{}} {
+            suffixes{BackwardRegionalElementaryLanguage{}},
+            lazy(lazy) {
+      for (std::size_t k = 0; k < this->alphabet.size(); ++k) {
+        const std::size_t code = static_cast<std::make_unsigned_t<Alphabet>>(this->alphabet.at(k));
+        if (code >= actionIndices.size()) {
+          actionIndices.resize(code + 1);
+        }
+        actionIndices.at(code) = k;
+      }
+      if (numThreads != 1) {
+        threadPool = std::make_unique<ThreadPool>(numThreads);
+        if (threadPool->size() == 1) {
+          threadPool.reset();
+        }
+      }
       this->moveToP(0);
       this->refreshTable();
     }
@@ -315,35 +556,35 @@ namespace learnta {
      * @returns returns true if the observation table is already closed
      */
     bool close() {
+      LEARNTA_SCOPED_TIMER("observation_table.close");
+      // The rows in P bucketed by their fingerprints. The order in each bucket follows the order of pIndices.
+      std::unordered_map<std::size_t, std::vector<std::size_t>> pBuckets;
       for (std::size_t i = 0; i < this->prefixes.size(); i++) {
         // Skip if this prefix is in P
         if (this->inP(i)) {
           continue;
         }
-        auto prefix = this->prefixes.at(i);
-        auto prefixRow = this->table.at(i);
-
         // Use the memoized information for efficiency
         bool found = false;
         {
-          auto it = this->closedRelation.find(i);
-          if (it != closedRelation.end()) {
-            // When we already know that this prefix is equivalent to one of p \in P, we just confirm it.
-            for (auto targetIt = it->second.begin(); targetIt != it->second.end();) {
-              auto renamingRelation = targetIt->second;
-              if (equivalence(prefix, prefixRow, this->concatenations.at(i),
-                              this->prefixes.at(targetIt->first), this->table.at(targetIt->first),
-                              this->concatenations.at(targetIt->first),
-                              this->suffixes, renamingRelation)) {
-                if (this->inP(targetIt->first)) {
-                  found = true;
-                  break;
-                } else {
-                  ++targetIt;
-                }
+          auto &relation = this->closedRelation.at(i);
+          // When we already know that this prefix is equivalent to one of p \in P, we just confirm it.
+          for (auto targetIt = relation.begin(); targetIt != relation.end();) {
+            const auto &renamingRelation = targetIt->second;
+            // In the lazy mode, we fill the whole row only if the statuses of the target are the same
+            if (!(lazy && statusDistinguished(i, targetIt->first)) &&
+                equivalence(this->prefixes.at(i), this->row(i), this->rowConcatenations(i),
+                            this->prefixes.at(targetIt->first), this->row(targetIt->first),
+                            this->rowConcatenations(targetIt->first),
+                            this->suffixes, renamingRelation)) {
+              if (this->inP(targetIt->first)) {
+                found = true;
+                break;
               } else {
-                targetIt = it->second.erase(targetIt);
+                ++targetIt;
               }
+            } else {
+              targetIt = relation.erase(targetIt);
             }
           }
         }
@@ -352,12 +593,27 @@ namespace learnta {
         if (!found) {
           // First, we try to "jump" to the same state
           found = std::any_of(this->pIndices.begin(), this->pIndices.end(), [&](const auto j) {
-            return this->continuousSuccessors.at(j) == i && equivalentWithMemo(i, j);
+            return this->continuousSuccessors.at(j) == i && mayBeEquivalent(i, j) && equivalentWithMemo(i, j);
           });
-          if (!found) {
+          if (!found && lazy) {
+            // Fingerprinting fills the whole row. Instead, we compare the statuses cell by cell in equivalentWithMemo.
             found = std::any_of(this->pIndices.begin(), this->pIndices.end(), [&](const auto j) {
               return equivalentWithMemo(i, j);
             });
+          } else if (!found) {
+            // The memoized relations to P are already checked above. Thus, only the rows in the same bucket can be
+            // equivalent.
+            if (pBuckets.empty()) {
+              for (const auto j: this->pIndices) {
+                pBuckets[fingerprint(j)].push_back(j);
+              }
+            }
+            auto bucketIt = pBuckets.find(fingerprint(i));
+            if (bucketIt != pBuckets.end()) {
+              found = std::any_of(bucketIt->second.begin(), bucketIt->second.end(), [&](const auto j) {
+                return equivalentWithMemo(i, j);
+              });
+            }
           }
         }
         if (!found) {
@@ -380,7 +636,7 @@ namespace learnta {
       }));
       assert(std::all_of(this->pIndices.begin(), this->pIndices.end(), [&](const auto &pIndex) {
         return std::all_of(this->alphabet.begin(), this->alphabet.end(), [&](const auto &action) {
-          const auto successor = this->discreteSuccessors.at(std::make_pair(pIndex, action));
+          const auto successor = this->discreteSuccessor(pIndex, action);
           return successor < this->prefixes.size();
         });
       }));
@@ -402,7 +658,7 @@ namespace learnta {
       }));
       assert(std::all_of(this->pIndices.begin(), this->pIndices.end(), [&](const auto &pIndex) {
         return std::all_of(this->alphabet.begin(), this->alphabet.end(), [&](const auto &action) {
-          const auto successor = this->discreteSuccessors.at(std::make_pair(pIndex, action));
+          const auto successor = this->discreteSuccessor(pIndex, action);
           return this->inP(successor) || std::any_of(this->closedRelation.at(successor).begin(),
                                                      this->closedRelation.at(successor).end(),
                                                      [&](const std::pair<std::size_t, RenamingRelation> &rPair) {
@@ -496,7 +752,8 @@ namespace learnta {
 
       std::vector<SingleMorphism> morphisms;
       morphisms.reserve(this->closedRelation.size());
-      for (auto &[i, mapping]: this->closedRelation) {
+      for (std::size_t i = 0; i < this->closedRelation.size(); ++i) {
+        auto &mapping = this->closedRelation.at(i);
         if (!this->inP(i) && !mapping.empty()) {
           for (auto it = mapping.begin(); it != mapping.end();) {
             if (this->inP(it->first) && this->equivalentWithMemo(i, it->first)) {
@@ -520,16 +777,19 @@ namespace learnta {
      * @returns true if the observation table is already consistent
      */
     bool consistent() {
+      LEARNTA_SCOPED_TIMER("observation_table.consistent");
       for (const auto i: pIndices) {
         for (const auto j: pIndices) {
-          if (i <= j) {
+          if (i <= j || consistentPairs.find(std::make_pair(i, j)) != consistentPairs.end()) {
             continue;
           }
-          if (this->equivalentWithMemo(i, j)) {
+          if (this->mayBeEquivalent(i, j) && this->equivalentWithMemo(i, j)) {
             // Check the consistency
             for (const auto action: this->alphabet) {
-              if (!this->equivalentWithMemo(this->discreteSuccessors.at({i, action}),
-                                            this->discreteSuccessors.at({j, action}))) {
+              const auto iSuccessor = this->discreteSuccessor(i, action);
+              const auto jSuccessor = this->discreteSuccessor(j, action);
+              if (!this->mayBeEquivalent(iSuccessor, jSuccessor) ||
+                  !this->equivalentWithMemo(iSuccessor, jSuccessor)) {
                 LOG_REFINEMENT_INFO << "Observation table is inconsistent because of the discrete successors of "
                                          << this->prefixes.at(i) << " and " << this->prefixes.at(j)
                                          << " with action " << action;
@@ -537,13 +797,16 @@ namespace learnta {
                 return false;
               }
             }
-            if (!this->equivalentWithMemo(this->continuousSuccessors.at(i), this->continuousSuccessors.at(j))
+            const auto iSuccessor = this->continuousSuccessors.at(i);
+            const auto jSuccessor = this->continuousSuccessors.at(j);
+            if (!(this->mayBeEquivalent(iSuccessor, jSuccessor) && this->equivalentWithMemo(iSuccessor, jSuccessor))
                 && resolveContinuousInconsistency(i, j)) {
               LOG_REFINEMENT_INFO << "Observation table is inconsistent because of the continuous successors of "
                                        << this->prefixes.at(i) << " and " << this->prefixes.at(j);
               return false;
             }
           }
+          consistentPairs.emplace(i, j);
         }
       }
       return true;
@@ -555,16 +818,22 @@ namespace learnta {
      * @returns if the observation table is already exterior-consistent
      */
     bool exteriorConsistent() {
+      LEARNTA_SCOPED_TIMER("observation_table.exterior_consistent");
       std::vector<std::size_t> newP;
       newP.reserve(pIndices.size());
       for (const std::size_t pIndex: pIndices) {
+        if (exteriorConsistentRows.find(pIndex) != exteriorConsistentRows.end()) {
+          continue;
+        }
         const auto successorIndex = continuousSuccessors.at(pIndex);
         // Skip if p is not a boundary
         if (this->inP(successorIndex)) {
+          exteriorConsistentRows.insert(pIndex);
           continue;
         }
         // Skip if p has equality constraints in \f$\mathbb{T}_{i,N}\f$.
         if (prefixes.at(pIndex).hasEqualityN()) {
+          exteriorConsistentRows.insert(pIndex);
           continue;
         }
         LOG_REFINEMENT_INFO << "Observation table is exterior-inconsistent because of "
@@ -592,6 +861,7 @@ namespace learnta {
      * @returns If the observation table is already exterior-saturated
      */
     bool timeSaturate() {
+      LEARNTA_SCOPED_TIMER("observation_table.time_saturate");
       std::vector<std::size_t> newP;
       newP.reserve(pIndices.size());
       for (const std::size_t pIndex: pIndices) {
@@ -600,20 +870,28 @@ namespace learnta {
         if (this->inP(successorIndex)) {
           continue;
         }
+        if (timeSaturatedRows.find(pIndex) != timeSaturatedRows.end()) {
+          // We reuse the previous result unless the cache to jump to pIndex is modified
+          const auto &relation = this->closedRelation.at(successorIndex);
+          if (relation.size() == 1 && relation.begin()->first == pIndex && relation.begin()->second.empty()) {
+            continue;
+          }
+        }
         if (equivalentWithMemo(successorIndex, pIndex)) {
-          auto it = this->closedRelation.find(successorIndex);
-          assert(it != this->closedRelation.end());
-          auto it2 = it->second.find(pIndex);
-          assert(it2 != it->second.end());
+          auto &relation = this->closedRelation.at(successorIndex);
+          auto it2 = relation.find(pIndex);
+          assert(it2 != relation.end());
           if (it2->second.empty()) {
             // Modify the cache to jump to pIndex to construct a DTA without unobservable transitions
-            it->second = {*it2};
+            relation = {*it2};
+            timeSaturatedRows.insert(pIndex);
             continue;
-          } else if (equivalence(this->prefixes.at(successorIndex), this->table.at(successorIndex), this->concatenations.at(successorIndex),
-                                 this->prefixes.at(pIndex), this->table.at(pIndex), this->concatenations.at(pIndex),
+          } else if (equivalence(this->prefixes.at(successorIndex), this->row(successorIndex), this->rowConcatenations(successorIndex),
+                                 this->prefixes.at(pIndex), this->row(pIndex), this->rowConcatenations(pIndex),
                                  suffixes, RenamingRelation{})) {
-            it->second.clear();
-            it->second[pIndex] = RenamingRelation{};
+            relation.clear();
+            relation[pIndex] = RenamingRelation{};
+            timeSaturatedRows.insert(pIndex);
             continue;
           }
         }
@@ -635,7 +913,11 @@ namespace learnta {
     }
 
     bool renameConsistent() {
-      for (auto &[i, mapping]: this->closedRelation) {
+      if (renameConsistentClean) {
+        return true;
+      }
+      for (std::size_t i = 0; i < this->closedRelation.size(); ++i) {
+        auto &mapping = this->closedRelation.at(i);
         if (!this->inP(i) && !mapping.empty()) {
           for (auto it = mapping.begin(); it != mapping.end();) {
             if (this->inP(it->first) && this->equivalentWithMemo(i, it->first)) {
@@ -657,7 +939,7 @@ namespace learnta {
                   // Add the successors
                   toSearch.push(this->continuousSuccessors.at(currentIndex));
                   for (const auto action: this->alphabet) {
-                    toSearch.push(this->discreteSuccessors.at(std::make_pair(currentIndex, action)));
+                    toSearch.push(this->discreteSuccessor(currentIndex, action));
                   }
                 } else {
                   const auto currentLanguage = this->prefixes.at(currentIndex);
@@ -707,43 +989,120 @@ namespace learnta {
           }
         }
       }
+      renameConsistentClean = true;
       return true;
     }
 
+  private:
+    /*!
+     * @brief Add the prefixes of the counterexample to P until the table becomes not closed
+     *
+     * This is used when the counterexample analysis does not give any new suffix.
+     */
+    void addPrefixesOf(const TimedWord &cex) {
+      LOG_REFINEMENT_INFO << "Failed to find a new suffix. We add prefixes to P";
+      const auto newPrefixes = ForwardRegionalElementaryLanguage::fromTimedWord(cex).prefixes();
+      bool updated = false;
+      for (const auto &newPrefix: newPrefixes) {
+        auto it = std::find(this->prefixes.begin(), this->prefixes.end(), newPrefix);
+        assert(it != this->prefixes.end());
+        if (this->inP(std::distance(this->prefixes.begin(), it))) {
+          continue;
+        } else {
+          updated = true;
+          this->moveToP(std::distance(this->prefixes.begin(), it));
+          if (!this->close()) {
+            // The observation table is refined
+            return;
+          }
+        }
+      }
+      if (!updated) {
+        BOOST_LOG_TRIVIAL(error) << "Learning has got stuck!!";
+        abort();
+      }
+    }
+
+  public:
+    /*!
+     * @brief Set the function called after filling each batch of cells
+     *
+     * The function is called with the number of the filled cells and the seconds to fill them.
+     */
+    void setCellsFilledCallback(std::function<void(std::size_t, double)> callback) {
+      this->cellsFilledCallback = std::move(callback);
+    }
+
+    //! @brief The number of the prefixes in P
+    [[nodiscard]] std::size_t numP() const {
+      return this->pIndices.size();
+    }
+
+    //! @brief The number of the prefixes in P and ext(P)
+    [[nodiscard]] std::size_t numPrefixes() const {
+      return this->prefixes.size();
+    }
+
+    [[nodiscard]] std::size_t numSuffixes() const {
+      return this->suffixes.size();
+    }
+
+    //! @brief The number of the membership queries to the system under learning
+    [[nodiscard]] std::size_t numMembershipQueries() const {
+      return this->memOracle->count();
+    }
+
+    //! @brief Set how we search for the breakpoint of the counterexamples in handleCEX
+    void setCEXAnalysisMode(CEXAnalysisMode mode) {
+      this->cexAnalysisMode = mode;
+    }
+
     /*!
      * @brief Refine the suffixes by the given counterexample
      *
      */
     void handleCEX(const TimedWord &cex) {
-      auto newSuffixOpt = analyzeCEX(cex, *this->memOracle, this->toRecognizable(), this->suffixes);
+      auto newSuffixOpt = analyzeCEX(cex, *this->memOracle, this->toRecognizable(), this->suffixes, cexAnalysisMode);
       if (newSuffixOpt) {
         LOG_REFINEMENT_INFO << "New suffix " << *newSuffixOpt << " is added";
         auto newSuffix = BackwardRegionalElementaryLanguage::fromTimedWord(*newSuffixOpt);
         suffixes.emplace_back(std::move(newSuffix));
         this->refreshTable();
       } else {
-        LOG_REFINEMENT_INFO << "Failed to find a new suffix. We add prefixes to P";
-        const auto newPrefixes = ForwardRegionalElementaryLanguage::fromTimedWord(cex).prefixes();
-        bool updated = false;
-        for (const auto &newPrefix: newPrefixes) {
-          auto it = std::find(this->prefixes.begin(), this->prefixes.end(), newPrefix);
-          assert(it != this->prefixes.end());
-          if (this->inP(std::distance(this->prefixes.begin(), it))) {
-            continue;
-          } else {
-            updated = true;
-            this->moveToP(std::distance(this->prefixes.begin(), it));
-            if (!this->close()) {
-              // The observation table is refined
-              return;
-            }
-          }
-        }
-        if (!updated) {
-          BOOST_LOG_TRIVIAL(error) << "Learning has got stuck!!";
-          abort();
+        this->addPrefixesOf(cex);
+      }
+    }
+
+    /*!
+     * @brief Refine the suffixes by the given counterexamples of the same hypothesis
+     *
+     * We analyze all the counterexamples against the current hypothesis and add all the new suffixes before refreshing
+     * the table once. If none of them gives a new suffix, we add the prefixes of the first one to P as in handleCEX.
+     * The counterexamples not used here are still memorized by the equivalence oracle if it is EquivalenceOracleMemo.
+     *
+     * @pre counterExamples is not empty
+     */
+    void handleCEXs(const std::vector<TimedWord> &counterExamples) {
+      assert(!counterExamples.empty());
+      if (counterExamples.size() == 1) {
+        this->handleCEX(counterExamples.front());
+        return;
+      }
+      const auto hypothesis = this->toRecognizable();
+      const std::size_t oldSuffixSize = this->suffixes.size();
+      for (const auto &cex: counterExamples) {
+        // Since the new suffixes are also passed, we do not add the same suffix twice
+        auto newSuffixOpt = analyzeCEX(cex, *this->memOracle, hypothesis, this->suffixes, cexAnalysisMode);
+        if (newSuffixOpt) {
+          LOG_REFINEMENT_INFO << "New suffix " << *newSuffixOpt << " is added";
+          suffixes.push_back(BackwardRegionalElementaryLanguage::fromTimedWord(*newSuffixOpt));
         }
       }
+      if (this->suffixes.size() != oldSuffixSize) {
+        this->refreshTable();
+      } else {
+        this->addPrefixesOf(counterExamples.front());
+      }
     }
 
     /*!
@@ -761,10 +1120,10 @@ namespace learnta {
           if (this->inP(target) && !renaming.hasImpreciseClocks(this->prefixes.at(target).getTimedCondition())) {
             withPreciseMapping = true;
             if (std::make_pair(target, renaming) != std::make_pair(mapping.begin()->first, mapping.begin()->second)) {
-              BOOST_LOG_TRIVIAL(debug) << "Optimized the target: " << renaming;
-              BOOST_LOG_TRIVIAL(debug) << "Before: " << this->closedRelation.at(source).begin()->second;
+              LEARNTA_LOG(debug) << "Optimized the target: " << renaming;
+              LEARNTA_LOG(debug) << "Before: " << this->closedRelation.at(source).begin()->second;
               this->closedRelation.at(source) = {std::make_pair(target, renaming)};
-              BOOST_LOG_TRIVIAL(debug) << "After: " << this->closedRelation.at(source).begin()->second;
+              LEARNTA_LOG(debug) << "After: " << this->closedRelation.at(source).begin()->second;
             }
             break;
           }
@@ -775,14 +1134,14 @@ namespace learnta {
         for (const auto target: pIndices) {
           const auto renaming = this->equivalentWithMemo(source, target);
           if (renaming && !renaming->hasImpreciseClocks(this->prefixes.at(target).getTimedCondition())) {
-            BOOST_LOG_TRIVIAL(debug) << "Optimized the target: " << *renaming;
-            BOOST_LOG_TRIVIAL(debug) << "Before: " << this->closedRelation.at(source).begin()->second;
+            LEARNTA_LOG(debug) << "Optimized the target: " << *renaming;
+            LEARNTA_LOG(debug) << "Before: " << this->closedRelation.at(source).begin()->second;
             this->closedRelation.at(source) = {std::make_pair(target, *renaming)};
-            BOOST_LOG_TRIVIAL(debug) << "After: " << this->closedRelation.at(source).begin()->second;
+            LEARNTA_LOG(debug) << "After: " << this->closedRelation.at(source).begin()->second;
             break;
           }
         }
-        BOOST_LOG_TRIVIAL(debug) << "Failed to optimize the target";
+        LEARNTA_LOG(debug) << "Failed to optimize the target";
       }
     }
 
@@ -830,6 +1189,7 @@ namespace learnta {
      * @note We currently construct only the DTAs without unobservable transitions.
      */
     TimedAutomaton generateHypothesis() {
+      LEARNTA_SCOPED_TIMER("observation_table.generate_hypothesis");
       // this->optimizeTarget();
       StateManager stateManager;
       std::vector<std::shared_ptr<TAState>> states;
@@ -901,50 +1261,50 @@ namespace learnta {
           InternalTransitionMaker sourceMap;
           for (const auto &newStateIndex: newStateIndices) {
 #ifdef DEBUG
-            BOOST_LOG_TRIVIAL(trace) << "Start exploration of the discrete successor from the prefix "
+            LEARNTA_LOG(trace) << "Start exploration of the discrete successor from the prefix "
                                      << this->prefixes.at(newStateIndex) << " with action " << action;
 #endif
 
             // Skip if there is no discrete successor in the observation table
             if (!this->hasDiscreteSuccessor(newStateIndex, action)) {
 #ifdef DEBUG
-              BOOST_LOG_TRIVIAL(trace) << "No discrete successor";
+              LEARNTA_LOG(trace) << "No discrete successor";
 #endif
               continue;
             }
             // q' in the following diagram
-            const auto discrete = this->discreteSuccessors.at(std::make_pair(newStateIndex, action));
+            const auto discrete = this->discreteSuccessor(newStateIndex, action);
             // Add states only if the successor is also in P
             if (!this->inP(discrete)) {
 #ifdef DEBUG
-              BOOST_LOG_TRIVIAL(trace) << "The discrete successor is not in P";
+              LEARNTA_LOG(trace) << "The discrete successor is not in P";
 #endif
               discreteBoundaries.emplace_back(newStateIndex, action);
             } else {
 #ifdef DEBUG
-              BOOST_LOG_TRIVIAL(trace) << "The discrete successor is in P";
+              LEARNTA_LOG(trace) << "The discrete successor is in P";
 #endif
               if (stateManager.isNew(discrete)) {
 #ifdef DEBUG
-                BOOST_LOG_TRIVIAL(trace) << "The discrete successor is new";
+                LEARNTA_LOG(trace) << "The discrete successor is new";
 #endif
                 const auto successor = addState(discrete);
                 newStates.push(successor);
 #ifdef DEBUG
-                BOOST_LOG_TRIVIAL(trace) << "Generate discrete transitions from " << this->prefixes.at(newStateIndex)
+                LEARNTA_LOG(trace) << "Generate discrete transitions from " << this->prefixes.at(newStateIndex)
                                          << " with action " << action;
-                BOOST_LOG_TRIVIAL(trace) << "Source: " << stateManager.toState(newStateIndex);
-                BOOST_LOG_TRIVIAL(trace) << "Guard: " << this->prefixes.at(newStateIndex).getTimedCondition().toGuard();
-                BOOST_LOG_TRIVIAL(trace) << "Target: " << successor;
+                LEARNTA_LOG(trace) << "Source: " << stateManager.toState(newStateIndex);
+                LEARNTA_LOG(trace) << "Guard: " << this->prefixes.at(newStateIndex).getTimedCondition().toGuard();
+                LEARNTA_LOG(trace) << "Target: " << successor;
 #endif
                 sourceMap.add(successor, this->prefixes.at(newStateIndex).getTimedCondition());
 #ifdef DEBUG
-                BOOST_LOG_TRIVIAL(trace) << "The new state: " << successor.get();
+                LEARNTA_LOG(trace) << "The new state: " << successor.get();
 #endif
               }
               if (this->hasContinuousSuccessor(discrete)) {
 #ifdef DEBUG
-                BOOST_LOG_TRIVIAL(trace) << "The discrete successor has continuous successors";
+                LEARNTA_LOG(trace) << "The discrete successor has continuous successors";
 #endif
                 mergeContinuousSuccessors(discrete);
               }
@@ -967,7 +1327,7 @@ namespace learnta {
                                discreteBoundaries.end());
       for (const auto &[sourceIndex, action]: discreteBoundaries) {
 #ifdef DEBUG
-        BOOST_LOG_TRIVIAL(debug) << "Constructing a transition from: " << this->prefixes.at(sourceIndex)
+        LEARNTA_LOG(debug) << "Constructing a transition from: " << this->prefixes.at(sourceIndex)
                                  << " with action " << action;
 #endif
         ExternalTransitionMaker transitionMaker;
@@ -983,10 +1343,10 @@ namespace learnta {
           }
         };
         // The target state of the transitions, which should be in ext(P)
-        const auto targetIndex = this->discreteSuccessors.at(std::make_pair(sourceIndex, action));
+        const auto targetIndex = this->discreteSuccessor(sourceIndex, action);
         if (!stateManager.isNew(targetIndex)) {
 #ifdef DEBUG
-          BOOST_LOG_TRIVIAL(trace) << "The boundary is already handled: " << this->prefixes.at(sourceIndex) << " "
+          LEARNTA_LOG(trace) << "The boundary is already handled: " << this->prefixes.at(sourceIndex) << " "
                                    << action;
 #endif
           continue;
@@ -1003,10 +1363,10 @@ namespace learnta {
         // The renaming relation connecting targetIndex and jumpedTargetIndex
         RenamingRelation renamingRelation = it->second;
 #ifdef DEBUG
-        BOOST_LOG_TRIVIAL(debug) << "source: " << this->prefixes.at(sourceIndex);
-        BOOST_LOG_TRIVIAL(debug) << "action: " << action;
-        BOOST_LOG_TRIVIAL(debug) << "target: " << this->prefixes.at(jumpedTargetIndex);
-        BOOST_LOG_TRIVIAL(debug) << "renaming: " << renamingRelation;
+        LEARNTA_LOG(debug) << "source: " << this->prefixes.at(sourceIndex);
+        LEARNTA_LOG(debug) << "action: " << actionToString(action);
+        LEARNTA_LOG(debug) << "target: " << this->prefixes.at(jumpedTargetIndex);
+        LEARNTA_LOG(debug) << "renaming: " << renamingRelation;
 #endif
 
         // renamingRelation should not have the last variable on the left hand side.
@@ -1059,12 +1419,12 @@ namespace learnta {
                                              });
             assert(transitionIt != jumpedSourceState->next.at(action).end());
 #ifdef DEBUG
-            BOOST_LOG_TRIVIAL(debug) << "source: " << sourceState;
-            BOOST_LOG_TRIVIAL(debug) << "jumpedSource: " << jumpedSourceState;
-            BOOST_LOG_TRIVIAL(debug) << "target: " << transitionIt->target;
-            BOOST_LOG_TRIVIAL(debug) << "resetByContinuousExterior: " << resetByContinuousExterior;
-            BOOST_LOG_TRIVIAL(debug) << "resetByTransition: " << transitionIt->resetVars;
-            BOOST_LOG_TRIVIAL(debug) << "composition: "
+            LEARNTA_LOG(debug) << "source: " << sourceState;
+            LEARNTA_LOG(debug) << "jumpedSource: " << jumpedSourceState;
+            LEARNTA_LOG(debug) << "target: " << transitionIt->target;
+            LEARNTA_LOG(debug) << "resetByContinuousExterior: " << resetByContinuousExterior;
+            LEARNTA_LOG(debug) << "resetByTransition: " << transitionIt->resetVars;
+            LEARNTA_LOG(debug) << "composition: "
                                      << composition(transitionIt->resetVars, resetByContinuousExterior);
 #endif
             const auto newReset = composition(transitionIt->resetVars, resetByContinuousExterior);
@@ -1076,13 +1436,12 @@ namespace learnta {
                 renaming.emplace_back(std::make_pair(std::get<ClockVariables>(value), target));
               }
             }
-            if (this->inP(this->discreteSuccessors.at(std::make_pair(jumpedSourceIndex, action)))) {
+            if (this->inP(this->discreteSuccessor(jumpedSourceIndex, action))) {
               impreciseNeighbors.push(transitionIt->target, renaming,
-                                      this->prefixes.at(this->discreteSuccessors.at(std::make_pair(jumpedSourceIndex,
-                                                                                                   action))));
+                                      this->prefixes.at(this->discreteSuccessor(jumpedSourceIndex, action)));
             } else {
               const auto &map = this->closedRelation.at(
-                      this->discreteSuccessors.at(std::make_pair(jumpedSourceIndex, action)));
+                      this->discreteSuccessor(jumpedSourceIndex, action));
               for (const auto &[mappedIndex, relation]: map) {
                 if (this->inP(mappedIndex)) {
                   impreciseNeighbors.push(transitionIt->target, renaming, this->prefixes.at(mappedIndex));
@@ -1105,17 +1464,17 @@ namespace learnta {
         }
       }
 #ifdef DEBUG
-      BOOST_LOG_TRIVIAL(debug) << "as recognizable: " << this->toRecognizable();
+      LEARNTA_LOG(debug) << "as recognizable: " << this->toRecognizable();
       BOOST_LOG_TRIVIAL(info) << "Hypothesis before handling imprecise clocks\n" <<
                                TimedAutomaton{{states, {initialState}},
                                               TimedAutomaton::makeMaxConstants(states)}.simplify();
 #endif
       impreciseNeighbors.run();
 #ifdef DEBUG
-      BOOST_LOG_TRIVIAL(debug) << "Hypothesis after handling imprecise clocks\n" <<
+      LEARNTA_LOG(debug) << "Hypothesis after handling imprecise clocks\n" <<
                                TimedAutomaton{{states, {initialState}},
                                               TimedAutomaton::makeMaxConstants(states)}.simplify();
-      BOOST_LOG_TRIVIAL(debug) << "as recognizable: " << this->toRecognizable();
+      LEARNTA_LOG(debug) << "as recognizable: " << this->toRecognizable();
 #endif
       // Make the transitions deterministic
       std::vector<TAState *> needSplit;
@@ -1126,7 +1485,7 @@ namespace learnta {
         }
       }
 #ifdef DEBUG
-      BOOST_LOG_TRIVIAL(debug) << "Hypothesis before state splitting\n"
+      LEARNTA_LOG(debug) << "Hypothesis before state splitting\n"
                                << TimedAutomaton{{states, {initialState}},
                                                  TimedAutomaton::makeMaxConstants(states)}.simplify();
 #endif
@@ -1137,7 +1496,7 @@ namespace learnta {
         learnta::ObservationTable::splitStates(states, initialState, needSplit);
         BOOST_LOG_TRIVIAL(info) << "# of states after splitting: " << states.size();
 #ifdef DEBUG
-        BOOST_LOG_TRIVIAL(debug) << "Hypothesis after state splitting\n"
+        LEARNTA_LOG(debug) << "Hypothesis after state splitting\n"
                                  << TimedAutomaton{{states, {initialState}},
                                                    TimedAutomaton::makeMaxConstants(states)}.simplify();
 #endif
@@ -1187,7 +1546,7 @@ namespace learnta {
         state->mergeNondeterministicBranching();
       }
 #ifdef DEBUG
-      BOOST_LOG_TRIVIAL(debug) << "Hypothesis after making transitions deterministic\n" <<
+      LEARNTA_LOG(debug) << "Hypothesis after making transitions deterministic\n" <<
                                TimedAutomaton{{states, {initialState}},
                                               TimedAutomaton::makeMaxConstants(states)}.simplify();
 #endif
@@ -1220,6 +1579,67 @@ namespace learnta {
       return TimedAutomaton{{states, {initialState}}, TimedAutomaton::makeMaxConstants(states)}.simplify();
     }
 
+    /*!
+     * @brief Write the observation table and the cache of the membership oracle to a checkpoint
+     *
+     * We do not write the information we can recompute, e.g., the fingerprints and the results of the previous checks.
+     */
+    void save(std::ostream &os) const {
+      Serializer::writeTag(os, "ObservationTable");
+      Serializer::write(os, alphabet);
+      Serializer::write(os, prefixes);
+      Serializer::write(os, suffixes);
+      Serializer::write(os, concatenations);
+      Serializer::write(os, table);
+      Serializer::write(os, filledColumns);
+      Serializer::write(os, static_cast<std::uint64_t>(numFilledCells));
+      Serializer::write(os, pIndices);
+      Serializer::write(os, closedRelation);
+      Serializer::write(os, continuousSuccessors);
+      Serializer::write(os, discreteSuccessors);
+      Serializer::write(os, distinguishedPrefix);
+      this->memOracle->save(os);
+    }
+
+    /*!
+     * @brief Restore the observation table and the cache of the membership oracle from a checkpoint
+     *
+     * @pre The checkpoint is written by save of an observation table with the same alphabet
+     * @note The iteration order of P may differ from the original run. Thus, the learning after resuming may take a
+     * different path, though the result is still correct.
+     */
+    void load(std::istream &is) {
+      Serializer::readTag(is, "ObservationTable");
+      std::vector<Alphabet> savedAlphabet;
+      Serializer::read(is, savedAlphabet);
+      if (savedAlphabet != alphabet) {
+        throw std::runtime_error("The checkpoint is for a different alphabet");
+      }
+      Serializer::read(is, prefixes);
+      Serializer::read(is, suffixes);
+      Serializer::read(is, concatenations);
+      Serializer::read(is, table);
+      Serializer::read(is, filledColumns);
+      std::uint64_t savedFilledCells;
+      Serializer::read(is, savedFilledCells);
+      numFilledCells = savedFilledCells;
+      Serializer::read(is, pIndices);
+      Serializer::read(is, closedRelation);
+      Serializer::read(is, continuousSuccessors);
+      Serializer::read(is, discreteSuccessors);
+      Serializer::read(is, distinguishedPrefix);
+      this->memOracle->load(is);
+      // Drop the information derived from the previous table
+      rowFingerprints.clear();
+      fingerprintColumns.clear();
+      checkedSuffixSize = suffixes.size();
+      consistentPairs.clear();
+      timeSaturatedRows.clear();
+      exteriorConsistentRows.clear();
+      renameConsistentClean = false;
+      equivalentWithColumnCache.clear();
+    }
+
     std::ostream &printDetail(std::ostream &stream) const {
       printStatistics(stream);
       stream << "P is as follows\n";
@@ -1238,6 +1658,23 @@ namespace learnta {
       stream << "|P| = " << this->pIndices.size() << "\n";
       stream << "|ext(P)| = " << this->prefixes.size() - this->pIndices.size() << "\n";
       stream << "|S| = " << this->suffixes.size() << "\n";
+      stream << "Number of filled cells: " << this->numFilledCells << "\n";
+      stream << "Number of never filled cells: "
+             << this->prefixes.size() * this->suffixes.size() - this->numFilledCells << "\n";
+      // An estimation of the memory used by each row, i.e., the cells, the concatenations, and the successors
+      const auto conditionBytes = [](const TimedCondition &condition) {
+        return sizeof(TimedCondition) + (condition.size() + 1) * (condition.size() + 1) * sizeof(Bounds);
+      };
+      std::size_t tableBytes = (this->alphabet.size() + 1) * sizeof(std::size_t) * this->prefixes.size();
+      for (std::size_t i = 0; i < this->table.size(); ++i) {
+        for (std::size_t j = 0; j < this->table.at(i).size(); ++j) {
+          tableBytes += sizeof(TimedConditionSet) + conditionBytes(this->concatenations.at(i).at(j));
+          for (const auto &condition: this->table.at(i).at(j).getConditions()) {
+            tableBytes += conditionBytes(condition);
+          }
+        }
+      }
+      stream << "Memory per row: " << tableBytes / this->prefixes.size() << " [bytes]\n";
 
       return this->memOracle->printStatistics(stream);
     }
@@ -0,0 +1,381 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/04.
+ * @brief Persistent store of the results of membership queries shared between runs
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/unordered_map.hpp>
+
+#include "timed_word.hh"
+#include "membership_oracle.hh"
+
+namespace learnta {
+  /*!
+   * @brief Append-only file of the results of membership queries of an SUL
+   *
+   * The file consists of a header and a sequence of records. The header contains the identity of the SUL so that we
+   * do not mix up the results of different SULs. Each record is as follows, where the checksum is the FNV-1a hash of
+   * the payload.
+   *
+   * | uint32: payload size | uint32: checksum | payload: timed word and the verdict |
+   *
+   * The records are read through a read-only memory mapping and indexed by a hash map. The file can be shared by
+   * multiple processes: a record is appended by a single write under an exclusive flock, and the records appended by
+   * the other processes are read when we look up a timed word not in the index. If a process is killed in the middle
+   * of an append, the broken record at the end of the file is detected by the checksum and removed before the next
+   * append or when the file is opened next time. Each append is flushed to the disk by fdatasync before we release
+   * the lock.
+   *
+   * @note This class is not thread-safe. Use PersistentMembershipOracle from multiple threads.
+   */
+  class PersistentMembershipStore {
+  private:
+    // The stores with 8-bit and 16-bit actions are not compatible
+    static constexpr char magic[8] = {'L', 'T', 'A', 'M', 'Q', 'S', '0', sizeof(Alphabet) == 1 ? '1' : '2'};
+    static constexpr std::size_t recordHeaderSize = 2 * sizeof(std::uint32_t);
+    int fd = -1;
+    std::string path;
+    std::size_t headerSize;
+    // The offset of the end of the records already in the index
+    std::size_t indexedOffset;
+    boost::unordered_map<TimedWord, bool> index;
+
+    //! @brief RAII wrapper of flock
+    class FileLock {
+    private:
+      int fd;
+    public:
+      FileLock(int fd, int operation) : fd(fd) {
+        while (flock(fd, operation) != 0) {
+          if (errno != EINTR) {
+            throw std::runtime_error(std::string{"Failed to lock the membership store: "} + std::strerror(errno));
+          }
+        }
+      }
+
+      ~FileLock() {
+        flock(fd, LOCK_UN);
+      }
+    };
+
+    [[noreturn]] void fail(const std::string &message) const {
+      throw std::runtime_error(message + " " + path + ": " + std::strerror(errno));
+    }
+
+    static std::uint32_t checksum(const char *data, std::size_t size) {
+      std::uint32_t hash = 2166136261u;
+      for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+      }
+      return hash;
+    }
+
+    template<class T>
+    static void append(std::string &buffer, const T value) {
+      buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template<class T>
+    static bool take(const char *&data, const char *end, T &value) {
+      if (static_cast<std::size_t>(end - data) < sizeof(T)) {
+        return false;
+      }
+      std::memcpy(&value, data, sizeof(T));
+      data += sizeof(T);
+      return true;
+    }
+
+    static std::string encode(const TimedWord &word, bool verdict) {
+      std::string payload;
+      append(payload, static_cast<std::uint32_t>(word.wordSize()));
+      payload.append(reinterpret_cast<const char *>(word.getWord().data()), word.wordSize() * sizeof(Alphabet));
+      for (const double duration: word.getDurations()) {
+        append(payload, duration);
+      }
+      append(payload, static_cast<std::uint8_t>(verdict));
+
+      std::string record;
+      record.reserve(recordHeaderSize + payload.size());
+      append(record, static_cast<std::uint32_t>(payload.size()));
+      append(record, checksum(payload.data(), payload.size()));
+      record += payload;
+
+      return record;
+    }
+
+    static bool decode(const char *data, const char *end, TimedWord &word, bool &verdict) {
+      std::uint32_t wordSize;
+      if (!take(data, end, wordSize) || static_cast<std::size_t>(end - data) / sizeof(Alphabet) < wordSize) {
+        return false;
+      }
+      Word untimed(wordSize, Alphabet{});
+      std::memcpy(untimed.data(), data, wordSize * sizeof(Alphabet));
+      data += wordSize * sizeof(Alphabet);
+      std::vector<double> durations(wordSize + 1);
+      for (double &duration: durations) {
+        if (!take(data, end, duration)) {
+          return false;
+        }
+      }
+      std::uint8_t verdictByte;
+      if (!take(data, end, verdictByte) || data != end) {
+        return false;
+      }
+      word = TimedWord{untimed, durations};
+      verdict = verdictByte;
+
+      return true;
+    }
+
+    [[nodiscard]] std::size_t fileSize() const {
+      struct stat status{};
+      if (fstat(fd, &status) != 0) {
+        fail("Failed to stat the membership store");
+      }
+      return status.st_size;
+    }
+
+    /*!
+     * @brief Index the records from indexedOffset to the end of the file
+     *
+     * @returns The offset of the end of the valid records
+     * @pre The caller holds a lock of the file
+     */
+    std::size_t indexNewRecords() {
+      const std::size_t size = fileSize();
+      if (size <= indexedOffset) {
+        return indexedOffset;
+      }
+      // The offset of mmap must be aligned to the page size
+      const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+      const std::size_t mapOffset = indexedOffset / pageSize * pageSize;
+      const std::size_t mapSize = size - mapOffset;
+      void *mapped = mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(mapOffset));
+      if (mapped == MAP_FAILED) {
+        fail("Failed to map the membership store");
+      }
+      const char *begin = static_cast<const char *>(mapped) - mapOffset;
+      const char *end = begin + size;
+      const char *current = begin + indexedOffset;
+      while (current != end) {
+        std::uint32_t payloadSize, expectedChecksum;
+        const char *payload = current;
+        if (!take(payload, end, payloadSize) || !take(payload, end, expectedChecksum) ||
+            static_cast<std::size_t>(end - payload) < payloadSize ||
+            checksum(payload, payloadSize) != expectedChecksum) {
+          break;
+        }
+        TimedWord word;
+        bool verdict;
+        if (!decode(payload, payload + payloadSize, word, verdict)) {
+          break;
+        }
+        index.emplace(std::move(word), verdict);
+        current = payload + payloadSize;
+      }
+      indexedOffset = current - begin;
+      munmap(mapped, mapSize);
+
+      return indexedOffset;
+    }
+
+    /*!
+     * @brief Remove the broken record at the end of the file left by an interrupted append
+     *
+     * @pre The caller holds the exclusive lock of the file, and indexNewRecords is called under the lock
+     */
+    void removeBrokenTail() {
+      // Since the appends are done under the exclusive lock, the remaining bytes are from an interrupted append
+      if (indexedOffset < fileSize() && ftruncate(fd, static_cast<off_t>(indexedOffset)) != 0) {
+        fail("Failed to truncate the membership store");
+      }
+    }
+
+  public:
+    /*!
+     * @brief The default file name of the store of the SUL with the given identity
+     *
+     * We use the 64-bit FNV-1a hash of the identity so that the name does not depend on the platform or the version of
+     * the libraries and the separate runs share the store.
+     */
+    static std::string fileName(const std::string &identity) {
+      std::uint64_t hash = 14695981039346656037ull;
+      for (const char c: identity) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+      }
+      static constexpr char digits[] = "0123456789abcdef";
+      std::string name(16, '0');
+      for (auto it = name.rbegin(); it != name.rend(); ++it, hash >>= 4) {
+        *it = digits[hash & 0xf];
+      }
+
+      return name + ".mqs";
+    }
+
+    /*!
+     * @brief Open the store at the given path, which is created if it does not exist
+     *
+     * @param identity The string identifying the SUL. We throw std::runtime_error if the store was created for another SUL.
+     */
+    PersistentMembershipStore(std::string path, const std::string &identity) : path(std::move(path)) {
+      fd = open(this->path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+      if (fd < 0) {
+        fail("Failed to open the membership store");
+      }
+      std::string header{magic, sizeof(magic)};
+      append(header, static_cast<std::uint64_t>(identity.size()));
+      header += identity;
+      headerSize = header.size();
+      try {
+        FileLock lock{fd, LOCK_EX};
+        const std::size_t size = fileSize();
+        if (size == 0) {
+          if (write(fd, header.data(), header.size()) != static_cast<ssize_t>(header.size()) || fdatasync(fd) != 0) {
+            fail("Failed to initialize the membership store");
+          }
+        } else {
+          std::string actual(headerSize, '\0');
+          if (size < headerSize || pread(fd, actual.data(), headerSize, 0) != static_cast<ssize_t>(headerSize) ||
+              actual != header) {
+            throw std::runtime_error("The membership store " + this->path + " is broken or made for another SUL");
+          }
+        }
+        indexedOffset = headerSize;
+        indexNewRecords();
+        removeBrokenTail();
+      } catch (...) {
+        close(fd);
+        throw;
+      }
+    }
+
+    PersistentMembershipStore(const PersistentMembershipStore &) = delete;
+
+    PersistentMembershipStore &operator=(const PersistentMembershipStore &) = delete;
+
+    ~PersistentMembershipStore() {
+      close(fd);
+    }
+
+    /*!
+     * @brief Look up the verdict of the given timed word
+     *
+     * If it is not in the index, we also check the records appended by the other processes.
+     */
+    std::optional<bool> find(const TimedWord &word) {
+      auto it = index.find(word);
+      if (it == index.end()) {
+        FileLock lock{fd, LOCK_SH};
+        indexNewRecords();
+        it = index.find(word);
+        if (it == index.end()) {
+          return std::nullopt;
+        }
+      }
+      return it->second;
+    }
+
+    //! @brief Append the verdict of the given timed word
+    void insert(const TimedWord &word, bool verdict) {
+      const std::string record = encode(word, verdict);
+      FileLock lock{fd, LOCK_EX};
+      indexNewRecords();
+      if (index.find(word) != index.end()) {
+        // Another process has already stored it
+        return;
+      }
+      // Otherwise, the record is appended after the broken one and never read
+      removeBrokenTail();
+      if (write(fd, record.data(), record.size()) != static_cast<ssize_t>(record.size())) {
+        fail("Failed to append to the membership store");
+      }
+      if (fdatasync(fd) != 0) {
+        fail("Failed to flush the membership store");
+      }
+      index.emplace(word, verdict);
+      indexedOffset = fileSize();
+    }
+
+    //! @brief The number of the timed words in the index
+    [[nodiscard]] std::size_t size() const {
+      return index.size();
+    }
+  };
+
+  /*!
+   * @brief Wrapper of a membership oracle to store the results in a PersistentMembershipStore
+   *
+   * The wrapped oracle is called only for the timed words not answered in the current or the previous runs.
+   *
+   * @note This oracle is thread-safe if the wrapped oracle is thread-safe. The wrapped oracle is called without locking.
+   */
+  class PersistentMembershipOracle final : public MembershipOracle {
+  private:
+    std::unique_ptr<MembershipOracle> oracle;
+    PersistentMembershipStore store;
+    std::mutex storeMutex;
+    std::atomic<std::size_t> countStored{0};
+
+  public:
+    /*!
+     * @param path The path to the store
+     * @param identity The string identifying the SUL of the wrapped oracle
+     */
+    PersistentMembershipOracle(std::unique_ptr<MembershipOracle> &&oracle, std::string path,
+                               const std::string &identity) : oracle(std::move(oracle)),
+                                                              store(std::move(path), identity) {}
+
+    bool answerQuery(const TimedWord &timedWord) override {
+      {
+        std::lock_guard<std::mutex> lock{storeMutex};
+        if (const auto verdict = store.find(timedWord)) {
+          ++countStored;
+          return *verdict;
+        }
+      }
+      const bool result = this->oracle->answerQuery(timedWord);
+      std::lock_guard<std::mutex> lock{storeMutex};
+      store.insert(timedWord, result);
+
+      return result;
+    }
+
+    [[nodiscard]] std::size_t count() const override {
+      return this->oracle->count();
+    }
+
+    std::ostream &printStatistics(std::ostream &stream) const override {
+      stream << "Number of membership queries answered by the persistent store: " << countStored << "\n";
+      return this->oracle->printStatistics(stream);
+    }
+
+    void save(std::ostream &os) const override {
+      this->oracle->save(os);
+    }
+
+    void load(std::istream &is) override {
+      this->oracle->load(is);
+    }
+  };
+}
@@ -0,0 +1,256 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/15.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "timed_automaton.hh"
+#include "split_mix64.hh"
+
+namespace learnta {
+  //! @brief The parameters of the random timed automata
+  struct RandomTimedAutomatonParameters {
+    std::size_t numStates = 5;
+    std::size_t numClocks = 1;
+    std::size_t alphabetSize = 2;
+    //! @brief The maximum constant in the guards
+    int maxConstant = 5;
+    /*!
+     * @brief The probability that each integer in [1, maxConstant] splits the guards of each clock
+     *
+     * The guards of each state and action are the products of the intervals of the clocks. Therefore, the number of
+     * the transitions grows exponentially to the number of the clocks.
+     */
+    double guardDensity = 0.3;
+    //! @brief The probability that each clock is reset at each transition
+    double resetProbability = 0.3;
+    //! @brief The probability that each state is accepting
+    double acceptingProbability = 0.5;
+    //! @brief If false, each transition is removed with missingTransitionProbability
+    bool complete = true;
+    double missingTransitionProbability = 0.3;
+    //! @brief If false, we add a transition with an overlapping guard for each state and action
+    bool deterministic = true;
+    std::uint64_t seed = 0;
+  };
+
+  /*!
+   * @brief Generator of random timed automata to stress-test the learning
+   *
+   * The guards of the transitions from each state with each action partition the clock valuations. Thus, the generated
+   * timed automata are deterministic and complete unless we specify otherwise. Every state is reachable from the
+   * initial state in the graph of the transitions, although some transitions may not be enabled by any timed word.
+   *
+   * The result depends only on the parameters, including the seed. We do not use the distributions of the standard
+   * library because their implementations differ between the platforms.
+   */
+  class RandomTimedAutomatonGenerator {
+  private:
+    const RandomTimedAutomatonParameters parameters;
+    SplitMix64 engine;
+    static constexpr const char *actions = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+    //! @brief A uniformly random integer in [0, size)
+    std::size_t uniform(std::size_t size) {
+      return engine.uniformIndex(size);
+    }
+
+    bool bernoulli(double probability) {
+      return engine.uniformReal() < probability;
+    }
+
+    /*!
+     * @brief Make random intervals partitioning the value of the given clock
+     *
+     * @returns The constraints of each interval
+     */
+    std::vector<std::vector<Constraint>> partition(ClockVariables clock) {
+      std::vector<std::vector<Constraint>> intervals;
+      std::vector<Constraint> current;
+      for (int constant = 1; constant <= parameters.maxConstant; ++constant) {
+        if (!bernoulli(parameters.guardDensity)) {
+          continue;
+        }
+        switch (uniform(3)) {
+          case 0:
+            // ... x < c and c <= x ...
+            current.push_back(ConstraintMaker(clock) < constant);
+            intervals.push_back(std::move(current));
+            current = {ConstraintMaker(clock) >= constant};
+            break;
+          case 1:
+            // ... x <= c and c < x ...
+            current.push_back(ConstraintMaker(clock) <= constant);
+            intervals.push_back(std::move(current));
+            current = {ConstraintMaker(clock) > constant};
+            break;
+          default:
+            // ... x < c, x = c, and c < x ...
+            current.push_back(ConstraintMaker(clock) < constant);
+            intervals.push_back(std::move(current));
+            intervals.push_back({ConstraintMaker(clock) >= constant, ConstraintMaker(clock) <= constant});
+            current = {ConstraintMaker(clock) > constant};
+        }
+      }
+      intervals.push_back(std::move(current));
+
+      return intervals;
+    }
+
+    //! @brief Make the guards partitioning the clock valuations
+    std::vector<std::vector<Constraint>> makeGuards() {
+      std::vector<std::vector<Constraint>> guards{{}};
+      for (std::size_t clock = 0; clock < parameters.numClocks; ++clock) {
+        const auto intervals = partition(clock);
+        std::vector<std::vector<Constraint>> newGuards;
+        newGuards.reserve(guards.size() * intervals.size());
+        for (const auto &guard: guards) {
+          for (const auto &interval: intervals) {
+            newGuards.push_back(guard);
+            newGuards.back().insert(newGuards.back().end(), interval.begin(), interval.end());
+          }
+        }
+        guards = std::move(newGuards);
+      }
+
+      return guards;
+    }
+
+    TATransition::Resets makeResets() {
+      TATransition::Resets resets;
+      for (std::size_t clock = 0; clock < parameters.numClocks; ++clock) {
+        if (bernoulli(parameters.resetProbability)) {
+          resets.emplace_back(clock, 0.0);
+        }
+      }
+      return resets;
+    }
+
+    //! @brief Make a guard of a random interval, which overlaps with the guards made by makeGuards
+    std::vector<Constraint> makeOverlappingGuard() {
+      if (parameters.numClocks == 0) {
+        return {};
+      }
+      const auto clock = static_cast<ClockVariables>(uniform(parameters.numClocks));
+      const int lower = static_cast<int>(uniform(parameters.maxConstant + 1));
+      const int upper = lower + static_cast<int>(uniform(parameters.maxConstant - lower + 1));
+      return {ConstraintMaker(clock) >= lower, ConstraintMaker(clock) <= upper};
+    }
+
+  public:
+    /*!
+     * @throws std::invalid_argument if the parameters are out of range
+     */
+    explicit RandomTimedAutomatonGenerator(RandomTimedAutomatonParameters parameters) :
+            parameters(std::move(parameters)), engine(this->parameters.seed) {
+      const auto &p = this->parameters;
+      const std::size_t maxAlphabetSize = std::char_traits<char>::length(actions);
+      if (p.numStates == 0) {
+        throw std::invalid_argument("The number of the states must be positive");
+      }
+      if (p.numClocks > std::numeric_limits<ClockVariables>::max()) {
+        throw std::invalid_argument("Too many clocks: " + std::to_string(p.numClocks));
+      }
+      if (p.alphabetSize == 0 || p.alphabetSize > maxAlphabetSize) {
+        throw std::invalid_argument("The alphabet size must be in [1, " + std::to_string(maxAlphabetSize) + "]");
+      }
+      if (p.maxConstant < 0) {
+        throw std::invalid_argument("The maximum constant must be non-negative");
+      }
+      for (const double probability: {p.guardDensity, p.resetProbability, p.acceptingProbability,
+                                      p.missingTransitionProbability}) {
+        if (!(0 <= probability && probability <= 1)) {
+          throw std::invalid_argument("The probabilities must be in [0, 1]");
+        }
+      }
+    }
+
+    //! @brief The alphabet of the generated timed automata, i.e., the first alphabetSize of a-z, A-Z, and 0-9
+    [[nodiscard]] std::vector<Alphabet> alphabet() const {
+      return {actions, actions + parameters.alphabetSize};
+    }
+
+    /*!
+     * @brief Generate a random timed automaton
+     *
+     * Each call continues the random stream. Thus, the calls generate different timed automata.
+     */
+    TimedAutomaton generate() {
+      TimedAutomaton automaton;
+      automaton.states.reserve(parameters.numStates);
+      for (std::size_t i = 0; i < parameters.numStates; ++i) {
+        automaton.states.push_back(std::make_shared<TAState>(bernoulli(parameters.acceptingProbability)));
+      }
+      automaton.initialStates = {automaton.states.front()};
+      automaton.maxConstraints.assign(parameters.numClocks, parameters.maxConstant);
+
+      for (std::size_t source = 0; source < parameters.numStates; ++source) {
+        auto &state = automaton.states.at(source);
+        for (const Alphabet action: alphabet()) {
+          for (auto &guard: makeGuards()) {
+            if (!parameters.complete && bernoulli(parameters.missingTransitionProbability)) {
+              continue;
+            }
+            state->next[action].emplace_back(automaton.states.at(uniform(parameters.numStates)).get(), makeResets(),
+                                             std::move(guard));
+          }
+          if (!parameters.deterministic) {
+            state->next[action].emplace_back(automaton.states.at(uniform(parameters.numStates)).get(), makeResets(),
+                                             makeOverlappingGuard());
+          }
+        }
+      }
+
+      // Make the i-th state reachable by a transition from the j-th state (j < i). We fix such transitions so that they
+      // are not redirected later. Thus, by induction, the 0-th, ..., (i-1)-th states are reachable by the fixed ones.
+      std::unordered_set<const TATransition *> fixed;
+      std::vector<TATransition *> candidates;
+      for (std::size_t target = 1; target < parameters.numStates; ++target) {
+        TAState *targetState = automaton.states.at(target).get();
+        candidates.clear();
+        TATransition *reaching = nullptr;
+        for (std::size_t source = 0; source < target && !reaching; ++source) {
+          // We do not iterate over next directly because the order of unordered_map depends on the implementation
+          for (const Alphabet action: alphabet()) {
+            auto it = automaton.states.at(source)->next.find(action);
+            if (it == automaton.states.at(source)->next.end()) {
+              continue;
+            }
+            for (auto &transition: it->second) {
+              if (fixed.find(&transition) != fixed.end()) {
+                continue;
+              } else if (transition.target == targetState) {
+                reaching = &transition;
+                break;
+              }
+              candidates.push_back(&transition);
+            }
+            if (reaching) {
+              break;
+            }
+          }
+        }
+        if (!reaching && !candidates.empty()) {
+          reaching = candidates.at(uniform(candidates.size()));
+          reaching->target = targetState;
+        }
+        // If there is no candidate, which happens only for incomplete automata, the state may be unreachable
+        if (reaching) {
+          fixed.insert(reaching);
+        }
+      }
+
+      return automaton;
+    }
+  };
+}
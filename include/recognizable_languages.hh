@@ -10,6 +10,7 @@
 #include <ostream>
 #include "single_morphism.hh"
 #include "forward_regional_elementary_language.hh"
+#include "logging.hh"
 
 namespace learnta {
   /*!
@@ -64,7 +65,7 @@ namespace learnta {
       TimedWord suffix;
       SingleMorphism morphism;
       [[nodiscard]] TimedWord apply() const {
-        BOOST_LOG_TRIVIAL(debug) << "applying: " << *this;
+        LEARNTA_LOG(debug) << "applying: " << *this;
         return morphism.maps(prefix) + suffix;
       }
 
@@ -105,7 +106,7 @@ namespace learnta {
       }
       // When we do not have to split
       if (it->getDomain().contains(word)) {
-        return SplitTriple {word, TimedWord{"", {0}}, *it};
+        return SplitTriple {word, TimedWord{Word{}, {0}}, *it};
       }
       // Split word using the prefix
       auto prefixDomainTimedCondition = it->getDomain().getTimedCondition();
@@ -0,0 +1,386 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/03.
+ * @brief Binary serialization of the learning state for checkpointing
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+
+#include "zone.hh"
+#include "timed_word.hh"
+#include "timed_condition.hh"
+#include "timed_condition_set.hh"
+#include "fractional_order.hh"
+#include "elementary_language.hh"
+#include "forward_regional_elementary_language.hh"
+#include "backward_regional_elementary_language.hh"
+#include "renaming_relation.hh"
+
+namespace learnta {
+  /*!
+   * @brief Binary serializer of the data structures used in the learning
+   *
+   * The values are written in the native representation as a stream of bytes. We do not aim at the portability between
+   * platforms: the checkpoints are meant to be resumed by the same binary.
+   *
+   * @note Each write has the corresponding read. read throws std::runtime_error if the stream ends unexpectedly or a
+   * size does not fit in the rest of the stream, so that a broken checkpoint does not make a huge allocation.
+   */
+  class Serializer {
+  public:
+    // Arithmetic values
+    template<class T>
+    static std::enable_if_t<std::is_arithmetic_v<T>> write(std::ostream &os, const T value) {
+      os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template<class T>
+    static std::enable_if_t<std::is_arithmetic_v<T>> read(std::istream &is, T &value) {
+      is.read(reinterpret_cast<char *>(&value), sizeof(T));
+      check(is);
+    }
+
+    // Strings
+    static void write(std::ostream &os, const std::string &value) {
+      write(os, static_cast<std::uint64_t>(value.size()));
+      os.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    static void read(std::istream &is, std::string &value) {
+      value.resize(readSize(is));
+      is.read(value.data(), static_cast<std::streamsize>(value.size()));
+      check(is);
+    }
+
+#ifdef LEARNTA_WIDE_ALPHABET
+    // Untimed words of 16-bit actions
+    static void write(std::ostream &os, const Word &value) {
+      write(os, static_cast<std::uint64_t>(value.size()));
+      for (const Alphabet action: value) {
+        write(os, static_cast<std::uint16_t>(action));
+      }
+    }
+
+    static void read(std::istream &is, Word &value) {
+      value.resize(readSize(is, sizeof(std::uint16_t)));
+      for (Alphabet &action: value) {
+        std::uint16_t id;
+        read(is, id);
+        action = static_cast<Alphabet>(id);
+      }
+    }
+#endif
+
+    // Pairs
+    template<class T, class U>
+    static void write(std::ostream &os, const std::pair<T, U> &value) {
+      write(os, value.first);
+      write(os, value.second);
+    }
+
+    template<class T, class U>
+    static void read(std::istream &is, std::pair<T, U> &value) {
+      read(is, value.first);
+      read(is, value.second);
+    }
+
+    // Sequences
+    template<class T>
+    static void write(std::ostream &os, const std::vector<T> &values) {
+      writeSequence(os, values);
+    }
+
+    template<class T>
+    static void read(std::istream &is, std::vector<T> &values) {
+      readSequence(is, values);
+    }
+
+    template<class T>
+    static void write(std::ostream &os, const std::deque<T> &values) {
+      writeSequence(os, values);
+    }
+
+    template<class T>
+    static void read(std::istream &is, std::deque<T> &values) {
+      readSequence(is, values);
+    }
+
+    static void write(std::ostream &os, const std::vector<bool> &values) {
+      write(os, static_cast<std::uint64_t>(values.size()));
+      for (const bool value: values) {
+        write(os, static_cast<std::uint8_t>(value));
+      }
+    }
+
+    static void read(std::istream &is, std::vector<bool> &values) {
+      values.resize(readSize(is, sizeof(std::uint8_t)));
+      for (std::size_t i = 0; i < values.size(); ++i) {
+        std::uint8_t value;
+        read(is, value);
+        values[i] = value;
+      }
+    }
+
+    // Associative containers. The order of the elements is not preserved.
+    template<class T>
+    static void write(std::ostream &os, const std::unordered_set<T> &values) {
+      writeSequence(os, values);
+    }
+
+    template<class T>
+    static void read(std::istream &is, std::unordered_set<T> &values) {
+      values.clear();
+      const auto size = readSize(is);
+      for (std::size_t i = 0; i < size; ++i) {
+        T value;
+        read(is, value);
+        values.insert(std::move(value));
+      }
+    }
+
+    template<class Key, class Value>
+    static void write(std::ostream &os, const std::unordered_map<Key, Value> &values) {
+      writeSequence(os, values);
+    }
+
+    template<class Key, class Value>
+    static void read(std::istream &is, std::unordered_map<Key, Value> &values) {
+      readMap(is, values);
+    }
+
+    template<class Key, class Value>
+    static void write(std::ostream &os, const boost::unordered_map<Key, Value> &values) {
+      writeSequence(os, values);
+    }
+
+    template<class Key, class Value>
+    static void read(std::istream &is, boost::unordered_map<Key, Value> &values) {
+      readMap(is, values);
+    }
+
+    // Zones and timed conditions
+    static void write(std::ostream &os, const Zone &zone) {
+      write(os, static_cast<std::uint64_t>(zone.value.rows()));
+      write(os, static_cast<std::uint64_t>(zone.value.cols()));
+      for (Eigen::Index i = 0; i < zone.value.rows(); ++i) {
+        for (Eigen::Index j = 0; j < zone.value.cols(); ++j) {
+          write(os, zone.value(i, j));
+        }
+      }
+      write(os, zone.M);
+      write(os, zone.maxConstraints);
+    }
+
+    static void read(std::istream &is, Zone &zone) {
+      const auto rows = readSize(is);
+      const auto cols = readSize(is);
+      if (rows != 0) {
+        // Each bound is written as a double and a bool
+        checkSize(is, cols, rows * (sizeof(double) + sizeof(bool)));
+      }
+      zone.value.resize(static_cast<Eigen::Index>(rows), static_cast<Eigen::Index>(cols));
+      for (Eigen::Index i = 0; i < zone.value.rows(); ++i) {
+        for (Eigen::Index j = 0; j < zone.value.cols(); ++j) {
+          read(is, zone.value(i, j));
+        }
+      }
+      read(is, zone.M);
+      read(is, zone.maxConstraints);
+    }
+
+    static void write(std::ostream &os, const TimedCondition &condition) {
+      write(os, condition.zone);
+    }
+
+    static void read(std::istream &is, TimedCondition &condition) {
+      read(is, condition.zone);
+    }
+
+    static void write(std::ostream &os, const TimedConditionSet &conditions) {
+      write(os, conditions.getConditions());
+    }
+
+    static void read(std::istream &is, TimedConditionSet &conditions) {
+      read(is, conditions.conditions);
+    }
+
+    static void write(std::ostream &os, const FractionalOrder &order) {
+      write(os, order.order);
+      write(os, static_cast<std::uint64_t>(order.size));
+    }
+
+    static void read(std::istream &is, FractionalOrder &order) {
+      read(is, order.order);
+      std::uint64_t size;
+      read(is, size);
+      order.size = size;
+    }
+
+    // Timed words and elementary languages
+    static void write(std::ostream &os, const TimedWord &word) {
+      write(os, word.getWord());
+      write(os, word.getDurations());
+    }
+
+    static void read(std::istream &is, TimedWord &word) {
+      Word untimed;
+      std::vector<double> durations;
+      read(is, untimed);
+      read(is, durations);
+      if (untimed.size() + 1 != durations.size()) {
+        throw std::runtime_error("Broken timed word in the checkpoint");
+      }
+      word = TimedWord{untimed, durations};
+    }
+
+    static void write(std::ostream &os, const ElementaryLanguage &language) {
+      write(os, language.getWord());
+      write(os, language.getTimedCondition());
+    }
+
+    static void read(std::istream &is, ElementaryLanguage &language) {
+      Word word;
+      TimedCondition condition;
+      read(is, word);
+      read(is, condition);
+      language = ElementaryLanguage{std::move(word), std::move(condition)};
+    }
+
+    static void write(std::ostream &os, const ForwardRegionalElementaryLanguage &language) {
+      write(os, static_cast<const ElementaryLanguage &>(language));
+      write(os, language.getFractionalOrder());
+    }
+
+    static void read(std::istream &is, ForwardRegionalElementaryLanguage &language) {
+      ElementaryLanguage elementary;
+      FractionalOrder order;
+      read(is, elementary);
+      read(is, order);
+      language = ForwardRegionalElementaryLanguage{std::move(elementary), std::move(order)};
+    }
+
+    static void write(std::ostream &os, const BackwardRegionalElementaryLanguage &language) {
+      write(os, static_cast<const ElementaryLanguage &>(language));
+      write(os, language.getFractionalOrder());
+    }
+
+    static void read(std::istream &is, BackwardRegionalElementaryLanguage &language) {
+      ElementaryLanguage elementary;
+      FractionalOrder order;
+      read(is, elementary);
+      read(is, order);
+      language = BackwardRegionalElementaryLanguage{std::move(elementary), std::move(order)};
+    }
+
+    static void write(std::ostream &os, const RenamingRelation &renaming) {
+      writeSequence(os, renaming);
+    }
+
+    static void read(std::istream &is, RenamingRelation &renaming) {
+      readSequence(is, renaming);
+    }
+
+    //! @brief Write the header of a section to detect a broken or incompatible checkpoint
+    static void writeTag(std::ostream &os, const std::string &tag) {
+      write(os, tag);
+    }
+
+    //! @brief Read the header of a section and throw std::runtime_error if it is not the expected one
+    static void readTag(std::istream &is, const std::string &tag) {
+      std::string actual;
+      read(is, actual);
+      if (actual != tag) {
+        throw std::runtime_error("Unexpected section in the checkpoint: expected " + tag + " but found " + actual);
+      }
+    }
+
+  private:
+    static void check(const std::istream &is) {
+      if (!is) {
+        throw std::runtime_error("Unexpected end of the checkpoint");
+      }
+    }
+
+    /*!
+     * @brief The number of the bytes left in the stream, or the maximum value if the stream is not seekable
+     */
+    static std::uint64_t remaining(std::istream &is) {
+      const auto current = is.tellg();
+      if (current < 0) {
+        return std::numeric_limits<std::uint64_t>::max();
+      }
+      is.seekg(0, std::ios::end);
+      const auto end = is.tellg();
+      is.seekg(current);
+      check(is);
+      return end < current ? 0 : static_cast<std::uint64_t>(end - current);
+    }
+
+    /*!
+     * @brief Throw std::runtime_error if the given number of the elements cannot fit in the rest of the stream
+     *
+     * Every element takes at least elementSize bytes. We look at the rest of the stream only for large sizes because
+     * seeking discards the buffer of the stream.
+     */
+    static void checkSize(std::istream &is, std::uint64_t size, std::uint64_t elementSize) {
+      constexpr std::uint64_t smallBytes = 1 << 16;
+      if (size > smallBytes / elementSize && size > remaining(is) / elementSize) {
+        throw std::runtime_error("Broken size in the checkpoint: " + std::to_string(size));
+      }
+    }
+
+    //! @brief Read the number of the elements, each of which takes at least elementSize bytes
+    static std::size_t readSize(std::istream &is, std::uint64_t elementSize = 1) {
+      std::uint64_t size;
+      read(is, size);
+      checkSize(is, size, elementSize);
+      return size;
+    }
+
+    template<class Container>
+    static void writeSequence(std::ostream &os, const Container &values) {
+      write(os, static_cast<std::uint64_t>(values.size()));
+      for (const auto &value: values) {
+        write(os, value);
+      }
+    }
+
+    template<class Container>
+    static void readSequence(std::istream &is, Container &values) {
+      using Value = typename Container::value_type;
+      values.clear();
+      values.resize(readSize(is, std::is_arithmetic_v<Value> ? sizeof(Value) : 1));
+      for (auto &value: values) {
+        read(is, value);
+      }
+    }
+
+    template<class Map>
+    static void readMap(std::istream &is, Map &values) {
+      values.clear();
+      const auto size = readSize(is);
+      for (std::size_t i = 0; i < size; ++i) {
+        typename Map::key_type key;
+        typename Map::mapped_type value;
+        read(is, key);
+        read(is, value);
+        values.emplace(std::move(key), std::move(value));
+      }
+    }
+  };
+}
@@ -0,0 +1,54 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/05.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace learnta {
+  /*!
+   * @brief A counter-based pseudo random number generator (SplitMix64)
+   *
+   * The stream is determined only by the initial state. We use it to derive an independent stream for each test.
+   *
+   * @note Use uniformReal and uniformIndex instead of the distributions in the standard library. Their algorithms are
+   * implementation-defined, and the same seed may give different values on another platform.
+   */
+  class SplitMix64 {
+  private:
+    std::uint64_t state;
+  public:
+    using result_type = std::uint64_t;
+
+    explicit SplitMix64(std::uint64_t state) : state(state) {}
+
+    static constexpr result_type min() {
+      return std::numeric_limits<result_type>::min();
+    }
+
+    static constexpr result_type max() {
+      return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+      std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      return z ^ (z >> 31);
+    }
+
+    //! @brief A uniformly random real number in [0, 1) made of the upper 53 bits
+    double uniformReal() {
+      return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+    }
+
+    //! @brief A random integer in [0, size). The modulo bias is negligible for the small sizes we use.
+    std::size_t uniformIndex(std::size_t size) {
+      return (*this)() % size;
+    }
+  };
+}
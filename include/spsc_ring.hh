@@ -0,0 +1,68 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/12.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace learnta {
+  /*!
+   * @brief A bounded lock-free queue with a single producer thread and a single consumer thread
+   *
+   * Neither tryPush nor tryPop blocks. The producer owns tail and the consumer owns head. Each of them only reads the
+   * index of the other side, so we need no read-modify-write operations.
+   *
+   * @tparam Capacity The number of the slots. It must be a power of two.
+   */
+  template<class T, std::size_t Capacity>
+  class SPSCRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two");
+    std::array<T, Capacity> buffer{};
+    // The head and the tail are on different cache lines so that the two threads do not share them
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+  public:
+    /*!
+     * @brief Push an element. Only the producer thread may call this.
+     *
+     * @returns false if the ring is full. In this case, the element is not pushed.
+     */
+    bool tryPush(const T &value) {
+      const auto currentTail = tail.load(std::memory_order_relaxed);
+      if (currentTail - head.load(std::memory_order_acquire) == Capacity) {
+        return false;
+      }
+      buffer[currentTail & (Capacity - 1)] = value;
+      tail.store(currentTail + 1, std::memory_order_release);
+      return true;
+    }
+
+    /*!
+     * @brief Pop an element. Only the consumer thread may call this.
+     *
+     * @returns std::nullopt if the ring is empty
+     */
+    std::optional<T> tryPop() {
+      const auto currentHead = head.load(std::memory_order_relaxed);
+      if (currentHead == tail.load(std::memory_order_acquire)) {
+        return std::nullopt;
+      }
+      std::optional<T> result{buffer[currentHead & (Capacity - 1)]};
+      head.store(currentHead + 1, std::memory_order_release);
+      return result;
+    }
+
+    [[nodiscard]] bool empty() const {
+      return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity() {
+      return Capacity;
+    }
+  };
+}
@@ -7,6 +7,8 @@
 
 #include <cstdlib>
 
+#include "common_types.hh"
+
 namespace learnta {
   /*!
    * @brief Interface of the system under learning
@@ -25,7 +27,7 @@ namespace learnta {
     /*!
      * @brief Feed a discrete action
      */
-    virtual bool step(char action) = 0;
+    virtual bool step(Alphabet action) = 0;
     /*!
      * @brief Feed time elapse
      */
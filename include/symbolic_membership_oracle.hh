@@ -5,6 +5,10 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <mutex>
+
 #include "elementary_language.hh"
 #include "sul.hh"
 #include "membership_oracle.hh"
@@ -13,22 +17,56 @@
 namespace learnta {
   /*!
    * @brief The oracle to answer symbolic membership queries
+   *
+   * @note query is thread-safe. The cache is split into shards so that the threads rarely wait for each other.
    */
   class SymbolicMembershipOracle final : public MembershipOracle {
   private:
+    //! @brief The number of the shards of the cache
+    static constexpr std::size_t cacheShardSize = 64;
+    struct CacheShard {
+      mutable std::mutex mutex;
+      boost::unordered_map<ElementaryLanguage, TimedConditionSet> cache;
+    };
     std::unique_ptr<MembershipOracle> membershipOracle;
-    boost::unordered_map<ElementaryLanguage, TimedConditionSet> cache;
-    std::size_t countSymbolic = 0;
-    std::size_t countSymbolicWithCache = 0;
+    std::array<CacheShard, cacheShardSize> cacheShards;
+    std::atomic<std::size_t> countSymbolic{0};
+    std::atomic<std::size_t> countSymbolicWithCache{0};
 
     [[nodiscard]] bool included(const ElementaryLanguage &elementary) {
       return this->membershipOracle->answerQuery(elementary.sample());
     }
 
+    CacheShard &shard(const ElementaryLanguage &elementary) {
+      return cacheShards.at(hash_value(elementary) % cacheShardSize);
+    }
+
+    //! @brief Store the result to the cache and return it
+    TimedConditionSet store(const ElementaryLanguage &elementary, TimedConditionSet result) {
+      auto &cacheShard = shard(elementary);
+      std::lock_guard<std::mutex> lock{cacheShard.mutex};
+      cacheShard.cache[elementary] = result;
+      return result;
+    }
+
   public:
     explicit SymbolicMembershipOracle(std::unique_ptr<SUL>&& sul) : membershipOracle(
             std::make_unique<MembershipOracleCache>(std::make_unique<SULMembershipOracle>(std::move(sul)))) {}
 
+    /*!
+     * @brief Construct a symbolic membership oracle answering the concrete queries in parallel by a pool of SULs
+     *
+     * @pre suls is not empty and all the SULs behave in the same way
+     */
+    explicit SymbolicMembershipOracle(std::vector<std::unique_ptr<SUL>>&& suls) : membershipOracle(
+            std::make_unique<MembershipOracleCache>(std::make_unique<SULPoolMembershipOracle>(std::move(suls)))) {}
+
+    /*!
+     * @brief Construct a symbolic membership oracle answering the concrete queries by the given oracle
+     */
+    explicit SymbolicMembershipOracle(std::unique_ptr<MembershipOracle>&& oracle) : membershipOracle(
+            std::make_unique<MembershipOracleCache>(std::move(oracle))) {}
+
     /*!
      * @brief Make a symbolic membership query
      *
@@ -36,9 +74,13 @@ namespace learnta {
      */
     TimedConditionSet query(const ElementaryLanguage &elementary) {
       ++countSymbolic;
-      auto it = cache.find(elementary);
-      if (it != cache.end()) {
-        return it->second;
+      {
+        auto &cacheShard = shard(elementary);
+        std::lock_guard<std::mutex> lock{cacheShard.mutex};
+        auto it = cacheShard.cache.find(elementary);
+        if (it != cacheShard.cache.end()) {
+          return it->second;
+        }
       }
       ++countSymbolicWithCache;
       std::list<ElementaryLanguage> includedLanguages;
@@ -54,22 +96,18 @@ namespace learnta {
 
       // Simplify the result
       if (includedLanguages.empty()) {
-        cache[elementary] = TimedConditionSet::bottom();
-        return cache[elementary];
+        return store(elementary, TimedConditionSet::bottom());
       } else if (allIncluded) {
-        cache[elementary] = TimedConditionSet{elementary.getTimedCondition()};
-        return cache[elementary];
+        return store(elementary, TimedConditionSet{elementary.getTimedCondition()});
       } else {
         auto convexHull = ElementaryLanguage::convexHull(includedLanguages);
         // Check if the convex hull is the exact union.
         if (convexHull.enumerate().size() == includedLanguages.size()) {
           // When the convex hull is the exact union
-          cache[elementary] = TimedConditionSet{convexHull.getTimedCondition()};
-          return cache[elementary];
+          return store(elementary, TimedConditionSet{convexHull.getTimedCondition()});
         } else {
           // When the convex hull is an overapproximation
-          cache[elementary] = TimedConditionSet::reduce(std::move(includedLanguages));
-          return cache[elementary];
+          return store(elementary, TimedConditionSet::reduce(std::move(includedLanguages)));
         }
       }
     }
@@ -87,5 +125,36 @@ namespace learnta {
       stream << "Number of symbolic membership queries (with cache): " << countSymbolicWithCache << "\n";
       return this->membershipOracle->printStatistics(stream);
     }
+
+    //! @brief Write the cached symbolic and concrete membership to a checkpoint
+    void save(std::ostream &os) const override {
+      Serializer::writeTag(os, "SymbolicMembershipOracle");
+      Serializer::write(os, static_cast<std::uint64_t>(cacheShardSize));
+      for (const auto &cacheShard: cacheShards) {
+        std::lock_guard<std::mutex> lock{cacheShard.mutex};
+        Serializer::write(os, cacheShard.cache);
+      }
+      this->membershipOracle->save(os);
+    }
+
+    //! @brief Restore the cached symbolic and concrete membership from a checkpoint
+    void load(std::istream &is) override {
+      Serializer::readTag(is, "SymbolicMembershipOracle");
+      std::uint64_t numShards;
+      Serializer::read(is, numShards);
+      for (auto &cacheShard: cacheShards) {
+        std::lock_guard<std::mutex> lock{cacheShard.mutex};
+        cacheShard.cache.clear();
+      }
+      for (std::uint64_t i = 0; i < numShards; ++i) {
+        boost::unordered_map<ElementaryLanguage, TimedConditionSet> cache;
+        Serializer::read(is, cache);
+        // We re-distribute the entries because the number of the shards may be different
+        for (auto &[elementary, result]: cache) {
+          store(elementary, std::move(result));
+        }
+      }
+      this->membershipOracle->load(is);
+    }
   };
 }
\ No newline at end of file
@@ -17,6 +17,7 @@
 #include "zone.hh"
 #include "timed_automaton.hh"
 #include "zone_automaton_state.hh"
+#include "logging.hh"
 
 namespace std {
   inline static std::ostream& operator<<(std::ostream& stream, const std::vector<double> &valuation) {
@@ -43,14 +44,14 @@ namespace learnta {
     // A sequence of the visited zones without abstraction
     std::vector<Zone> tightZones;
     std::vector<learnta::TATransition> edges;
-    std::string word;
+    Word word;
   public:
     explicit SymbolicRun(const std::shared_ptr<ZAState> &initialState) : states({initialState}), edges() {
       tightZones = {this->states.front()->zone};
     }
 
     //! @brief Push a new edge and state in the end of the run
-    void push_back(const learnta::TATransition &transition, char action, const std::shared_ptr<ZAState> &state) {
+    void push_back(const learnta::TATransition &transition, Alphabet action, const std::shared_ptr<ZAState> &state) {
       assert(this->states.size() == this->tightZones.size());
       assert(this->states.size() - 1 == this->word.size());
       assert(this->word.size() == this->edges.size());
@@ -91,7 +92,7 @@ namespace learnta {
      * We note that our zone construction is state --time_elapse--> intermediate --discrete_jump--> next_state.
      */
     [[nodiscard]] std::optional<TimedWord> reconstructWord() const {
-      BOOST_LOG_TRIVIAL(trace) << "Started reconstructWord";
+      LEARNTA_LOG(trace) << "Started reconstructWord";
       // The zone after the jump (here, this is the last zone)
       auto postZone = this->tightZones.back();
       if (!postZone.isSatisfiable()) {
@@ -104,7 +105,7 @@ namespace learnta {
       std::list<double> durations;
 
       for (int i = N - 1; i >= 0; --i) {
-        BOOST_LOG_TRIVIAL(trace) << "postValuation: " << postValuation;
+        LEARNTA_LOG(trace) << "postValuation: " << postValuation;
         // The zone just after the previous jump
         auto preZone = this->tightZoneAt(i);
         preZone.canonize();
@@ -135,7 +136,7 @@ namespace learnta {
           tmpZoneBeforeJump &= preZone;
           if (!tmpZoneBeforeJump.isSatisfiable()) {
             // The word reconstruction may fail due to state mering
-            BOOST_LOG_TRIVIAL(debug) << "Failed to reconstruct word from a symbolic run\n" << *this;
+            LEARNTA_LOG(debug) << "Failed to reconstruct word from a symbolic run\n" << *this;
             return std::nullopt;
           }
           tmpZoneBeforeJump.elapse();
@@ -154,8 +155,8 @@ namespace learnta {
         if (preValuation.empty()) {
           durations.push_front(0);
         } else {
-          BOOST_LOG_TRIVIAL(trace) << "valuationBeforeJump: " << valuationBeforeJump;
-          BOOST_LOG_TRIVIAL(trace) << "preValuation: " << preValuation;
+          LEARNTA_LOG(trace) << "valuationBeforeJump: " << valuationBeforeJump;
+          LEARNTA_LOG(trace) << "preValuation: " << preValuation;
           durations.push_front(valuationBeforeJump.at(0) - preValuation.at(0));
         }
 
@@ -196,7 +197,7 @@ namespace learnta {
               valuation.at(resetVariable) = std::get<double>(targetVariable);
             }
           }
-          BOOST_LOG_TRIVIAL(trace) << "valuation: " << valuation;
+          LEARNTA_LOG(trace) << "valuation: " << valuation;
         } else {
           return false;
         }
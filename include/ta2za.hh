@@ -1,5 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <deque>
+#include <memory>
+
 #include "timed_automaton.hh"
 #include "zone_automaton.hh"
 #include "zone.hh"
@@ -12,6 +16,21 @@ namespace learnta {
 
   TA to ZA adds states with BFS. Initial configuration is the initial states of
   ZA. The ZA contain only the states reachable from initial states.
+
+  @param cancelled If it is given and becomes true, we stop the BFS. The resulting ZA is then a part of the complete one.
+  @param quickReturnMatches With quickReturn, we stop the BFS once we have this many accepting states of ZA.
+ */
+  void ta2za(const TimedAutomaton &TA, ZoneAutomaton &ZA, bool quickReturn = true,
+             const std::atomic<bool> *cancelled = nullptr, std::size_t quickReturnMatches = 1);
+
+/*!
+  @brief Continue the construction of a zone automaton from a part of it
+
+  We explore the states in frontier and the states reachable from them with the BFS of ta2za. The other states of ZA
+  must already have all of their outgoing transitions. A new zone is merged into an existing state including it.
+
+  @param frontier The states of ZA to explore in this order. Their outgoing transitions must be empty.
  */
-  void ta2za(const TimedAutomaton &TA, ZoneAutomaton &ZA, bool quickReturn = true);
+  void ta2zaFrom(ZoneAutomaton &ZA, std::deque<std::shared_ptr<ZAState>> frontier, bool quickReturn = false,
+                 const std::atomic<bool> *cancelled = nullptr, std::size_t quickReturnMatches = 1);
 }
\ No newline at end of file
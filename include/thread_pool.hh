@@ -0,0 +1,166 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/01.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace learnta {
+  /*!
+   * @brief A minimal pool of worker threads executing data-parallel loops
+   *
+   * The pool keeps its worker threads alive between the loops so that we can use it in the inner loop of the learning
+   * without paying the cost of thread creation. The calling thread also works on the loop.
+   *
+   * @note parallelFor is not reentrant. Namely, the given function must not call parallelFor of the same pool.
+   */
+  class ThreadPool {
+  private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable jobFinished;
+    // The current job
+    const std::function<void(std::size_t)> *job = nullptr;
+    std::size_t jobSize = 0;
+    std::atomic<std::size_t> nextIndex{0};
+    // The number of the workers currently working on the job
+    std::size_t activeWorkers = 0;
+    // Incremented whenever a new job is submitted
+    std::size_t generation = 0;
+    bool stopped = false;
+    std::exception_ptr exception;
+
+    /*!
+     * @brief Execute the current job until no index remains
+     */
+    void work(const std::function<void(std::size_t)> &function, const std::size_t size) {
+      for (std::size_t index = nextIndex++; index < size; index = nextIndex++) {
+        try {
+          function(index);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock{mutex};
+          if (!exception) {
+            exception = std::current_exception();
+          }
+          // Skip the remaining indices
+          nextIndex = size;
+        }
+      }
+    }
+
+    void workerLoop() {
+      std::size_t seenGeneration = 0;
+      while (true) {
+        const std::function<void(std::size_t)> *currentJob;
+        std::size_t currentSize;
+        {
+          std::unique_lock<std::mutex> lock{mutex};
+          jobAvailable.wait(lock, [&] {
+            return stopped || generation != seenGeneration;
+          });
+          if (stopped) {
+            return;
+          }
+          seenGeneration = generation;
+          if (!job) {
+            // The job has already been finished by the other threads
+            continue;
+          }
+          currentJob = job;
+          currentSize = jobSize;
+          ++activeWorkers;
+        }
+        work(*currentJob, currentSize);
+        {
+          std::lock_guard<std::mutex> lock{mutex};
+          --activeWorkers;
+        }
+        jobFinished.notify_all();
+      }
+    }
+
+  public:
+    /*!
+     * @param numThreads The number of the threads including the calling thread
+     */
+    explicit ThreadPool(std::size_t numThreads) {
+      if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+      }
+      workers.reserve(numThreads - 1);
+      for (std::size_t i = 0; i + 1 < numThreads; ++i) {
+        workers.emplace_back([this] {
+          this->workerLoop();
+        });
+      }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool() {
+      {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopped = true;
+      }
+      jobAvailable.notify_all();
+      for (auto &worker: workers) {
+        worker.join();
+      }
+    }
+
+    //! @brief Returns the number of the threads including the calling thread
+    [[nodiscard]] std::size_t size() const {
+      return workers.size() + 1;
+    }
+
+    /*!
+     * @brief Execute function(0), function(1), ..., function(size - 1) in parallel
+     *
+     * The order of the execution is not specified. If the function throws an exception, the remaining indices are
+     * skipped and the first exception is rethrown in the calling thread.
+     */
+    void parallelFor(const std::size_t size, const std::function<void(std::size_t)> &function) {
+      if (workers.empty() || size <= 1) {
+        for (std::size_t i = 0; i < size; ++i) {
+          function(i);
+        }
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> lock{mutex};
+        job = &function;
+        jobSize = size;
+        nextIndex = 0;
+        exception = nullptr;
+        ++generation;
+      }
+      jobAvailable.notify_all();
+      work(function, size);
+      std::exception_ptr thrown;
+      {
+        std::unique_lock<std::mutex> lock{mutex};
+        // Since all the indices are taken, the workers joining later do nothing.
+        jobFinished.wait(lock, [&] {
+          return activeWorkers == 0;
+        });
+        job = nullptr;
+        thrown = exception;
+      }
+      if (thrown) {
+        std::rethrow_exception(thrown);
+      }
+    }
+  };
+}
@@ -9,8 +9,10 @@
 #include "intersection.hh"
 #include "ta2za.hh"
 #include "timed_automaton_runner.hh"
+#include "logging.hh"
 
 #include <utility>
+#include <vector>
 
 namespace learnta {
   /*!
@@ -26,45 +28,75 @@ namespace learnta {
 
     /*!
      * @brief Check if the language recognized by the target DTA is a subset of that of the hypothesis DTA.
+     *
+     * @returns At most maxCounterExamples distinct timed words in the target language but not in the hypothesis
      */
-    [[nodiscard]] std::optional<TimedWord> subset(TimedAutomaton hypothesis) const {
+    [[nodiscard]] std::vector<TimedWord> subset(TimedAutomaton hypothesis, std::size_t maxCounterExamples = 1) const {
       TimedAutomaton intersection;
       boost::unordered_map<std::pair<TAState *, TAState *>, std::shared_ptr<TAState>> toIState;
-      BOOST_LOG_TRIVIAL(debug) << "subset: hypothesis\n" << hypothesis;
+      LEARNTA_LOG(debug) << "subset: hypothesis\n" << hypothesis;
       intersectionTA(complement, hypothesis, intersection, toIState);
       ZoneAutomaton zoneAutomaton;
       intersection.simplifyStrong();
       // This is a quick fix for the urgent semantics of the unobservable transitions
       intersection.addUpperBoundForUnobservableTransitions();
-      BOOST_LOG_TRIVIAL(debug) << "subset: before ta2za";
-      BOOST_LOG_TRIVIAL(debug) << "Number of states: " << intersection.stateSize();
-      BOOST_LOG_TRIVIAL(debug) << "Number of clock: " << intersection.clockSize();
-      ta2za(intersection, zoneAutomaton);
-      BOOST_LOG_TRIVIAL(debug) << "subset: after ta2za";
+      LEARNTA_LOG(debug) << "subset: before ta2za";
+      LEARNTA_LOG(debug) << "Number of states: " << intersection.stateSize();
+      LEARNTA_LOG(debug) << "Number of clock: " << intersection.clockSize();
+      ta2za(intersection, zoneAutomaton, true, this->cancelled, maxCounterExamples);
+      LEARNTA_LOG(debug) << "subset: after ta2za";
+      if (isCancelled()) {
+        return {};
+      }
 
-      return zoneAutomaton.sampleWithMemo();
+      return zoneAutomaton.sample(maxCounterExamples);
     }
 
     /*!
      * @brief Check if the language recognized by the target DTA is a superset of that of the hypothesis DTA.
+     *
+     * @returns At most maxCounterExamples distinct timed words in the hypothesis but not in the target language
      */
-    [[nodiscard]] std::optional<TimedWord> superset(const TimedAutomaton& hypothesis) const {
+    [[nodiscard]] std::vector<TimedWord> superset(const TimedAutomaton& hypothesis,
+                                                  std::size_t maxCounterExamples = 1) const {
       TimedAutomaton intersection;
       boost::unordered_map<std::pair<TAState *, TAState *>, std::shared_ptr<TAState>> toIState;
       const auto complementedHypothesis = hypothesis.complement(this->alphabet);
-      BOOST_LOG_TRIVIAL(debug) << "superset: complemented hypothesis\n" << complementedHypothesis;
+      LEARNTA_LOG(debug) << "superset: complemented hypothesis\n" << complementedHypothesis;
       intersectionTA(target, complementedHypothesis, intersection, toIState);
       ZoneAutomaton zoneAutomaton;
       intersection.simplifyStrong();
       // This is a quick fix for the urgent semantics of the unobservable transitions
       intersection.addUpperBoundForUnobservableTransitions();
-      BOOST_LOG_TRIVIAL(debug) << "superset: before ta2za";
-      BOOST_LOG_TRIVIAL(debug) << "Number of states: " << intersection.stateSize();
-      BOOST_LOG_TRIVIAL(debug) << "Number of clock: " << intersection.clockSize();
-      ta2za(intersection.simplify(), zoneAutomaton);
-      BOOST_LOG_TRIVIAL(debug) << "superset: after ta2za";
+      LEARNTA_LOG(debug) << "superset: before ta2za";
+      LEARNTA_LOG(debug) << "Number of states: " << intersection.stateSize();
+      LEARNTA_LOG(debug) << "Number of clock: " << intersection.clockSize();
+      ta2za(intersection.simplify(), zoneAutomaton, true, this->cancelled, maxCounterExamples);
+      LEARNTA_LOG(debug) << "superset: after ta2za";
+      if (isCancelled()) {
+        return {};
+      }
+
+      return zoneAutomaton.sample(maxCounterExamples);
+    }
 
-      return zoneAutomaton.sampleWithMemo();
+    /*!
+     * @brief Confirm that the generated counterexample is really a counterexample
+     */
+    void confirm(const TimedAutomaton &hypothesis, const TimedWord &counterExample) const {
+      TimedAutomatonRunner targetRunner{this->target};
+      TimedAutomatonRunner hypothesisRunner{hypothesis};
+      targetRunner.pre();
+      hypothesisRunner.pre();
+      for (std::size_t i = 0; i < counterExample.wordSize(); ++i) {
+        targetRunner.step(counterExample.getDurations().at(i));
+        hypothesisRunner.step(counterExample.getDurations().at(i));
+        targetRunner.step(counterExample.getWord().at(i));
+        hypothesisRunner.step(counterExample.getWord().at(i));
+      }
+      assert(targetRunner.step(counterExample.getDurations().back()) != hypothesisRunner.step(counterExample.getDurations().back()));
+      targetRunner.post();
+      hypothesisRunner.post();
     }
 
   public:
@@ -75,8 +107,8 @@ namespace learnta {
                                              std::vector<Alphabet> alphabet) : target(std::move(target)),
                                                                                complement(std::move(complement)),
                                                                                alphabet(std::move(alphabet)) {
-      BOOST_LOG_TRIVIAL(debug) << "Target DTA: \n" << this->target;
-      BOOST_LOG_TRIVIAL(debug) << "Complemented target DTA: \n" << this->complement;
+      LEARNTA_LOG(debug) << "Target DTA: \n" << this->target;
+      LEARNTA_LOG(debug) << "Complemented target DTA: \n" << this->complement;
     }
 
     /*!
@@ -84,45 +116,54 @@ namespace learnta {
      */
     [[nodiscard]] std::optional<TimedWord> findCounterExample(const TimedAutomaton &hypothesis) override {
       ++eqQueryCount;
-      auto subCounterExample = subset(hypothesis);
-      if (subCounterExample) {
-        // Confirm that the generated counterexample is really a counterexample
-        TimedAutomatonRunner targetRunner{this->target};
-        TimedAutomatonRunner hypothesisRunner{hypothesis};
-        targetRunner.pre();
-        hypothesisRunner.pre();
-        for (std::size_t i = 0; i < subCounterExample->wordSize(); ++i) {
-          targetRunner.step(subCounterExample->getDurations().at(i));
-          hypothesisRunner.step(subCounterExample->getDurations().at(i));
-          targetRunner.step(subCounterExample->getWord().at(i));
-          hypothesisRunner.step(subCounterExample->getWord().at(i));
+      auto subCounterExamples = subset(hypothesis);
+      if (!subCounterExamples.empty()) {
+        confirm(hypothesis, subCounterExamples.front());
+        return subCounterExamples.front();
+      }
+      if (isCancelled()) {
+        return std::nullopt;
+      }
+      auto supCounterExamples = superset(hypothesis);
+      if (!supCounterExamples.empty()) {
+        confirm(hypothesis, supCounterExamples.front());
+        return supCounterExamples.front();
+      }
 
-        }
-        assert(targetRunner.step(subCounterExample->getDurations().back()) != hypothesisRunner.step(subCounterExample->getDurations().back()));
-        targetRunner.post();
-        hypothesisRunner.post();
+      return std::nullopt;
+    }
 
-        return subCounterExample;
+    /*!
+     * @brief Make an equivalence query returning the counterexamples of both inclusions
+     *
+     * Unlike findCounterExample, we check the superset even if the subset check finds a counterexample. We sample up
+     * to maxCounterExamples distinct accepting paths of each zone automaton and alternate the two lists so that both
+     * inclusions are represented.
+     */
+    [[nodiscard]] std::vector<TimedWord> findCounterExamples(const TimedAutomaton &hypothesis,
+                                                             std::size_t maxCounterExamples) override {
+      if (maxCounterExamples <= 1) {
+        return EquivalenceOracle::findCounterExamples(hypothesis, maxCounterExamples);
+      }
+      ++eqQueryCount;
+      const auto subCounterExamples = subset(hypothesis, maxCounterExamples);
+      if (isCancelled()) {
+        return {};
       }
-      auto supCounterExample = superset(hypothesis);
-      if (supCounterExample) {
-        // Confirm that the generated counterexample is really a counterexample
-        TimedAutomatonRunner targetRunner{this->target};
-        TimedAutomatonRunner hypothesisRunner{hypothesis};
-        targetRunner.pre();
-        hypothesisRunner.pre();
-        for (std::size_t i = 0; i < supCounterExample->wordSize(); ++i) {
-          targetRunner.step(supCounterExample->getDurations().at(i));
-          hypothesisRunner.step(supCounterExample->getDurations().at(i));
-          targetRunner.step(supCounterExample->getWord().at(i));
-          hypothesisRunner.step(supCounterExample->getWord().at(i));
+      const auto supCounterExamples = superset(hypothesis, maxCounterExamples);
+      std::vector<TimedWord> result;
+      result.reserve(maxCounterExamples);
+      for (std::size_t i = 0; result.size() < maxCounterExamples &&
+                              (i < subCounterExamples.size() || i < supCounterExamples.size()); ++i) {
+        for (const auto *counterExamples: {&subCounterExamples, &supCounterExamples}) {
+          if (i < counterExamples->size() && result.size() < maxCounterExamples) {
+            confirm(hypothesis, counterExamples->at(i));
+            result.push_back(counterExamples->at(i));
+          }
         }
-        assert(targetRunner.step(supCounterExample->getDurations().back()) != hypothesisRunner.step(supCounterExample->getDurations().back()));
-        targetRunner.post();
-        hypothesisRunner.post();
       }
 
-      return supCounterExample;
+      return result;
     }
   };
 }
\ No newline at end of file
@@ -18,9 +18,11 @@
 #include "common_types.hh"
 #include "constraint.hh"
 #include "conjunctive_constraint.hh"
+#include "clock_set.hh"
 
 namespace learnta {
   struct TATransition;
+  struct ZoneAutomaton;
 
   /*!
    * @brief A state of timed automata
@@ -73,7 +75,7 @@ namespace learnta {
      *
      * This is intended to be used to merge the transitions generated by guard relaxation.
      */
-    void mergeNondeterministicBranching(const std::unordered_set<ClockVariables> &preciseClocks);
+    void mergeNondeterministicBranching(const ClockSet &preciseClocks);
   };
 
 /*!
@@ -540,7 +542,7 @@ namespace learnta {
      * @brief Optimize the timed automaton by removing unused clock variables
      */
     void removeUnusedClockVariables() {
-      std::unordered_set<ClockVariables> usedClockVariables;
+      ClockSet usedClockVariables;
       // Make the set of clock variables
       for (const auto &state: this->states) {
         for (const auto &[action, transitions]: state->next) {
@@ -557,9 +559,8 @@ namespace learnta {
         }
       }
 
-      // Construct a map showing how we rename clock variables
+      // Construct a map showing how we rename clock variables. ClockSet is iterated in the ascending order.
       std::vector<ClockVariables> usedClockVariablesVec{usedClockVariables.begin(), usedClockVariables.end()};
-      std::sort(usedClockVariablesVec.begin(), usedClockVariablesVec.end());
       // Clock variable x is renamed to clockRenaming.at(x)
       std::unordered_map<ClockVariables, ClockVariables> clockRenaming;
       for (std::size_t i = 0; i < usedClockVariablesVec.size(); ++i) {
@@ -574,7 +575,7 @@ namespace learnta {
               guard.x = clockRenaming.at(guard.x);
             }
             for (auto it = transition.resetVars.begin(); it != transition.resetVars.end();) {
-              if (usedClockVariables.find(it->first) == usedClockVariables.end()) {
+              if (!usedClockVariables.contains(it->first)) {
                 it = transition.resetVars.erase(it);
               } else {
                 it->first = clockRenaming.at(it->first);
@@ -628,6 +629,13 @@ namespace learnta {
      */
     TimedAutomaton simplifyWithZones();
 
+    /*!
+     * @brief Simplify the timed automaton with the given zone graph of it
+     *
+     * @param zoneAutomaton The zone automaton constructed by ta2za without quickReturn. Its dead states are removed.
+     */
+    TimedAutomaton simplifyWithZones(ZoneAutomaton &zoneAutomaton);
+
     /*!
      * @brief Make a vector showing maximum constants for each variable from a set of states
      */
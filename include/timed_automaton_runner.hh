@@ -5,13 +5,60 @@
 
 #pragma once
 
+#include <cmath>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include "sul.hh"
 #include "timed_automaton.hh"
+#include "logging.hh"
 
 namespace learnta {
+  /*!
+   * @brief The duration consumed by an unobservable transition enabled right after the current time
+   *
+   * Such a transition has a strict lower bound that is just reached, e.g., x > 1 when x is 1. We take it after this
+   * small duration instead of the infinitesimal one.
+   */
+  static constexpr double unobservableEpsilon = 1.0e-10;
+
+  /*!
+   * @brief Let the given duration elapse, taking the unobservable transitions enabled on the way
+   *
+   * This is the semantics of the unobservable transitions shared by the runners of timed automata. Before each
+   * elapse, earliestUnobservable returns the pair of the lower bound of the duration to enable the earliest
+   * unobservable transition from the current state and the transition, or std::nullopt if there is no such
+   * transition. take(transition) resets the clock variables and moves to its target.
+   *
+   * @param duration The duration to elapse
+   * @param clockValuation The clock valuation of the runner, which is updated in place
+   */
+  template<typename EarliestUnobservable, typename Take>
+  void elapseWithUnobservable(double duration, std::vector<double> &clockValuation,
+                              EarliestUnobservable earliestUnobservable, Take take) {
+    while (duration != 0) {
+      const auto candidate = earliestUnobservable();
+      if (!candidate) {
+        break;
+      }
+      const Bounds minDuration = candidate->first;
+      if (!std::isfinite(minDuration.first) || minDuration.first > 0 || !(Bounds{-duration, true} <= minDuration)) {
+        break;
+      }
+      // An unobservable transition is available
+      for (double &value: clockValuation) {
+        value += -minDuration.first;
+      }
+      take(candidate->second);
+      duration -= (minDuration.first == 0 && !minDuration.second) ? unobservableEpsilon : -minDuration.first;
+    }
+    // No unobservable transition is available
+    for (double &value: clockValuation) {
+      value += duration;
+    }
+  }
+
   /*!
    * @brief Class to execute a timed automaton
    *
@@ -22,7 +69,7 @@ namespace learnta {
   class TimedAutomatonRunner : public SUL {
   private:
     TimedAutomaton automaton;
-    TAState *state;
+    TAState *state = nullptr;
     std::vector<double> clockValuation;
     std::size_t numQueries;
     const bool isEmpty = false;
@@ -54,6 +101,33 @@ namespace learnta {
       }
     }
 
+    //! @brief The current state. This is nullptr if we are at the sink state.
+    [[nodiscard]] const TAState *getState() const {
+      return isEmpty ? nullptr : this->state;
+    }
+
+    //! @brief The current clock valuation
+    [[nodiscard]] const std::vector<double> &getClockValuation() const {
+      return this->clockValuation;
+    }
+
+    //! @brief The configuration of a runner to resume the execution later
+    struct Snapshot {
+      TAState *state;
+      std::vector<double> clockValuation;
+    };
+
+    //! @brief Take the current configuration. This is much cheaper than copying the runner.
+    [[nodiscard]] Snapshot snapshot() const {
+      return {this->state, this->clockValuation};
+    }
+
+    //! @brief Resume the execution from the configuration taken by snapshot
+    void restore(const Snapshot &snapshot) {
+      this->state = snapshot.state;
+      this->clockValuation = snapshot.clockValuation;
+    }
+
     /*!
      * @brief Apply the given reset to the clock valuation
      */
@@ -77,7 +151,7 @@ namespace learnta {
       this->clockValuation = applyReset(this->clockValuation, resets);
     }
 
-    bool step(char action) override {
+    bool step(Alphabet action) override {
       if (isEmpty) {
         return false;
       }
@@ -86,16 +160,20 @@ namespace learnta {
       if (this->state == nullptr) {
         return false;
       }
-      for (const TATransition &transition: this->state->next[action]) {
-        // Check if the guard is satisfied
-        if (std::all_of(transition.guard.begin(), transition.guard.end(), [&](const Constraint &guard) {
-          return guard.satisfy(this->clockValuation.at(guard.x));
-        })) {
-          // Reset the clock variables
-          this->applyReset(transition.resetVars);
-          this->state = transition.target;
-
-          return this->state->isMatch;
+      // We do not use operator[] so that the runners sharing the same automaton can be used in parallel
+      const auto transitionsIt = this->state->next.find(action);
+      if (transitionsIt != this->state->next.end()) {
+        for (const TATransition &transition: transitionsIt->second) {
+          // Check if the guard is satisfied
+          if (std::all_of(transition.guard.begin(), transition.guard.end(), [&](const Constraint &guard) {
+            return guard.satisfy(this->clockValuation.at(guard.x));
+          })) {
+            // Reset the clock variables
+            this->applyReset(transition.resetVars);
+            this->state = transition.target;
+
+            return this->state->isMatch;
+          }
         }
       }
 
@@ -113,49 +191,24 @@ namespace learnta {
       if (this->state == nullptr) {
         return false;
       }
-      if (duration == 0) {
-        return this->state->isMatch;
-      }
-      const auto unobservableIt = this->state->next.find(UNOBSERVABLE);
-      if (unobservableIt != this->state->next.end() && !unobservableIt->second.empty()) {
-        // If there are unobservable transitions, we choose the minimum duration to satisfy it
-        Bounds minDuration;
-        auto candidateTransition = unobservableIt->second.end();
-        if (unobservableIt->second.size() == 1) {
-          minDuration = lowerBoundDurationToSatisfy(unobservableIt->second.front().guard, this->clockValuation);
-          candidateTransition = unobservableIt->second.begin();
-        } else {
-          candidateTransition = std::min_element(unobservableIt->second.begin(), unobservableIt->second.end(),
-                                                 [&](const auto &a, const auto &b) {
-                                                   return lowerBoundDurationToSatisfy(a.guard, this->clockValuation) <
-                                                          lowerBoundDurationToSatisfy(b.guard, this->clockValuation);
-                                                 });
-          minDuration = lowerBoundDurationToSatisfy(candidateTransition->guard, this->clockValuation);
+      using Candidate = std::pair<Bounds, const TATransition *>;
+      elapseWithUnobservable(duration, this->clockValuation, [&]() -> std::optional<Candidate> {
+        const auto unobservableIt = this->state->next.find(UNOBSERVABLE);
+        if (unobservableIt == this->state->next.end() || unobservableIt->second.empty()) {
+          return std::nullopt;
         }
-        if (std::isfinite(minDuration.first) && minDuration.first <= 0 && Bounds{-duration, true} <= minDuration) {
-          // An unobservable transition is available
-          std::transform(this->clockValuation.begin(), this->clockValuation.end(), this->clockValuation.begin(),
-                         [&](double value) {
-                           return value + -minDuration.first;
-                         });
-          // Reset the clock variables
-          // assert the validity of the candidate transition
-          assert(candidateTransition != unobservableIt->second.end());
-          this->applyReset(candidateTransition->resetVars);
-          this->state = candidateTransition->target;
-          return this->step(duration - ((minDuration.first == 0 && !minDuration.second) ? 1.0e-10 : -minDuration.first));
-        } else {
-          BOOST_LOG_TRIVIAL(debug) << "Unobservable transitions are skipped";
-          BOOST_LOG_TRIVIAL(debug) << "std::isfinite(-minDuration): " << std::isfinite(-minDuration.first);
-          BOOST_LOG_TRIVIAL(debug) << "minDuration: " << minDuration.first << ", " << minDuration.second;
-          BOOST_LOG_TRIVIAL(debug) << "duration: " << duration;
-        }
-      }
-      // No unobservable transition is available
-      std::transform(this->clockValuation.begin(), this->clockValuation.end(), this->clockValuation.begin(),
-                     [&](double value) {
-                       return value + duration;
-                     });
+        // We choose the transition with the minimum duration to satisfy its guard
+        const auto candidateTransition = std::min_element(
+                unobservableIt->second.begin(), unobservableIt->second.end(), [&](const auto &a, const auto &b) {
+                  return lowerBoundDurationToSatisfy(a.guard, this->clockValuation) <
+                         lowerBoundDurationToSatisfy(b.guard, this->clockValuation);
+                });
+        return Candidate{lowerBoundDurationToSatisfy(candidateTransition->guard, this->clockValuation),
+                         &*candidateTransition};
+      }, [&](const TATransition *transition) {
+        this->applyReset(transition->resetVars);
+        this->state = transition->target;
+      });
 
       return this->state->isMatch;
     }
@@ -7,6 +7,7 @@
 #include "zone.hh"
 #include "juxtaposed_zone.hh"
 #include "timed_automaton.hh"
+#include "logging.hh"
 
 namespace learnta {
   /*!
@@ -602,7 +603,7 @@ namespace learnta {
      */
     [[nodiscard]] std::vector<Constraint> toGuard() const {
 #ifdef DEBUG
-      BOOST_LOG_TRIVIAL(trace) << "Constraint:" << *this;
+      LEARNTA_LOG(trace) << "Constraint:" << *this;
 #endif
       std::vector<Constraint> result;
       const auto N = this->size();
@@ -627,7 +628,7 @@ namespace learnta {
       }
 
 #ifdef DEBUG
-      BOOST_LOG_TRIVIAL(trace) << "Guard: " << result;
+      LEARNTA_LOG(trace) << "Guard: " << result;
 #endif
       return result;
     }
@@ -796,6 +797,7 @@ namespace learnta {
     }
 
     friend class NeighborConditions;
+    friend class Serializer;
   };
 }
 
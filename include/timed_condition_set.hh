@@ -21,6 +21,8 @@ namespace learnta {
 
     explicit TimedConditionSet(std::vector<TimedCondition> conditions) : conditions(std::move(conditions)) {}
 
+    friend class Serializer;
+
   public:
     TimedConditionSet() : conditions(std::vector<TimedCondition>{}) {}
 
@@ -24,7 +24,7 @@ namespace learnta {
    */
   class TimedWord {
   private:
-    std::string word;
+    Word word;
     std::vector<double> durations;
   public:
     TimedWord() : durations({0}) {}
@@ -34,7 +34,7 @@ namespace learnta {
      *
      * @note When the given word contains unobservable actions, we absorb them
      */
-    TimedWord(const std::string& word, const std::vector<double>& durations) {
+    TimedWord(const Word& word, const std::vector<double>& durations) {
       assert(word.size() + 1 == durations.size());
       this->word.reserve(word.size());
       this->durations = {durations.front()};
@@ -51,6 +51,12 @@ namespace learnta {
       assert(this->word.size() + 1 == this->durations.size());
     }
 
+#ifdef LEARNTA_WIDE_ALPHABET
+    //! @brief Constructor of timed words of ASCII actions
+    TimedWord(const std::string &word, const std::vector<double> &durations) :
+            TimedWord(Word(word.begin(), word.end()), durations) {}
+#endif
+
     /*!
      * @brief Return the concatenation of two timed words
      *
@@ -74,7 +80,7 @@ namespace learnta {
      *
      * Let this be \f$\tau_0 a_1 \tau_1 \dots \tau_{n-1} a_{n} \tau_{n} \f$ and action be \f$a\f$. The result is \f$\tau_0 a_1 \tau_1 \dots \tau_{n-1} a_{n} \tau_{n} a 0 \f$.
      */
-    TimedWord operator+(const char action) {
+    TimedWord operator+(const Alphabet action) {
       TimedWord result = *this;
       result.word.push_back(action);
       result.durations.push_back(0);
@@ -107,7 +113,7 @@ namespace learnta {
       return stream;
     }
 
-    [[nodiscard]] const std::string &getWord() const {
+    [[nodiscard]] const Word &getWord() const {
       return word;
     }
 
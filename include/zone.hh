@@ -69,7 +69,8 @@ namespace learnta {
 
     //! @brief Make the zone of size `size` such that all the values are zero
     static Zone zero(int size) {
-      static Zone zeroZone;
+      // We keep one zone for each thread so that we can use it in parallel
+      static thread_local Zone zeroZone;
       if (zeroZone.value.cols() == size) {
         return zeroZone;
       }
@@ -82,7 +83,7 @@ namespace learnta {
      * @brief Make the zone of size `size` with no constraints
      */
     static Zone top(std::size_t size) {
-      static Zone topZone;
+      static thread_local Zone topZone;
       if (static_cast<std::size_t>(topZone.value.cols()) == size) {
         return topZone;
       }
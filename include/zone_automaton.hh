@@ -1,8 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <stack>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "timed_automaton.hh"
 #include "zone.hh"
@@ -39,15 +41,14 @@ namespace learnta {
               return wordOpt;
             }
           }
-          for (int action = 0; action < CHAR_MAX; ++action) {
-            const auto &edges = run.back()->next[action];
+          for (const auto &[action, edges]: run.back()->next) {
             for (const auto &edge: edges) {
               auto transition = edge.first;
               auto target = edge.second.lock();
               if (target && visited.find(target) == visited.end()) {
                 // We have not visited the state
                 auto newRun = run;
-                newRun.push_back(transition, static_cast<char>(action), target);
+                newRun.push_back(transition, action, target);
                 nextStates.push_back(newRun);
                 visited.insert(target);
               }
@@ -60,6 +61,55 @@ namespace learnta {
       return std::nullopt;
     }
 
+    /*!
+     * @brief Sample at most the given number of distinct timed words in this zone automaton
+     *
+     * We reconstruct one timed word for each accepting state in the BFS order. Thus, the first one is the result of
+     * sample().
+     */
+    [[nodiscard]] std::vector<TimedWord> sample(const std::size_t maxSamples) const {
+      std::vector<TimedWord> result;
+      std::vector<SymbolicRun> currentStates;
+      currentStates.reserve(initialStates.size());
+      std::transform(initialStates.begin(), initialStates.end(), std::back_inserter(currentStates),
+                     [](const auto &initialState) {
+                       return SymbolicRun{initialState};
+                     });
+      std::unordered_set<std::shared_ptr<ZAState>> visited = {initialStates.begin(), initialStates.end()};
+
+      while (!currentStates.empty() && result.size() < maxSamples) {
+        std::vector<SymbolicRun> nextStates;
+        for (const auto &run: currentStates) {
+          if (run.back()->isMatch) {
+            // run is a positive run
+            auto wordOpt = run.reconstructWord();
+            if (wordOpt && std::find(result.begin(), result.end(), *wordOpt) == result.end()) {
+              result.push_back(*std::move(wordOpt));
+              if (result.size() >= maxSamples) {
+                return result;
+              }
+            }
+          }
+          for (const auto &[action, edges]: run.back()->next) {
+            for (const auto &edge: edges) {
+              auto transition = edge.first;
+              auto target = edge.second.lock();
+              if (target && visited.find(target) == visited.end()) {
+                // We have not visited the state
+                auto newRun = run;
+                newRun.push_back(transition, action, target);
+                nextStates.push_back(newRun);
+                visited.insert(target);
+              }
+            }
+          }
+        }
+        currentStates = std::move(nextStates);
+      }
+
+      return result;
+    }
+
     std::optional<TimedWord> sampleMemo;
     std::optional<TimedWord> sampleWithMemo() {
       if (sampleMemo) {
@@ -76,7 +126,7 @@ namespace learnta {
     void removeDeadStates() {
       std::unordered_map<std::shared_ptr<ZAState>, std::unordered_set<std::shared_ptr<ZAState>>> backwardEdges;
       for (const auto &state: this->states) {
-        for (const auto &transitions: state->next) {
+        for (const auto &[action, transitions]: state->next) {
           for (const auto &[transition, target]: transitions) {
             auto it = backwardEdges.find(target.lock());
             if (it == backwardEdges.end()) {
@@ -121,7 +171,7 @@ namespace learnta {
                   return liveStates.find(state) == liveStates.end();
                 }), this->initialStates.end());
         for (const auto &state: this->states) {
-          for (auto &transitions: state->next) {
+          for (auto &[action, transitions]: state->next) {
             transitions.erase(std::remove_if(transitions.begin(), transitions.end(), [&](const auto &pair) {
               const auto &[transition, target] = pair;
               return liveStates.find(target.lock()) == liveStates.end();
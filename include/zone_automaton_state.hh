@@ -3,8 +3,8 @@
  * @date 2022/03/15.
  */
 
+#include <map>
 #include <vector>
-#include <array>
 #include <utility>
 
 #include "timed_automaton.hh"
@@ -20,9 +20,12 @@ namespace learnta {
     /*!
      * @brief The transitions from this state
      *
+     * We only have the entries of the actions with transitions so that the size does not depend on the range of
+     * Alphabet. We use an ordered map to explore the actions in a deterministic order.
+     *
      * @note An epsilon transition is denoted by the null character (\0)
      */
-    std::array<std::vector<std::pair<TATransition, std::weak_ptr<ZAState>>>, CHAR_MAX> next;
+    std::map<Alphabet, std::vector<std::pair<TATransition, std::weak_ptr<ZAState>>>> next;
     //! @brief The state in the timed automaton represented by this state
     TAState *taState = nullptr;
     //! @brief The zone of this state
@@ -35,7 +38,7 @@ namespace learnta {
 
     explicit ZAState(bool isMatch) : isMatch(isMatch), next({}) {}
 
-    ZAState(bool isMatch, std::array<std::vector<std::pair<TATransition, std::weak_ptr<ZAState>>>, CHAR_MAX> next)
+    ZAState(bool isMatch, std::map<Alphabet, std::vector<std::pair<TATransition, std::weak_ptr<ZAState>>>> next)
             : isMatch(isMatch), next(std::move(next)) {}
 
     //! @brief Check the equivalence of two states only using TAState and Zone
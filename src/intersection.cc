@@ -1,5 +1,19 @@
 #include "intersection.hh"
 
+namespace {
+  /*!
+   * @brief The unobservable transitions of the state
+   *
+   * We do not use operator[] because it inserts an entry to the input timed automata, whose states may be shared with
+   * the runners on other threads, e.g., in EquivalenceOracleConcurrentChain.
+   */
+  const std::vector<learnta::TATransition> &unobservableTransitions(const learnta::TAState &state) {
+    static const std::vector<learnta::TATransition> empty;
+    const auto it = state.next.find(learnta::UNOBSERVABLE);
+    return it == state.next.end() ? empty : it->second;
+  }
+}
+
 namespace learnta {
 /*
   Specifications
@@ -48,7 +62,7 @@ namespace learnta {
     const auto addProductTransition = [&](TAState *s1, TAState *s2,
                                           TAState *nextS1, TAState *nextS2,
                                           const TATransition &e1,
-                                          const TATransition &e2, char c) {
+                                          const TATransition &e2, Alphabet c) {
       TATransition transition;
       transition.target = toIState[std::make_pair(nextS1, nextS2)].get();
 
@@ -85,7 +99,7 @@ namespace learnta {
     for (auto s1: in1.states) {
       for (auto s2: in2.states) {
         // Epsilon transitions
-        for (const auto &e1: s1->next[learnta::UNOBSERVABLE]) {
+        for (const auto &e1: unobservableTransitions(*s1)) {
           auto nextS1 = e1.target;
           if (!nextS1) {
             continue;
@@ -93,7 +107,7 @@ namespace learnta {
           addProductTransition(s1.get(), s2.get(), nextS1, s2.get(), e1,
                                emptyTransition, learnta::UNOBSERVABLE);
         }
-        for (const auto &e2: s2->next[learnta::UNOBSERVABLE]) {
+        for (const auto &e2: unobservableTransitions(*s2)) {
           auto nextS2 = e2.target;
           if (!nextS2) {
             continue;
@@ -196,7 +210,7 @@ namespace learnta {
     const auto addProductTransition = [&](TAState *s1, TAState *s2,
                                           TAState *nextS1, TAState *nextS2,
                                           const TATransition &e1,
-                                          const TATransition &e2, char c) {
+                                          const TATransition &e2, Alphabet c) {
       TATransition transition;
       transition.target = toIState[std::make_pair(nextS1, nextS2)].get();
 
@@ -233,7 +247,7 @@ namespace learnta {
     for (const auto& s1: in1.states) {
       for (auto s2: in2.states) {
         // Epsilon transitions
-        for (const auto &e1: s1->next[0]) {
+        for (const auto &e1: unobservableTransitions(*s1)) {
           auto nextS1 = e1.target;
           if (!nextS1) {
             continue;
@@ -241,7 +255,7 @@ namespace learnta {
           addProductTransition(s1.get(), s2.get(), nextS1, s2.get(), e1,
                                emptyTransition, 0);
         }
-        for (const auto &e2: s2->next[0]) {
+        for (const auto &e2: unobservableTransitions(*s2)) {
           auto nextS2 = e2.target;
           if (!nextS2) {
             continue;
@@ -6,6 +6,7 @@
 #include <boost/unordered_map.hpp>
 
 #include "observation_table.hh"
+#include "logging.hh"
 
 namespace learnta {
   /*!
@@ -25,23 +26,21 @@ namespace learnta {
    */
   void ObservationTable::handleInactiveClocks(std::vector<std::shared_ptr<TAState>> &states) {
     const auto originalStates = states;
-    boost::unordered_map<std::pair<TAState*, std::vector<ClockVariables>>, std::shared_ptr<TAState>> map;
-    std::queue<std::pair<TAState*, std::vector<ClockVariables>>> inactiveQueue;
+    boost::unordered_map<std::pair<TAState*, ClockSet>, std::shared_ptr<TAState>> map;
+    std::queue<std::pair<TAState*, ClockSet>> inactiveQueue;
     // Initialize the inactive Queue
     for (const auto& state: originalStates) {
-      map[std::make_pair(state.get(), std::vector<ClockVariables>{})] = state;
+      map[std::make_pair(state.get(), ClockSet{})] = state;
     }
     for (const auto& state: originalStates) {
       for (auto &[action, transitions]: state->next) {
         for (auto &transition: transitions) {
-          std::vector<ClockVariables> inactiveClocks;
+          ClockSet inactiveClocks;
           for (const auto &[clock, value]: transition.resetVars) {
             if (value.index() == 0 && std::get<double>(value) != int(std::get<double>(value))) {
-              inactiveClocks.push_back(clock);
+              inactiveClocks.insert(clock);
             }
           }
-          std::sort(inactiveClocks.begin(), inactiveClocks.end());
-          inactiveClocks.erase(std::unique(inactiveClocks.begin(), inactiveClocks.end()), inactiveClocks.end());
           auto it = map.find(std::make_pair(transition.target, inactiveClocks));
           if (it == map.end()) {
             states.push_back(std::make_shared<TAState>(transition.target->isMatch,
@@ -62,19 +61,19 @@ namespace learnta {
         for (auto &transition: transitions) {
           for (auto it = transition.guard.begin(); it != transition.guard.end();) {
             // remove inactive clock variables
-            if (std::find(inactiveClocks.begin(), inactiveClocks.end(), it->x) != inactiveClocks.end()) {
+            if (inactiveClocks.contains(it->x)) {
               it = transition.guard.erase(it);
             } else {
               ++it;
             }
           }
-          std::vector<ClockVariables> nextInactiveClocks;
+          ClockSet nextInactiveClocks;
           if (transition.guard.empty()) {
             nextInactiveClocks = inactiveClocks;
           }
           for (const auto &[clock, value]: transition.resetVars) {
             if (value.index() == 0 && std::get<double>(value) != int (std::get<double>(value))) {
-              nextInactiveClocks.push_back(clock);
+              nextInactiveClocks.insert(clock);
             }
           }
           for (const auto &inactiveClock: inactiveClocks) {
@@ -83,18 +82,16 @@ namespace learnta {
               return p.first == inactiveClock;
             });
             if (it == transition.resetVars.end()) {
-              nextInactiveClocks.push_back(inactiveClock);
+              nextInactiveClocks.insert(inactiveClock);
             }
             // c' is deactivated if it is updated to the current inactive clock
             it = std::find_if(transition.resetVars.begin(), transition.resetVars.end(), [=] (const auto &p) {
               return p.second.index() == 1 && std::get<ClockVariables>(p.second) == inactiveClock;
             });
             if (it != transition.resetVars.end()) {
-              nextInactiveClocks.push_back(it->first);
+              nextInactiveClocks.insert(it->first);
             }
           }
-          std::sort(nextInactiveClocks.begin(), nextInactiveClocks.end());
-          nextInactiveClocks.erase(std::unique(nextInactiveClocks.begin(), nextInactiveClocks.end()), nextInactiveClocks.end());
           auto it = map.find(std::make_pair(transition.target, nextInactiveClocks));
           if (it == map.end()) {
             states.push_back(std::make_shared<TAState>(transition.target->isMatch));
@@ -108,18 +105,10 @@ namespace learnta {
   }
 
   namespace InternalSplitStates {
-    using PreciseClocks = std::vector<ClockVariables>;
+    using PreciseClocks = ClockSet;
     using State = TAState*;
     // A pair of the original state and the precise clocks
     using EnhancedState = std::pair<State, PreciseClocks>;
-    std::unordered_set<ClockVariables> asSet(const std::vector<ClockVariables> &vector) {
-      return std::unordered_set<ClockVariables>{vector.begin(), vector.end()};
-    }
-    PreciseClocks asPreciseClocks(const std::unordered_set<ClockVariables> &set) {
-      auto vector = PreciseClocks{set.begin(), set.end()};
-      std::sort(vector.begin(), vector.end());
-      return vector;
-    }
     struct StateMap {
       std::vector<std::shared_ptr<TAState>> states;
       const std::vector<std::shared_ptr<TAState>> originalStates;
@@ -131,12 +120,7 @@ namespace learnta {
         for (const auto& state: states) {
           this->states.push_back(std::make_shared<TAState>(*state));
           const auto clockSize = NeighborConditions::computeClockSize(state.get());
-          std::vector<ClockVariables> preciseClocks;
-          preciseClocks.resize(clockSize);
-          std::iota(preciseClocks.begin(), preciseClocks.end(), 0);
-
-          this->add(EnhancedState{state.get(), PreciseClocks{preciseClocks.begin(), preciseClocks.end()}},
-                    this->states.back().get());
+          this->add(EnhancedState{state.get(), PreciseClocks::range(clockSize)}, this->states.back().get());
           if (state == initialState) {
             this->initialState = this->states.back();
           }
@@ -191,7 +175,7 @@ namespace learnta {
       }
 
       State make(const EnhancedState &state) {
-        BOOST_LOG_TRIVIAL(debug) << "StateMap: new state is created";
+        LEARNTA_LOG(debug) << "StateMap: new state is created";
         assert(std::find_if(originalStates.begin(), originalStates.end(), [&] (const auto &s) {
           return s.get() == state.first;
         }) != originalStates.end());
@@ -244,13 +228,13 @@ namespace learnta {
         continue;
       }
       visitedStates.insert(enhancedState);
-      originalState->mergeNondeterministicBranching(asSet(preciseClocks));
+      originalState->mergeNondeterministicBranching(preciseClocks);
       for (auto &[action, transitions]: state->next) {
         for (auto &transition: transitions) {
-          const auto nextPreciseClocks = NeighborConditions::preciseClocksAfterReset(asSet(preciseClocks), transition);
+          const auto nextPreciseClocks = NeighborConditions::preciseClocksAfterReset(preciseClocks, transition);
           const auto targetAsOriginal = stateMap.toOriginalState(transition.target);
           assert(inOriginalStates(targetAsOriginal));
-          const EnhancedState nextEnhancedState{targetAsOriginal, asPreciseClocks(nextPreciseClocks)};
+          const EnhancedState nextEnhancedState{targetAsOriginal, nextPreciseClocks};
           if (!isVisited(nextEnhancedState)) {
             statesToVisit.push(nextEnhancedState);
             assert(inOriginalStates(nextEnhancedState.first));
@@ -1,7 +1,9 @@
+#include <algorithm>
 #include <numeric>
 #include <utility>
 
 #include "../include/ta2za.hh"
+#include "../include/instrumentation.hh"
 
 namespace learnta {
 
@@ -12,7 +14,8 @@ namespace learnta {
   TA to ZA adds states with BFS. Initial configuration is the initial states of
   ZA. The ZA contain only the states reachable from initial states.
  */
-  void ta2za(const TimedAutomaton &TA, ZoneAutomaton &ZA, bool quickReturn) {
+  void ta2za(const TimedAutomaton &TA, ZoneAutomaton &ZA, bool quickReturn, const std::atomic<bool> *cancelled,
+             std::size_t quickReturnMatches) {
     const std::size_t clockSize = TA.clockSize();
     Zone initialZone = Zone::zero(clockSize + 1);
 
@@ -42,6 +45,12 @@ namespace learnta {
     std::copy(ZA.initialStates.begin(), ZA.initialStates.end(), ZA.states.begin());
     std::copy(ZA.initialStates.begin(), ZA.initialStates.end(), std::back_inserter(newStates));
 
+    ta2zaFrom(ZA, std::move(newStates), quickReturn, cancelled, quickReturnMatches);
+  }
+
+  void ta2zaFrom(ZoneAutomaton &ZA, std::deque<std::shared_ptr<ZAState>> newStates, bool quickReturn,
+                 const std::atomic<bool> *cancelled, std::size_t quickReturnMatches) {
+    LEARNTA_SCOPED_TIMER("zone_automaton.ta2za");
     /*!
       @brief translater from TAState and Zone to its corresponding state in ZA.
 
@@ -49,12 +58,20 @@ namespace learnta {
       (TAState,Zone) -> ZAState
     */
     boost::unordered_map<std::pair<TAState *, Zone>, std::shared_ptr<ZAState>> zaMap;
-    for (const auto &state: ZA.initialStates) {
+    for (const auto &state: ZA.states) {
       zaMap[std::make_pair(state->taState, state->zone)] = state;
     }
+    //! number of the accepting states of ZA
+    std::size_t matchSize = std::count_if(ZA.states.begin(), ZA.states.end(), [](const auto &state) {
+      return state->isMatch;
+    });
     while (!newStates.empty()) {
+      if (cancelled && cancelled->load(std::memory_order_relaxed)) {
+        return;
+      }
       const auto zaState = newStates.front();
       newStates.pop_front();
+      LEARNTA_COUNT("zone_automaton.zones_explored", 1);
       TAState *taState = zaState->taState;
       Zone nowZone = zaState->zone;
       nowZone.elapse();
@@ -104,10 +121,13 @@ namespace learnta {
 
               newStates.push_back(ZA.states.back());
               zaMap[std::make_pair(ZA.states.back()->taState, ZA.states.back()->zone)] = ZA.states.back();
+              if (nextState->isMatch) {
+                ++matchSize;
+              }
             }
-            // We shortcut the zone construction once we reach an accepting state
+            // We shortcut the zone construction once we reach enough accepting states
             if (nextState->isMatch) {
-              if (quickReturn && ZA.sampleWithMemo()) {
+              if (quickReturn && matchSize >= quickReturnMatches && ZA.sampleWithMemo()) {
                 return;
               }
             }
@@ -115,5 +135,6 @@ namespace learnta {
         }
       }
     }
+    LEARNTA_RECORD("zone_automaton.states", ZA.states.size());
   }
 }
@@ -9,22 +9,21 @@
 #include "zone_automaton.hh"
 #include "ta2za.hh"
 #include "neighbor_conditions.hh"
+#include "logging.hh"
 
 namespace learnta {
   /*!
    * @brief Returns the imprecise clocks after transition
    */
   std::vector<ClockVariables> impreciseClocksAfterTransition(const TATransition &transition) {
-    const auto asSet = [](const auto &&container) {
-      return std::unordered_set<ClockVariables>{container.begin(), container.end()};
-    };
     const auto targetClockSize = NeighborConditions::computeTargetClockSize(transition);
-    const auto preciseClocks = asSet(simpleVariables(transition.guard));
+    const auto simple = simpleVariables(transition.guard);
+    const ClockSet preciseClocks{simple.begin(), simple.end()};
     const auto preciseClocksAfterJump = NeighborConditions::preciseClocksAfterReset(preciseClocks, transition);
     std::vector<ClockVariables> result;
     result.reserve(targetClockSize);
     for (std::size_t i = 0; i < targetClockSize; ++i) {
-      if (preciseClocksAfterJump.find(i) == preciseClocksAfterJump.end()) {
+      if (!preciseClocksAfterJump.contains(i)) {
         result.push_back(i);
       }
     }
@@ -51,6 +50,11 @@ namespace learnta {
   TimedAutomaton learnta::TimedAutomaton::simplifyWithZones() {
     ZoneAutomaton zoneAutomaton;
     ta2za(*this, zoneAutomaton, false);
+
+    return this->simplifyWithZones(zoneAutomaton);
+  }
+
+  TimedAutomaton learnta::TimedAutomaton::simplifyWithZones(ZoneAutomaton &zoneAutomaton) {
     zoneAutomaton.removeDeadStates();
 
     // Make the live states of the TA
@@ -61,8 +65,7 @@ namespace learnta {
       if (liveTransitions.find(state->taState) == liveTransitions.end()) {
         liveTransitions[state->taState] = {};
       }
-      for (int action = 0; action < CHAR_MAX; ++action) {
-        const auto &edges = state->next[action];
+      for (const auto &[action, edges]: state->next) {
         for (const auto &[transition, target]: edges) {
           liveTransitions.at(state->taState).emplace_back(action, transition);
         }
@@ -174,7 +177,7 @@ namespace learnta {
         for (auto it3 = std::next(it2); it3 != transitions.end();) {
           if (it2->target == it3->target && satisfiable(conjunction(it2->guard, it3->guard))) {
 #ifdef DEBUG
-            BOOST_LOG_TRIVIAL(debug) << "The conjunction of " << it2->guard << " and "
+            LEARNTA_LOG(debug) << "The conjunction of " << it2->guard << " and "
                                      << it3->guard << " is satisfiable";
 #endif
             // Use the reset and target causing more imprecise clocks
@@ -218,7 +221,7 @@ namespace learnta {
         for (auto it3 = std::next(it2); it3 != transitions.end();) {
           if (satisfiable(conjunction(it2->guard, it3->guard))) {
 #ifdef DEBUG
-            BOOST_LOG_TRIVIAL(debug) << "The conjunction of " << it2->guard << " and "
+            LEARNTA_LOG(debug) << "The conjunction of " << it2->guard << " and "
                                      << it3->guard << " is satisfiable";
 #endif
             // assert(it2->target == it3->target);
@@ -227,12 +230,12 @@ namespace learnta {
             // So, we tentatively weaken the requirement
             assert(it2->target->isMatch == it3->target->isMatch);
             if (it2->target != it3->target) {
-              BOOST_LOG_TRIVIAL(debug) << "We merge transitions with different targets. This is unstable";
+              LEARNTA_LOG(debug) << "We merge transitions with different targets. This is unstable";
               // Check if this happens only when the imprecise clocks are different
               if (simpleVariables(it2->guard) == simpleVariables(it3->guard)) {
-                BOOST_LOG_TRIVIAL(debug) << "Moreover, the merged transitions have the same set of imprecise clocks";
-                BOOST_LOG_TRIVIAL(debug) << it2->guard << " " << it2->resetVars;
-                BOOST_LOG_TRIVIAL(debug) << it3->guard << " " << it3->resetVars;
+                LEARNTA_LOG(debug) << "Moreover, the merged transitions have the same set of imprecise clocks";
+                LEARNTA_LOG(debug) << it2->guard << " " << it2->resetVars;
+                LEARNTA_LOG(debug) << it3->guard << " " << it3->resetVars;
               }
             }
             *it2 = mergeTransitions(*it2, *it3);
@@ -255,24 +258,20 @@ namespace learnta {
     }
   }
 
-  void TAState::mergeNondeterministicBranching(const std::unordered_set<ClockVariables> &preciseClocks) {
+  void TAState::mergeNondeterministicBranching(const ClockSet &preciseClocks) {
     for (auto &[action, transitions]: this->next) {
       for (auto it2 = transitions.begin(); it2 != transitions.end(); ++it2) {
         for (auto it3 = std::next(it2); it3 != transitions.end();) {
           if (satisfiable(conjunction(it2->guard, it3->guard))) {
-            BOOST_LOG_TRIVIAL(debug) << "Try to merge the following with precise clocks: " << preciseClocks.size();
-            BOOST_LOG_TRIVIAL(debug) << it2->guard << " / " << it2->resetVars;
-            BOOST_LOG_TRIVIAL(debug) << it3->guard << " / " << it3->resetVars;
-            const auto preciseVariables2 = simpleVariables(it2->guard);
-            assert(is_ascending(preciseVariables2));
-            const auto preciseVariables3 = simpleVariables(it3->guard);
-            assert(is_ascending(preciseVariables3));
-            const bool allPrecise2 = std::all_of(preciseClocks.begin(), preciseClocks.end(), [&] (const auto& preciseClock) {
-              return std::binary_search(preciseVariables2.begin(), preciseVariables2.end(), preciseClock);
-            });
-            const bool allPrecise3 = std::all_of(preciseClocks.begin(), preciseClocks.end(), [&] (const auto& preciseClock) {
-              return std::binary_search(preciseVariables3.begin(), preciseVariables3.end(), preciseClock);
-            });
+            LEARNTA_LOG(debug) << "Try to merge the following with precise clocks: " << preciseClocks.size();
+            LEARNTA_LOG(debug) << it2->guard << " / " << it2->resetVars;
+            LEARNTA_LOG(debug) << it3->guard << " / " << it3->resetVars;
+            const auto simple2 = simpleVariables(it2->guard);
+            const ClockSet preciseVariables2{simple2.begin(), simple2.end()};
+            const auto simple3 = simpleVariables(it3->guard);
+            const ClockSet preciseVariables3{simple3.begin(), simple3.end()};
+            const bool allPrecise2 = (preciseClocks & preciseVariables2) == preciseClocks;
+            const bool allPrecise3 = (preciseClocks & preciseVariables3) == preciseClocks;
             if (allPrecise2 && !allPrecise3) {
               // We use it2 if it precisely captures the guard
               it3 = transitions.erase(it3);
@@ -290,9 +289,10 @@ namespace learnta {
             }
             bool use3 = false;
             bool same = true;
-            for (const auto &preciseClock: preciseClocks) {
-              bool preciseIn2 = std::binary_search(preciseVariables2.begin(), preciseVariables2.end(), preciseClock);
-              bool preciseIn3 = std::binary_search(preciseVariables3.begin(), preciseVariables3.end(), preciseClock);
+            // We decide by the smallest precise clock precise in only one of them
+            for (const auto preciseClock: preciseClocks) {
+              const bool preciseIn2 = preciseVariables2.contains(preciseClock);
+              const bool preciseIn3 = preciseVariables3.contains(preciseClock);
               if (preciseIn2 != preciseIn3) {
                 use3 = preciseIn3;
                 same = false;
@@ -314,7 +314,7 @@ namespace learnta {
               }
               it2->guard = unionHull(it2->guard, it3->guard);
             }
-            BOOST_LOG_TRIVIAL(debug) << it2->guard << " " << it2->resetVars << " is generated";
+            LEARNTA_LOG(debug) << it2->guard << " " << it2->resetVars << " is generated";
             it3 = transitions.erase(it3);
           } else {
             ++it3;
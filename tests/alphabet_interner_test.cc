@@ -0,0 +1,117 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/16.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <unordered_set>
+#include <boost/test/unit_test.hpp>
+
+#include "../include/alphabet_interner.hh"
+#include "../include/learner.hh"
+#include "../include/timed_automaton_runner.hh"
+#include "../include/timed_automata_equivalence_oracle.hh"
+#include "../examples/ota_json_parser.hh"
+
+#include "simple_automaton_fixture.hh"
+
+BOOST_AUTO_TEST_SUITE(AlphabetInternerTest)
+  using namespace learnta;
+
+  BOOST_AUTO_TEST_CASE(singleCharacter) {
+    AlphabetInterner interner{{"b", "a"}};
+    BOOST_CHECK_EQUAL('b', interner.at("b"));
+    BOOST_CHECK_EQUAL('a', interner.at("a"));
+    BOOST_CHECK_EQUAL("a", interner.label('a'));
+    BOOST_CHECK(interner.isIdentity());
+    BOOST_CHECK_EQUAL(2, interner.size());
+  }
+
+  BOOST_AUTO_TEST_CASE(multiCharacter) {
+    // The single-character labels keep their characters even if they come later
+    AlphabetInterner interner{{"press", "a", "release", "press"}};
+    BOOST_CHECK_EQUAL(3, interner.size());
+    BOOST_CHECK_EQUAL('a', interner.at("a"));
+    BOOST_CHECK_EQUAL('b', interner.at("press"));
+    BOOST_CHECK_EQUAL('c', interner.at("release"));
+    BOOST_CHECK_EQUAL("release", interner.label('c'));
+    BOOST_CHECK(!interner.isIdentity());
+    BOOST_CHECK_THROW(static_cast<void>(interner.at("hold")), std::out_of_range);
+    BOOST_CHECK_THROW(static_cast<void>(interner.label('d')), std::out_of_range);
+    // A new single-character label taken by a multi-character label is given another action
+    BOOST_CHECK_EQUAL('d', interner.intern("b"));
+  }
+
+  BOOST_AUTO_TEST_CASE(capacity) {
+    AlphabetInterner interner;
+    std::unordered_set<Alphabet> actions;
+    for (std::size_t i = 0; i < AlphabetInterner::capacity; ++i) {
+      const auto action = interner.intern("event" + std::to_string(i));
+      BOOST_CHECK_NE(UNOBSERVABLE, action);
+      actions.insert(action);
+    }
+    BOOST_CHECK_EQUAL(AlphabetInterner::capacity, actions.size());
+    BOOST_CHECK_EQUAL("event50", interner.label(interner.at("event50")));
+    BOOST_CHECK_THROW(interner.intern("overflow"), std::invalid_argument);
+    BOOST_CHECK_THROW(interner.intern("x"), std::invalid_argument);
+    BOOST_CHECK_THROW(AlphabetInterner{}.intern(""), std::invalid_argument);
+  }
+
+  //! @brief Every action is a printable character so that it can be written to the outputs without escaping
+  BOOST_AUTO_TEST_CASE(printableActions) {
+    AlphabetInterner interner{{"\n", "\"", "\\", " ", "\xc8", "a"}};
+    BOOST_CHECK_EQUAL(6, interner.size());
+    BOOST_CHECK_EQUAL('a', interner.at("a"));
+    for (const Alphabet action: interner.alphabet()) {
+      BOOST_CHECK(action >= '!' && action <= '~' && action != '"' && action != '\\');
+    }
+    BOOST_CHECK_EQUAL("\n", interner.label(interner.at("\n")));
+    BOOST_CHECK(!interner.isIdentity());
+  }
+
+  BOOST_AUTO_TEST_CASE(parseMultiCharacterLabels) {
+    const std::string path = "/tmp/alphabet_interner_test.json";
+    {
+      std::ofstream stream{path};
+      stream << R"json({"name": "A", "l": ["1", "2"], "sigma": ["press", "release"],
+                    "tran": {"0": ["1", "press", "(1,2)", "n", "2"],
+                             "1": ["1", "release", "[0,+)", "r", "1"],
+                             "2": ["2", "release", "[2,2]", "r", "2"]},
+                    "init": "1", "accept": ["2"]})json";
+    }
+    OtaJsonParser parser{path};
+    std::remove(path.c_str());
+    const auto &interner = parser.getInterner();
+    BOOST_CHECK(std::vector<Alphabet>({interner.at("press"), interner.at("release")}) == parser.getAlphabet());
+
+    TimedAutomatonRunner runner{parser.getTarget()};
+    runner.pre();
+    runner.step(1.5);
+    BOOST_CHECK(runner.step(interner.at("press")));
+    runner.step(0.5);
+    BOOST_CHECK(runner.step(interner.at("release")));
+    runner.post();
+  }
+
+  //! @brief The learning does not depend on the range of the actions, e.g., the negative values of char
+  BOOST_FIXTURE_TEST_CASE(learnOutOfCharMax, SimpleAutomatonFixture) {
+    const auto action = static_cast<Alphabet>(200);
+    const std::vector<Alphabet> alphabet = {action};
+    for (auto &state: automaton.states) {
+      state->next[action] = std::move(state->next.at('a'));
+      state->next.erase('a');
+    }
+    auto sul = std::unique_ptr<SUL>(new TimedAutomatonRunner{automaton});
+    auto memOracle = std::make_unique<SymbolicMembershipOracle>(std::move(sul));
+    auto complement = automaton.complement(alphabet);
+    auto eqOracle = std::unique_ptr<EquivalenceOracle>(
+            new ComplementTimedAutomataEquivalenceOracle{automaton, complement, alphabet});
+    Learner learner{alphabet, std::move(memOracle), std::move(eqOracle)};
+    const auto result = learner.run();
+
+    BOOST_CHECK_EQUAL(2, result.stateSize());
+    BOOST_CHECK(result.deterministic());
+  }
+
+BOOST_AUTO_TEST_SUITE_END()
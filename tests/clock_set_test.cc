@@ -0,0 +1,68 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/17.
+ */
+
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "../include/clock_set.hh"
+
+BOOST_AUTO_TEST_SUITE(ClockSetTest)
+  using namespace learnta;
+
+  BOOST_AUTO_TEST_CASE(insertErase) {
+    ClockSet clocks;
+    BOOST_CHECK(clocks.empty());
+    clocks.insert(3);
+    clocks.insert(64);
+    clocks.insert(255);
+    clocks.insert(3);
+    BOOST_CHECK_EQUAL(3, clocks.size());
+    BOOST_CHECK(clocks.contains(64));
+    BOOST_CHECK(!clocks.contains(63));
+    clocks.erase(64);
+    BOOST_CHECK(!clocks.contains(64));
+    BOOST_CHECK_EQUAL(2, clocks.size());
+  }
+
+  BOOST_AUTO_TEST_CASE(ascendingIteration) {
+    const std::vector<ClockVariables> clocks = {200, 0, 65, 7, 64};
+    const ClockSet set{clocks.begin(), clocks.end()};
+    const std::vector<ClockVariables> iterated{set.begin(), set.end()};
+    BOOST_CHECK(std::vector<ClockVariables>({0, 7, 64, 65, 200}) == iterated);
+    std::stringstream stream;
+    stream << ClockSet{1, 0};
+    BOOST_CHECK_EQUAL("{x0, x1}", stream.str());
+  }
+
+  BOOST_AUTO_TEST_CASE(range) {
+    BOOST_CHECK(ClockSet::range(0).empty());
+    BOOST_CHECK(ClockSet({0, 1, 2}) == ClockSet::range(3));
+    BOOST_CHECK_EQUAL(64, ClockSet::range(64).size());
+    BOOST_CHECK_EQUAL(100, ClockSet::range(100).size());
+    BOOST_CHECK(!ClockSet::range(100).contains(100));
+    BOOST_CHECK_EQUAL(256, ClockSet::range(256).size());
+  }
+
+  BOOST_AUTO_TEST_CASE(setOperations) {
+    const ClockSet left{1, 2, 70}, right{2, 3, 70, 130};
+    BOOST_CHECK(ClockSet({1, 2, 3, 70, 130}) == (left | right));
+    BOOST_CHECK(ClockSet({2, 70}) == (left & right));
+    BOOST_CHECK(left != right);
+    BOOST_CHECK(left < right || right < left);
+    BOOST_CHECK(!(left < left));
+  }
+
+  BOOST_AUTO_TEST_CASE(hashing) {
+    std::unordered_set<ClockSet> sets;
+    sets.insert(ClockSet{1, 2});
+    sets.insert(ClockSet{2, 1});
+    sets.insert(ClockSet{1});
+    BOOST_CHECK_EQUAL(2, sets.size());
+    BOOST_CHECK_EQUAL(hash_value(ClockSet{1, 2}), hash_value(ClockSet{2, 1}));
+  }
+
+BOOST_AUTO_TEST_SUITE_END()
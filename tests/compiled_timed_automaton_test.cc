@@ -0,0 +1,148 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/19.
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <unistd.h>
+#include <boost/test/unit_test.hpp>
+
+#include "../include/compiled_timed_automaton.hh"
+#include "../include/timed_automaton_runner.hh"
+
+#include "monitor_fixtures.hh"
+
+BOOST_AUTO_TEST_SUITE(CompiledTimedAutomatonTest)
+  using namespace learnta;
+
+  //! @brief A unique path of a file removed at the end of the test. The file does not exist at first.
+  struct CompiledPathFixture {
+    std::string path;
+
+    CompiledPathFixture() {
+      char name[] = "/tmp/learnta_compiled_XXXXXX";
+      close(mkstemp(name));
+      path = name;
+      std::remove(path.c_str());
+    }
+
+    ~CompiledPathFixture() {
+      std::remove(path.c_str());
+    }
+  };
+
+  std::string compile(const TimedAutomaton &automaton) {
+    std::stringstream stream;
+    CompiledTimedAutomaton::write(stream, automaton);
+    return stream.str();
+  }
+
+  //! @brief If the DTAs have the same states and transitions in the same order
+  bool sameStructure(const TimedAutomaton &left, const TimedAutomaton &right) {
+    if (left.stateSize() != right.stateSize() || left.maxConstraints != right.maxConstraints ||
+        left.initialStates.size() != right.initialStates.size()) {
+      return false;
+    }
+    std::unordered_map<const TAState *, std::size_t> leftIndex, rightIndex;
+    for (std::size_t i = 0; i < left.stateSize(); ++i) {
+      leftIndex[left.states.at(i).get()] = i;
+      rightIndex[right.states.at(i).get()] = i;
+    }
+    for (std::size_t i = 0; i < left.initialStates.size(); ++i) {
+      if (leftIndex.at(left.initialStates.at(i).get()) != rightIndex.at(right.initialStates.at(i).get())) {
+        return false;
+      }
+    }
+    for (std::size_t i = 0; i < left.stateSize(); ++i) {
+      const auto &leftState = left.states.at(i);
+      const auto &rightState = right.states.at(i);
+      if (leftState->isMatch != rightState->isMatch || leftState->next.size() != rightState->next.size()) {
+        return false;
+      }
+      for (const auto &[action, leftTransitions]: leftState->next) {
+        auto it = rightState->next.find(action);
+        if (it == rightState->next.end() || it->second.size() != leftTransitions.size()) {
+          return false;
+        }
+        for (std::size_t j = 0; j < leftTransitions.size(); ++j) {
+          const auto &leftTransition = leftTransitions.at(j);
+          const auto &rightTransition = it->second.at(j);
+          if (leftIndex.at(leftTransition.target) != rightIndex.at(rightTransition.target) ||
+              !(leftTransition.guard == rightTransition.guard) ||
+              leftTransition.resetVars != rightTransition.resetVars) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  BOOST_AUTO_TEST_CASE(roundTrip) {
+    for (const auto &fixture: makeMonitorFixtures()) {
+      const auto compiled = CompiledTimedAutomaton::fromBytes(compile(fixture.automaton));
+      BOOST_CHECK_EQUAL(fixture.automaton.stateSize(), compiled.stateSize());
+      const auto restored = compiled.toTimedAutomaton();
+      BOOST_CHECK_MESSAGE(sameStructure(fixture.automaton, restored), fixture.name << " is not restored");
+      // The format is deterministic
+      BOOST_CHECK(compile(fixture.automaton) == compile(restored));
+    }
+    const auto empty = CompiledTimedAutomaton::fromBytes(compile(TimedAutomaton{}));
+    BOOST_CHECK_EQUAL(0, empty.stateSize());
+    BOOST_CHECK_EQUAL(CompiledTimedAutomaton::noState, empty.initialState());
+  }
+
+  //! @brief The runners of the mapped file and of the original DTA behave the same on random timed words
+  BOOST_FIXTURE_TEST_CASE(mapAndRun, CompiledPathFixture) {
+    for (const auto &fixture: makeMonitorFixtures()) {
+      {
+        std::ofstream stream{path, std::ios::binary};
+        CompiledTimedAutomaton::write(stream, fixture.automaton);
+      }
+      const auto compiled = std::make_shared<const CompiledTimedAutomaton>(CompiledTimedAutomaton::map(path));
+      std::remove(path.c_str());
+      CompiledTimedAutomatonRunner runner{compiled};
+      const auto difference = findDifferenceFromRunner(fixture, runner, CompiledTimedAutomaton::noState, [&] {
+        runner.pre();
+      });
+      if (difference) {
+        BOOST_ERROR(fixture.name << " differs from TimedAutomatonRunner at the end of " << *difference);
+      }
+    }
+  }
+
+  BOOST_FIXTURE_TEST_CASE(broken, CompiledPathFixture) {
+    const auto bytes = compile(makeResetsAutomaton());
+    BOOST_CHECK_NO_THROW(CompiledTimedAutomaton::fromBytes(bytes));
+    // Truncated
+    BOOST_CHECK_THROW(CompiledTimedAutomaton::fromBytes(bytes.substr(0, bytes.size() - 8)), std::runtime_error);
+    BOOST_CHECK_THROW(CompiledTimedAutomaton::fromBytes(bytes.substr(0, 16)), std::runtime_error);
+    // Another version
+    auto anotherVersion = bytes;
+    anotherVersion.at(offsetof(CompiledTimedAutomaton::Header, version)) += 1;
+    BOOST_CHECK_THROW(CompiledTimedAutomaton::fromBytes(anotherVersion), std::runtime_error);
+    // Corrupted body
+    auto corrupted = bytes;
+    corrupted.at(bytes.size() - 20) ^= 1;
+    BOOST_CHECK_THROW(CompiledTimedAutomaton::fromBytes(corrupted), std::runtime_error);
+    BOOST_CHECK_THROW(CompiledTimedAutomaton::fromBytes("not a compiled timed automaton at all, surely"),
+                      std::runtime_error);
+    BOOST_CHECK_THROW(CompiledTimedAutomaton::map(path), std::runtime_error);
+  }
+
+  BOOST_FIXTURE_TEST_CASE(invalid, SimpleAutomatonFixture) {
+    std::stringstream stream;
+    auto unknownClock = automaton;
+    unknownClock.maxConstraints.clear();
+    BOOST_CHECK_THROW(CompiledTimedAutomaton::write(stream, unknownClock), std::invalid_argument);
+    auto twoInitialStates = automaton;
+    twoInitialStates.initialStates.push_back(automaton.states.at(1));
+    BOOST_CHECK_THROW(CompiledTimedAutomaton::write(stream, twoInitialStates), std::invalid_argument);
+  }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -55,4 +55,32 @@ BOOST_AUTO_TEST_SUITE(CounterexampleAnalyzerTest)
     BOOST_CHECK_EQUAL_COLLECTIONS(expectedDurations.begin(), expectedDurations.end(),
                                   result->getDurations().begin(), result->getDurations().end());
   }
+
+  BOOST_FIXTURE_TEST_CASE(analyzeCEXModes, SimpleAutomatonOracleFixture<1>) {
+    const ForwardRegionalElementaryLanguage initial;
+    std::vector<ElementaryLanguage> prefixes = {initial};
+    std::vector<ElementaryLanguage> final = prefixes;
+    std::vector<SingleMorphism> morphisms = {
+            SingleMorphism{initial.successor(), initial, RenamingRelation{}},
+            SingleMorphism{initial.successor('a'), initial, RenamingRelation{}}
+    };
+    const RecognizableLanguage hypothesis {prefixes, final, morphisms};
+    // A long counterexample reaching loc1 only at the end
+    std::vector<double> durations(32, 0.03125);
+    durations.at(30) = 0.5;
+    durations.at(31) = 0;
+    const TimedWord cex {std::string(31, 'a'), durations};
+    BOOST_REQUIRE(this->oracle->answerQuery(cex) != hypothesis.contains(cex));
+    const BackwardRegionalElementaryLanguage emptySuffix = BackwardRegionalElementaryLanguage::fromTimedWord(TimedWord{});
+    std::vector<std::size_t> numQueries;
+    for (const auto mode: {CEXAnalysisMode::LINEAR, CEXAnalysisMode::BINARY, CEXAnalysisMode::EXPONENTIAL}) {
+      const auto before = this->oracle->count();
+      const auto result = analyzeCEX(cex, *this->oracle, hypothesis, {emptySuffix}, mode);
+      numQueries.push_back(this->oracle->count() - before);
+      BOOST_REQUIRE(result.has_value());
+      BOOST_CHECK(!emptySuffix.contains(*result));
+    }
+    BOOST_CHECK_LT(numQueries.at(1), numQueries.at(0));
+    BOOST_CHECK_LT(numQueries.at(2), numQueries.at(0));
+  }
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
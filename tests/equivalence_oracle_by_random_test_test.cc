@@ -0,0 +1,51 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/05.
+ */
+
+#include <sstream>
+#include <boost/test/unit_test.hpp>
+
+#include "../include/equivalence_oracle_by_random_test.hh"
+#include "simple_automaton_fixture.hh"
+
+BOOST_AUTO_TEST_SUITE(EquivalenceOracleByRandomTestTest)
+  using namespace learnta;
+  struct Fixture : public SimpleAutomatonFixture, public UniversalAutomatonFixture {
+    const std::vector<Alphabet> alphabet = {'a'};
+  };
+
+  BOOST_FIXTURE_TEST_CASE(reproducible, Fixture) {
+    // The results depend only on the seed and not on the number of the threads
+    std::vector<std::vector<TimedWord>> results;
+    for (const std::size_t numThreads: {1, 2, 4}) {
+      EquivalenceOracleByRandomTest oracle{alphabet, automaton, 1000, 5, 2, 42, numThreads};
+      results.push_back(oracle.findCounterExamples(universalAutomaton, 3));
+      BOOST_CHECK(oracle.findCounterExample(universalAutomaton).has_value());
+    }
+    BOOST_REQUIRE_EQUAL(3, results.front().size());
+    for (const auto &result: results) {
+      BOOST_CHECK(result == results.front());
+    }
+  }
+
+  BOOST_FIXTURE_TEST_CASE(defaultSeed, Fixture) {
+    // The tests are made only of the bits of SplitMix64, whose values are fixed on every platform
+    SplitMix64 engine{0};
+    BOOST_CHECK_EQUAL(0xe220a8397b1dcdafULL, engine());
+    BOOST_CHECK_EQUAL(static_cast<double>(0x6e789e6aa1b965f4ULL >> 11) * 0x1.0p-53, engine.uniformReal());
+    // The default seed is fixed
+    EquivalenceOracleByRandomTest oracle{alphabet, automaton, 1000, 5, 2};
+    EquivalenceOracleByRandomTest another{alphabet, automaton, 1000, 5, 2};
+    BOOST_CHECK(oracle.findCounterExamples(universalAutomaton, 3) == another.findCounterExamples(universalAutomaton, 3));
+  }
+
+  BOOST_FIXTURE_TEST_CASE(noCounterExample, Fixture) {
+    EquivalenceOracleByRandomTest oracle{alphabet, automaton, 100, 5, 2, 42, 2};
+    BOOST_CHECK(!oracle.findCounterExample(automaton).has_value());
+    std::stringstream statistics;
+    oracle.printStatistics(statistics);
+    BOOST_CHECK(statistics.str().find("Number of random tests: 100") != std::string::npos);
+  }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,7 @@
  * @date 2023/01/08.
  */
 
+#include <sstream>
 #include <boost/test/unit_test.hpp>
 
 #include "../include/equivalence_oracle_by_test.hh"
@@ -26,4 +27,42 @@ BOOST_AUTO_TEST_SUITE(EquivalenceOracleByTestTest)
     std::vector<double> expectedDurations = {1.0, 0};
     BOOST_TEST(expectedDurations == counterexample.getDurations(), boost::test_tools::per_element());
   }
+
+  BOOST_FIXTURE_TEST_CASE(queryMany, Fixture) {
+    auto oracle = EquivalenceOracleByTest{this->automaton};
+    oracle.push_back(TimedWord{"aa", {1, 0.5, 0.5}});
+    // The same counter example as the first one after the minimization
+    oracle.push_back(TimedWord{"a", {1, 0}});
+    oracle.push_back(TimedWord{"aa", {0.5, 1, 0}});
+    oracle.push_back(TimedWord{"a", {0.5, 0.25}});
+
+    const auto counterexamples = oracle.findCounterExamples(this->universalAutomaton, 5);
+    BOOST_REQUIRE_EQUAL(2, counterexamples.size());
+    BOOST_CHECK_EQUAL("a", counterexamples.at(0).getWord());
+    BOOST_CHECK_EQUAL("aa", counterexamples.at(1).getWord());
+    BOOST_CHECK_EQUAL(1, oracle.findCounterExamples(this->universalAutomaton, 1).size());
+    BOOST_CHECK(oracle.findCounterExamples(this->automaton, 5).empty());
+  }
+
+  BOOST_FIXTURE_TEST_CASE(sharedPrefixes, Fixture) {
+    auto oracle = EquivalenceOracleByTest{this->automaton};
+    oracle.push_back(TimedWord{"aaa", {0.5, 0.2, 1, 0}});
+    oracle.push_back(TimedWord{"a", {1, 0}});
+    // This shares the prefix with the first word and it is found before the second one in the traversal
+    oracle.push_back(TimedWord{"aa", {0.5, 1, 0}});
+
+    // The counterexamples are in the order of the words
+    const auto counterexamples = oracle.findCounterExamples(this->universalAutomaton, 2);
+    BOOST_REQUIRE_EQUAL(2, counterexamples.size());
+    BOOST_CHECK_EQUAL(TimedWord("aaa", {0.5, 0.2, 1, 0}), counterexamples.at(0));
+    BOOST_CHECK_EQUAL(TimedWord("a", {1, 0}), counterexamples.at(1));
+    BOOST_CHECK_EQUAL(3, oracle.findCounterExamples(this->universalAutomaton, 5).size());
+
+    // The trie is rebuilt from a checkpoint
+    std::stringstream checkpoint;
+    oracle.save(checkpoint);
+    auto restored = EquivalenceOracleByTest{this->automaton};
+    restored.load(checkpoint);
+    BOOST_CHECK(counterexamples == restored.findCounterExamples(this->universalAutomaton, 2));
+  }
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,54 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/06.
+ */
+
+#include <sstream>
+#include <boost/test/unit_test.hpp>
+
+#define private public
+#include "../include/equivalence_oracle_by_zone_coverage.hh"
+#include "../include/membership_oracle.hh"
+#include "simple_automaton_fixture.hh"
+
+BOOST_AUTO_TEST_SUITE(EquivalenceOracleByZoneCoverageTest)
+  using namespace learnta;
+  struct Fixture : public SimpleAutomatonFixture {
+    const std::vector<Alphabet> alphabet = {'a'};
+    // The DTA different from the simple one only when x = 1 at loc1
+    TimedAutomaton boundaryAutomaton;
+
+    Fixture() {
+      std::unordered_map<TAState *, std::shared_ptr<TAState>> old2new;
+      automaton.deepCopy(boundaryAutomaton, old2new);
+      auto &transitions = old2new.at(automaton.states.at(1).get())->next['a'];
+      transitions.at(0).guard = {ConstraintMaker(0) < 1};
+      transitions.at(1).guard = {ConstraintMaker(0) >= 1};
+    }
+  };
+
+  BOOST_FIXTURE_TEST_CASE(boundary, Fixture) {
+    EquivalenceOracleByZoneCoverage oracle{alphabet, automaton, 1000, 5, 42};
+    const auto counterExample = oracle.findCounterExample(boundaryAutomaton);
+    BOOST_REQUIRE(counterExample.has_value());
+    SULMembershipOracle oracleOfTarget{std::make_unique<TimedAutomatonRunner>(automaton)};
+    SULMembershipOracle oracleOfHypothesis{std::make_unique<TimedAutomatonRunner>(boundaryAutomaton)};
+    BOOST_CHECK_NE(oracleOfTarget.answerQuery(*counterExample), oracleOfHypothesis.answerQuery(*counterExample));
+  }
+
+  BOOST_FIXTURE_TEST_CASE(saturation, Fixture) {
+    EquivalenceOracleByZoneCoverage oracle{alphabet, automaton, 100000, 100, 42};
+    BOOST_CHECK(!oracle.findCounterExample(automaton).has_value());
+    std::stringstream statistics;
+    oracle.printStatistics(statistics);
+    // The testing stops far before the limits because the coverage saturates
+    BOOST_CHECK_LT(oracle.numTests, 100000);
+    BOOST_CHECK_LT(oracle.numRounds, 100);
+    BOOST_CHECK_EQUAL(oracle.numCoveredSymbolicStates, oracle.numSymbolicStates);
+    // Only the boundaries actually reached by the covering tests are counted
+    BOOST_CHECK_GT(oracle.numCoveredBoundaries, 0);
+    BOOST_CHECK_LE(oracle.numCoveredBoundaries, oracle.numBoundaries);
+    BOOST_CHECK(statistics.str().find("Symbolic states covered by the zone-coverage tests") != std::string::npos);
+  }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,143 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/05.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <boost/test/unit_test.hpp>
+
+#include "../include/equivalence_oracle_concurrent_chain.hh"
+#include "../include/equivalence_oracle_by_test.hh"
+#include "../include/equivalence_oracle_by_zone_coverage.hh"
+#include "../include/equivalence_oracle_memo.hh"
+#include "../include/timed_automata_equivalence_oracle.hh"
+#include "simple_automaton_fixture.hh"
+
+BOOST_AUTO_TEST_SUITE(EquivalenceOracleConcurrentChainTest)
+  using namespace learnta;
+
+  //! @brief An oracle finding no counterexample until it is cancelled
+  class NeverEndingOracle : public EquivalenceOracle {
+  public:
+    std::atomic<bool> &wasCancelled;
+
+    explicit NeverEndingOracle(std::atomic<bool> &wasCancelled) : wasCancelled(wasCancelled) {}
+
+    std::optional<TimedWord> findCounterExample(const TimedAutomaton &) override {
+      ++eqQueryCount;
+      while (!isCancelled()) {
+        std::this_thread::yield();
+      }
+      wasCancelled = true;
+      return std::nullopt;
+    }
+  };
+
+  struct Fixture : public SimpleAutomatonFixture, public UniversalAutomatonFixture {
+  };
+
+  BOOST_FIXTURE_TEST_CASE(firstResultWins, Fixture) {
+    std::atomic<bool> wasCancelled{false};
+    EquivalenceOracleConcurrentChain chain;
+    chain.push_back(std::make_unique<NeverEndingOracle>(wasCancelled));
+    auto byTest = std::make_unique<EquivalenceOracleByTest>(this->automaton);
+    byTest->push_back(TimedWord{"a", {1, 0}});
+    chain.push_back(std::move(byTest));
+
+    const auto counterexample = chain.findCounterExample(this->universalAutomaton);
+    BOOST_REQUIRE(counterexample.has_value());
+    BOOST_CHECK_EQUAL("a", counterexample->getWord());
+    BOOST_CHECK(wasCancelled);
+    // The chain is reusable
+    wasCancelled = false;
+    BOOST_CHECK(chain.findCounterExample(this->universalAutomaton).has_value());
+    BOOST_CHECK(wasCancelled);
+    BOOST_CHECK_EQUAL(2, chain.numEqQueries());
+  }
+
+  BOOST_FIXTURE_TEST_CASE(manyCounterExamples, Fixture) {
+    std::atomic<bool> wasCancelled{false};
+    EquivalenceOracleConcurrentChain chain;
+    chain.push_back(std::make_unique<NeverEndingOracle>(wasCancelled));
+    auto byTest = std::make_unique<EquivalenceOracleByTest>(this->automaton);
+    byTest->push_back(TimedWord{"a", {1, 0}});
+    byTest->push_back(TimedWord{"a", {1.5, 0}});
+    byTest->push_back(TimedWord{"a", {2, 0}});
+    chain.push_back(std::move(byTest));
+
+    // The maximum number of the counterexamples is passed to the oracles
+    BOOST_CHECK_EQUAL(2, chain.findCounterExamples(this->universalAutomaton, 2).size());
+    BOOST_CHECK(wasCancelled);
+  }
+
+  BOOST_FIXTURE_TEST_CASE(noCounterExample, Fixture) {
+    EquivalenceOracleConcurrentChain chain;
+    for (int i = 0; i < 3; ++i) {
+      auto byTest = std::make_unique<EquivalenceOracleByTest>(this->automaton);
+      byTest->push_back(TimedWord{"a", {0.5, 0}});
+      chain.push_back(std::move(byTest));
+    }
+    BOOST_CHECK(!chain.findCounterExample(this->automaton).has_value());
+  }
+
+  //! @brief Cancelling the whole query cancels the running oracles
+  BOOST_AUTO_TEST_CASE(cancelledFromOutside) {
+    std::atomic<bool> wasCancelled{false};
+    std::atomic<bool> cancelled{false};
+    EquivalenceOracleConcurrentChain chain;
+    chain.push_back(std::make_unique<NeverEndingOracle>(wasCancelled));
+    chain.setCancellation(&cancelled);
+    std::optional<TimedWord> counterExample;
+    std::thread query{[&] {
+      counterExample = chain.findCounterExample(TimedAutomaton{});
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    cancelled = true;
+    query.join();
+    BOOST_CHECK(wasCancelled);
+    BOOST_CHECK(!counterExample.has_value());
+  }
+
+  /*!
+   * @brief The complement oracle and the test oracle share the states of the hypothesis and the target
+   *
+   * The complement oracle must not modify them while the test oracle runs them on another thread.
+   */
+  BOOST_FIXTURE_TEST_CASE(complementAndTest, Fixture) {
+    const std::vector<Alphabet> alphabet = {'a'};
+    const auto hypothesis = this->automaton;
+    EquivalenceOracleConcurrentChain chain;
+    chain.push_back(std::make_unique<ComplementTimedAutomataEquivalenceOracle>(
+            this->automaton, this->automaton.complement(alphabet), alphabet));
+    auto byTest = std::make_unique<EquivalenceOracleByTest>(this->automaton);
+    for (int i = 0; i < 100; ++i) {
+      byTest->push_back(TimedWord{"aaa", {0.25 * i, 0.5, 1, 0}});
+    }
+    chain.push_back(std::move(byTest));
+
+    for (int i = 0; i < 10; ++i) {
+      BOOST_CHECK(!chain.findCounterExample(hypothesis).has_value());
+    }
+    for (const auto &state: this->automaton.states) {
+      BOOST_CHECK(state->next.find(UNOBSERVABLE) == state->next.end());
+    }
+    BOOST_CHECK(chain.findCounterExample(this->universalAutomaton).has_value());
+  }
+
+  //! @brief The statistics of the chained oracles reach the output through EquivalenceOracleMemo
+  BOOST_FIXTURE_TEST_CASE(statistics, Fixture) {
+    auto chain = std::make_unique<EquivalenceOracleConcurrentChain>();
+    chain->push_back(std::make_unique<EquivalenceOracleByZoneCoverage>(std::vector<Alphabet>{'a'}, this->automaton,
+                                                                       10, 2, 0));
+    EquivalenceOracleMemo memo{std::move(chain), this->automaton};
+    static_cast<void>(memo.findCounterExample(this->universalAutomaton));
+    std::stringstream stream;
+    memo.printStatistics(stream);
+    BOOST_CHECK(stream.str().find("Number of counterexamples found by each concurrent oracle: 1") != std::string::npos);
+    BOOST_CHECK(stream.str().find("Number of zone-coverage tests: ") != std::string::npos);
+  }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,32 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/18.
+ * @brief Generates the monitors of the DTAs in monitor_fixtures.hh for the test and the benchmark
+ */
+
+#include <fstream>
+#include <iostream>
+#include <string>
+// The fixtures of the DTAs use the assertions of Boost.Test
+#include <boost/test/unit_test.hpp>
+
+#include "../include/monitor_code_generator.hh"
+#include "monitor_fixtures.hh"
+
+int main(int argc, const char *argv[]) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " OUTPUT_DIRECTORY" << std::endl;
+    return 2;
+  }
+  for (const auto &fixture: makeMonitorFixtures()) {
+    const std::string path = std::string{argv[1]} + "/" + fixture.name + ".hh";
+    std::ofstream stream{path};
+    if (!stream) {
+      std::cerr << "Failed to open " << path << std::endl;
+      return 1;
+    }
+    learnta::generateMonitor(stream, fixture.automaton, fixture.name);
+  }
+
+  return 0;
+}
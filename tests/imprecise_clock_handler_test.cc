@@ -14,7 +14,7 @@ BOOST_AUTO_TEST_SUITE(ImpreciseClockHandlerTest)
     TATransition::Resets resets;
     resets.emplace_back(static_cast<ClockVariables>(0), static_cast<ClockVariables>(8));
     resets.emplace_back(static_cast<ClockVariables>(1), static_cast<ClockVariables>(7));
-    std::unordered_set<ClockVariables> preciseClocks = {1};
+    ClockSet preciseClocks = {1};
     std::vector<double> valuation = {2.5, 2.0, 1.5};
     TATransition::Resets expectedResets;
     expectedResets.emplace_back(static_cast<ClockVariables>(1), static_cast<ClockVariables>(7));
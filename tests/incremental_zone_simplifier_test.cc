@@ -0,0 +1,110 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/20.
+ */
+
+#include <sstream>
+#include <unordered_map>
+#include <boost/test/unit_test.hpp>
+
+#include "../include/incremental_zone_simplifier.hh"
+#include "../include/random_timed_automaton_generator.hh"
+
+BOOST_AUTO_TEST_SUITE(IncrementalZoneSimplifierTest)
+  using namespace learnta;
+
+  TimedAutomaton copy(const TimedAutomaton &automaton) {
+    TimedAutomaton result;
+    std::unordered_map<TAState *, std::shared_ptr<TAState>> old2new;
+    automaton.deepCopy(result, old2new);
+    return result;
+  }
+
+  std::string toBytes(const TimedAutomaton &automaton) {
+    std::ostringstream stream;
+    CompiledTimedAutomaton::write(stream, automaton);
+    return stream.str();
+  }
+
+  //! @brief The result of the simplification from scratch
+  std::string simplifiedFromScratch(const TimedAutomaton &automaton) {
+    auto result = copy(automaton);
+    result.simplifyWithZones();
+    return toBytes(result);
+  }
+
+  std::string simplify(IncrementalZoneSimplifier &simplifier, const TimedAutomaton &automaton) {
+    auto result = copy(automaton);
+    simplifier.simplify(result);
+    return toBytes(result);
+  }
+
+  //! @brief A copy of the automaton with the acceptance of the state and the target of its first transition changed
+  TimedAutomaton mutate(const TimedAutomaton &automaton, std::size_t index) {
+    auto result = copy(automaton);
+    auto &state = result.states.at(index);
+    state->isMatch = !state->isMatch;
+    auto &transition = state->next.begin()->second.front();
+    const auto target = std::find_if(result.states.begin(), result.states.end(), [&](const auto &candidate) {
+      return candidate.get() == transition.target;
+    }) - result.states.begin();
+    transition.target = result.states.at((target + 1) % result.stateSize()).get();
+    return result;
+  }
+
+  TimedAutomaton generate(std::uint64_t seed) {
+    RandomTimedAutomatonParameters parameters;
+    parameters.numStates = 6;
+    parameters.numClocks = 2;
+    parameters.maxConstant = 3;
+    parameters.seed = seed;
+    return RandomTimedAutomatonGenerator{parameters}.generate();
+  }
+
+  BOOST_AUTO_TEST_CASE(memoHit) {
+    const auto automaton = generate(0);
+    IncrementalZoneSimplifier simplifier;
+    BOOST_CHECK(simplifiedFromScratch(automaton) == simplify(simplifier, automaton));
+    BOOST_CHECK_EQUAL(0, simplifier.getNumReusedHypotheses());
+    BOOST_CHECK(simplifiedFromScratch(automaton) == simplify(simplifier, automaton));
+    BOOST_CHECK_EQUAL(1, simplifier.getNumReusedHypotheses());
+    BOOST_CHECK_EQUAL(0, simplifier.getNumReusedZones());
+  }
+
+  BOOST_AUTO_TEST_CASE(changedHypothesisMisses) {
+    const auto automaton = generate(1);
+    const auto changed = mutate(automaton, automaton.stateSize() - 1);
+    IncrementalZoneSimplifier simplifier;
+    simplify(simplifier, automaton);
+    BOOST_CHECK(simplifiedFromScratch(changed) == simplify(simplifier, changed));
+    BOOST_CHECK_EQUAL(0, simplifier.getNumReusedHypotheses());
+    // At least the initial zone is reused because the initial state is not changed
+    BOOST_CHECK_GT(simplifier.getNumReusedZones(), 0);
+    // The memo is updated to the changed hypothesis
+    BOOST_CHECK(simplifiedFromScratch(changed) == simplify(simplifier, changed));
+    BOOST_CHECK_EQUAL(1, simplifier.getNumReusedHypotheses());
+  }
+
+  BOOST_AUTO_TEST_CASE(sameAsFromScratch) {
+    for (std::uint64_t seed = 0; seed < 10; ++seed) {
+      auto automaton = generate(seed);
+      IncrementalZoneSimplifier simplifier;
+      BOOST_CHECK(simplifiedFromScratch(automaton) == simplify(simplifier, automaton));
+      for (std::size_t i = 1; i < automaton.stateSize(); ++i) {
+        automaton = mutate(automaton, (seed + i) % automaton.stateSize());
+        BOOST_CHECK(simplifiedFromScratch(automaton) == simplify(simplifier, automaton));
+      }
+    }
+  }
+
+  BOOST_AUTO_TEST_CASE(changedMaxConstraints) {
+    const auto automaton = generate(2);
+    auto changed = copy(automaton);
+    ++changed.maxConstraints.front();
+    IncrementalZoneSimplifier simplifier;
+    simplify(simplifier, automaton);
+    BOOST_CHECK(simplifiedFromScratch(changed) == simplify(simplifier, changed));
+    // The zones depend on the maximum constants
+    BOOST_CHECK_EQUAL(0, simplifier.getNumReusedZones());
+  }
+BOOST_AUTO_TEST_SUITE_END()
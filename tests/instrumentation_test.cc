@@ -0,0 +1,87 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/10.
+ */
+
+#include <sstream>
+#include <boost/test/unit_test.hpp>
+
+#include "../include/instrumentation.hh"
+#include "../include/thread_pool.hh"
+
+BOOST_AUTO_TEST_SUITE(InstrumentationTest)
+  using namespace learnta;
+
+  BOOST_AUTO_TEST_CASE(timerAndCounter) {
+    auto &instrumentation = Instrumentation::global();
+    auto &timer = instrumentation.timer("test.timer");
+    for (int i = 0; i < 2; ++i) {
+      Instrumentation::ScopedTimer scopedTimer{timer};
+    }
+    instrumentation.counter("test.counter") += 3;
+    // The same entry is returned for the same name
+    instrumentation.counter("test.counter") += 4;
+
+    const auto snapshot = instrumentation.snapshot();
+    BOOST_CHECK_EQUAL(2, snapshot.timers.at("test.timer").count);
+    BOOST_CHECK_GE(snapshot.timers.at("test.timer").seconds, 0);
+    BOOST_CHECK_EQUAL(7, snapshot.counters.at("test.counter"));
+
+    instrumentation.reset();
+    const auto resetSnapshot = instrumentation.snapshot();
+    BOOST_CHECK_EQUAL(0, resetSnapshot.timers.at("test.timer").count);
+    BOOST_CHECK_EQUAL(0, resetSnapshot.counters.at("test.counter"));
+  }
+
+  BOOST_AUTO_TEST_CASE(histogram) {
+    auto &instrumentation = Instrumentation::global();
+    auto &histogram = instrumentation.histogram("test.histogram");
+    for (const std::uint64_t value: {0, 1, 2, 3, 4, 100}) {
+      histogram.record(value);
+    }
+
+    const auto value = instrumentation.snapshot().histograms.at("test.histogram");
+    BOOST_CHECK_EQUAL(6, value.count);
+    BOOST_CHECK_EQUAL(110, value.sum);
+    BOOST_CHECK_EQUAL(100, value.max);
+    const std::map<std::uint64_t, std::uint64_t> expectedBuckets{{1, 1}, {2, 1}, {4, 2}, {8, 1}, {128, 1}};
+    BOOST_CHECK(expectedBuckets == value.buckets);
+    instrumentation.reset();
+  }
+
+  BOOST_AUTO_TEST_CASE(printJson) {
+    Instrumentation::Snapshot snapshot;
+    snapshot.timers["a.timer"] = {2, 0.5};
+    snapshot.counters["a.counter"] = 3;
+    snapshot.histograms["a.histogram"] = {2, 5, 4, {{2, 1}, {8, 1}}};
+    std::stringstream stream;
+    snapshot.printJson(stream);
+    BOOST_CHECK_EQUAL("{\"timers\":{\"a.timer\":{\"count\":2,\"seconds\":0.5}},"
+                      "\"counters\":{\"a.counter\":3},"
+                      "\"histograms\":{\"a.histogram\":{\"count\":2,\"sum\":5,\"max\":4,"
+                      "\"buckets\":{\"<2\":1,\"<8\":1}}}}", stream.str());
+  }
+
+  BOOST_AUTO_TEST_CASE(macros) {
+    ThreadPool pool{4};
+    pool.parallelFor(1000, [](std::size_t i) {
+      LEARNTA_SCOPED_TIMER("test.macro_timer");
+      LEARNTA_COUNT("test.macro_counter", 2);
+      LEARNTA_RECORD("test.macro_histogram", i);
+    });
+    const auto snapshot = Instrumentation::global().snapshot();
+    if constexpr (Instrumentation::enabled) {
+      BOOST_CHECK_EQUAL(1000, snapshot.timers.at("test.macro_timer").count);
+      BOOST_CHECK_EQUAL(2000, snapshot.counters.at("test.macro_counter"));
+      BOOST_CHECK_EQUAL(1000, snapshot.histograms.at("test.macro_histogram").count);
+      BOOST_CHECK_EQUAL(999, snapshot.histograms.at("test.macro_histogram").max);
+    } else {
+      // Nothing is registered without LEARNTA_INSTRUMENTATION
+      BOOST_CHECK(snapshot.timers.find("test.macro_timer") == snapshot.timers.end());
+      BOOST_CHECK(snapshot.counters.find("test.macro_counter") == snapshot.counters.end());
+      BOOST_CHECK(snapshot.histograms.find("test.macro_histogram") == snapshot.histograms.end());
+    }
+    Instrumentation::global().reset();
+  }
+
+BOOST_AUTO_TEST_SUITE_END()
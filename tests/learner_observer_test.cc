@@ -0,0 +1,147 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/12.
+ */
+
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <boost/test/unit_test.hpp>
+
+#include "../include/async_reporter.hh"
+#include "../include/learner.hh"
+#include "../include/timed_automaton_runner.hh"
+#include "../include/timed_automata_equivalence_oracle.hh"
+
+#include "simple_automaton_fixture.hh"
+
+BOOST_AUTO_TEST_SUITE(LearnerObserverTest)
+  using namespace learnta;
+
+  BOOST_AUTO_TEST_CASE(ringFull) {
+    SPSCRing<int, 4> ring;
+    BOOST_CHECK(ring.empty());
+    for (int i = 0; i < 4; ++i) {
+      BOOST_CHECK(ring.tryPush(i));
+    }
+    BOOST_CHECK(!ring.tryPush(4));
+    for (int i = 0; i < 4; ++i) {
+      BOOST_CHECK_EQUAL(i, ring.tryPop().value());
+    }
+    BOOST_CHECK(!ring.tryPop());
+    BOOST_CHECK(ring.tryPush(5));
+    BOOST_CHECK_EQUAL(5, ring.tryPop().value());
+  }
+
+  BOOST_AUTO_TEST_CASE(ringTwoThreads) {
+    SPSCRing<std::size_t, 64> ring;
+    constexpr std::size_t size = 100000;
+    std::thread producer([&] {
+      for (std::size_t i = 0; i < size; ++i) {
+        while (!ring.tryPush(i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+    // The elements are popped in the pushed order
+    std::size_t expected = 0;
+    while (expected < size) {
+      if (auto value = ring.tryPop()) {
+        BOOST_REQUIRE_EQUAL(expected, *value);
+        ++expected;
+      }
+    }
+    producer.join();
+    BOOST_CHECK(ring.empty());
+  }
+
+  BOOST_AUTO_TEST_CASE(reporterToSocket) {
+    int fds[2];
+    BOOST_REQUIRE_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    {
+      AsyncReporter reporter{fds[0], true};
+      LearnerEvent event{};
+      event.kind = LearnerEvent::Kind::HYPOTHESIS;
+      event.iteration = 1;
+      event.time = 2;
+      event.numMembershipQueries = 10;
+      event.numStates = 3;
+      reporter.notify(event);
+      event.kind = LearnerEvent::Kind::MEMBERSHIP_BATCH;
+      event.time = 4;
+      event.numMembershipQueries = 30;
+      event.numCells = 5;
+      reporter.notify(event);
+      // The destructor writes the remaining events
+    }
+    std::string received;
+    char buffer[1024];
+    ssize_t size;
+    while ((size = read(fds[1], buffer, sizeof(buffer))) > 0) {
+      received.append(buffer, size);
+    }
+    close(fds[1]);
+    std::stringstream stream{received};
+    std::string line;
+    std::getline(stream, line);
+    BOOST_CHECK_EQUAL("{\"event\":\"hypothesis\",\"iteration\":1,\"time\":2,\"duration\":0,\"p\":0,\"prefixes\":0,"
+                      "\"suffixes\":0,\"membership_queries\":10,\"queries_per_second\":5,\"states\":3,"
+                      "\"transitions\":0}", line);
+    std::getline(stream, line);
+    BOOST_CHECK_EQUAL("{\"event\":\"membership_batch\",\"iteration\":1,\"time\":4,\"duration\":0,\"p\":0,"
+                      "\"prefixes\":0,\"suffixes\":0,\"membership_queries\":30,\"queries_per_second\":10,"
+                      "\"cells\":5}", line);
+    BOOST_CHECK(!std::getline(stream, line));
+  }
+
+  struct RecordingObserver : public LearnerObserver {
+    std::vector<LearnerEvent> events;
+
+    void notify(const LearnerEvent &event) override {
+      events.push_back(event);
+    }
+
+    [[nodiscard]] std::size_t count(LearnerEvent::Kind kind) const {
+      return std::count_if(events.begin(), events.end(), [&](const LearnerEvent &event) {
+        return event.kind == kind;
+      });
+    }
+  };
+
+  BOOST_FIXTURE_TEST_CASE(learnerEvents, SimpleAutomatonFixture) {
+    ComplementSimpleAutomatonFixture complementFixture;
+    const std::vector<Alphabet> alphabet = {'a'};
+    auto sul = std::unique_ptr<SUL>(new TimedAutomatonRunner{automaton});
+    auto memOracle = std::make_unique<SymbolicMembershipOracle>(std::move(sul));
+    auto eqOracle = std::unique_ptr<EquivalenceOracle>(
+            new ComplementTimedAutomataEquivalenceOracle{automaton, complementFixture.complementAutomaton, alphabet});
+    Learner learner{alphabet, std::move(memOracle), std::move(eqOracle)};
+    auto observer = std::make_shared<RecordingObserver>();
+    learner.addObserver(observer);
+    const auto result = learner.run();
+
+    const auto numHypotheses = observer->count(LearnerEvent::Kind::HYPOTHESIS);
+    BOOST_CHECK_EQUAL(learner.numEqQueries(), numHypotheses);
+    BOOST_CHECK_EQUAL(numHypotheses, observer->count(LearnerEvent::Kind::TABLE_CLOSED));
+    BOOST_CHECK_EQUAL(numHypotheses - 1, observer->count(LearnerEvent::Kind::COUNTER_EXAMPLE));
+    BOOST_CHECK_GT(observer->count(LearnerEvent::Kind::MEMBERSHIP_BATCH), 0);
+    // The last event is the hypothesis equivalent to the target
+    BOOST_REQUIRE(!observer->events.empty());
+    const auto &last = observer->events.back();
+    BOOST_CHECK(LearnerEvent::Kind::HYPOTHESIS == last.kind);
+    BOOST_CHECK_EQUAL(numHypotheses, last.iteration);
+    BOOST_CHECK_EQUAL(result.stateSize(), last.numStates);
+    // The events are in the temporal order
+    BOOST_CHECK(std::is_sorted(observer->events.begin(), observer->events.end(), [](const auto &left, const auto &right) {
+      return left.time < right.time;
+    }));
+    // The cells filled in the batches are all the filled cells
+    std::size_t numCells = 0;
+    for (const auto &event: observer->events) {
+      numCells += event.numCells;
+    }
+    BOOST_CHECK_GT(numCells, 0);
+  }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,40 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/14.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "../include/logging.hh"
+
+BOOST_AUTO_TEST_SUITE(LoggingTest)
+  using namespace learnta;
+
+  BOOST_AUTO_TEST_CASE(levels) {
+    BOOST_CHECK(logEnabled(boost::log::trivial::fatal));
+    BOOST_CHECK_EQUAL(LEARNTA_MIN_LOG_LEVEL <= LEARNTA_LOG_LEVEL_DEBUG, logEnabled(boost::log::trivial::debug));
+    BOOST_CHECK(!logEnabled(boost::log::trivial::debug) || logEnabled(boost::log::trivial::info));
+  }
+
+  BOOST_AUTO_TEST_CASE(arguments) {
+    int evaluated = 0;
+    const auto count = [&] {
+      return ++evaluated;
+    };
+    LEARNTA_LOG(trace) << "trace " << count();
+    LEARNTA_LOG(fatal) << "fatal " << count();
+    // The arguments are evaluated only if the statement is compiled
+    BOOST_CHECK_EQUAL(logEnabled(boost::log::trivial::trace) ? 2 : 1, evaluated);
+  }
+
+  BOOST_AUTO_TEST_CASE(danglingElse) {
+    bool elseTaken = false;
+    const bool condition = false;
+    if (condition)
+      LEARNTA_LOG(trace) << "never";
+    else
+      elseTaken = true;
+    BOOST_CHECK(elseTaken);
+  }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,88 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/18.
+ */
+
+#include <sstream>
+#include <boost/test/unit_test.hpp>
+
+#include "../include/monitor_code_generator.hh"
+#include "../include/timed_automaton_runner.hh"
+
+#include "monitor_fixtures.hh"
+// Generated from monitor_fixtures.hh by generate_test_monitors
+#include "generated_monitors/SimpleMonitor.hh"
+#include "generated_monitors/ComplementSimpleMonitor.hh"
+#include "generated_monitors/UnobservableMonitor.hh"
+#include "generated_monitors/TwoUnobservableMonitor.hh"
+#include "generated_monitors/UnbalancedHypothesisMonitor.hh"
+#include "generated_monitors/ResetsMonitor.hh"
+#include "generated_monitors/RandomMonitor4.hh"
+#include "generated_monitors/RandomMonitor16.hh"
+#include "generated_monitors/RandomMonitor64.hh"
+
+BOOST_AUTO_TEST_SUITE(MonitorCodeGeneratorTest)
+  using namespace learnta;
+
+  const MonitorFixture &findFixture(const std::string &name) {
+    static const auto fixtures = makeMonitorFixtures();
+    return *std::find_if(fixtures.begin(), fixtures.end(), [&](const MonitorFixture &fixture) {
+      return fixture.name == name;
+    });
+  }
+
+  //! @brief Execute the monitor and TimedAutomatonRunner on the same random timed words and compare them
+  template<class Monitor>
+  void compareWithRunner(const std::string &name) {
+    Monitor monitor;
+    const auto difference = findDifferenceFromRunner(findFixture(name), monitor, Monitor::sink, [&] {
+      monitor.reset();
+    });
+    if (difference) {
+      BOOST_ERROR(name << " differs from TimedAutomatonRunner at the end of " << *difference);
+    }
+  }
+
+  BOOST_AUTO_TEST_CASE(simple) {
+    compareWithRunner<SimpleMonitor>("SimpleMonitor");
+    compareWithRunner<ComplementSimpleMonitor>("ComplementSimpleMonitor");
+  }
+
+  BOOST_AUTO_TEST_CASE(unobservable) {
+    compareWithRunner<UnobservableMonitor>("UnobservableMonitor");
+    compareWithRunner<TwoUnobservableMonitor>("TwoUnobservableMonitor");
+    compareWithRunner<UnbalancedHypothesisMonitor>("UnbalancedHypothesisMonitor");
+  }
+
+  BOOST_AUTO_TEST_CASE(resets) {
+    compareWithRunner<ResetsMonitor>("ResetsMonitor");
+  }
+
+  BOOST_AUTO_TEST_CASE(random) {
+    compareWithRunner<RandomMonitor4>("RandomMonitor4");
+    compareWithRunner<RandomMonitor16>("RandomMonitor16");
+    compareWithRunner<RandomMonitor64>("RandomMonitor64");
+  }
+
+  BOOST_AUTO_TEST_CASE(guardFolding) {
+    std::stringstream stream;
+    generateMonitor(stream, makeResetsAutomaton(), "ResetsMonitor");
+    const auto code = stream.str();
+    // x0 <= 3 is implied by x0 < 2, and x0 >= 2 is implied by x0 > 2
+    BOOST_CHECK(code.find("clocks[0] < 2") != std::string::npos);
+    BOOST_CHECK(code.find("clocks[0] <= 3") == std::string::npos);
+    BOOST_CHECK(code.find("clocks[0] > 2") != std::string::npos);
+    BOOST_CHECK(code.find("clocks[0] >= 2)") == std::string::npos);
+  }
+
+  BOOST_FIXTURE_TEST_CASE(invalid, SimpleAutomatonFixture) {
+    std::stringstream stream;
+    auto twoInitialStates = automaton;
+    twoInitialStates.initialStates.push_back(automaton.states.at(1));
+    BOOST_CHECK_THROW(generateMonitor(stream, twoInitialStates, "Monitor"), std::invalid_argument);
+    auto unknownClock = automaton;
+    unknownClock.maxConstraints.clear();
+    BOOST_CHECK_THROW(generateMonitor(stream, unknownClock, "Monitor"), std::invalid_argument);
+  }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,126 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/18.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../include/split_mix64.hh"
+#include "../include/timed_automaton.hh"
+#include "../include/timed_automaton_runner.hh"
+
+#include "random_monitor_fixture.hh"
+#include "simple_automaton_fixture.hh"
+#include "unbalanced_fixture.hh"
+#include "unobservable_automaton_fixture.hh"
+
+/*!
+ * @brief A DTA using the features not in the other fixtures
+ *
+ * It has the resets to clock variables and non-zero constants, the redundant constraints, the nondeterministic
+ * unobservable transitions, and the actions not representable as ordinary character literals.
+ */
+inline learnta::TimedAutomaton makeResetsAutomaton() {
+  using namespace learnta;
+  const auto quote = '\'';
+  const auto extended = static_cast<Alphabet>(200);
+  TimedAutomaton automaton;
+  for (int i = 0; i < 3; ++i) {
+    automaton.states.push_back(std::make_shared<TAState>(i != 1));
+  }
+  auto &s0 = automaton.states.at(0);
+  auto &s1 = automaton.states.at(1);
+  auto &s2 = automaton.states.at(2);
+  s0->next['a'].emplace_back(s1.get(), TATransition::Resets{{0, ClockVariables{1}}, {1, 0.0}},
+                             std::vector<Constraint>{ConstraintMaker(0) < 2, ConstraintMaker(0) <= 3});
+  s0->next['a'].emplace_back(s0.get(), TATransition::Resets{{1, 0.5}},
+                             std::vector<Constraint>{ConstraintMaker(0) >= 2, ConstraintMaker(0) > 2});
+  s0->next[quote].emplace_back(s2.get(), TATransition::Resets{}, std::vector<Constraint>{ConstraintMaker(1) > 1});
+  s1->next[extended].emplace_back(s0.get(), TATransition::Resets{{0, 0.0}, {1, ClockVariables{0}}},
+                                  std::vector<Constraint>{ConstraintMaker(1) <= 1});
+  s1->next[UNOBSERVABLE].emplace_back(s2.get(), TATransition::Resets{{0, 0.25}},
+                                      std::vector<Constraint>{ConstraintMaker(0) >= 2, ConstraintMaker(1) < 4});
+  s1->next[UNOBSERVABLE].emplace_back(s0.get(), TATransition::Resets{{1, 0.0}},
+                                      std::vector<Constraint>{ConstraintMaker(1) > 1, ConstraintMaker(1) >= 1});
+  s2->next['a'].emplace_back(s1.get(), TATransition::Resets{{1, ClockVariables{0}}}, std::vector<Constraint>{});
+  s2->next[extended].emplace_back(s2.get(), TATransition::Resets{}, std::vector<Constraint>{ConstraintMaker(0) > 3});
+  automaton.initialStates.push_back(s0);
+  automaton.maxConstraints = {3, 4};
+
+  return automaton;
+}
+
+//! @brief The DTAs compiled to the monitors by generate_test_monitors
+inline std::vector<MonitorFixture> makeMonitorFixtures() {
+  std::vector<MonitorFixture> fixtures;
+  fixtures.push_back({"SimpleMonitor", SimpleAutomatonFixture{}.automaton, {'a'}});
+  fixtures.push_back({"ComplementSimpleMonitor", ComplementSimpleAutomatonFixture{}.complementAutomaton, {'a'}});
+  fixtures.push_back({"UnobservableMonitor", UnobservableAutomatonFixture{}.automaton, {'a'}});
+  fixtures.push_back({"TwoUnobservableMonitor",
+                      SimpleAutomatonWithTwoUnobservableFixture{}.automatonWithTwoUnobservable, {'a'}});
+  fixtures.push_back({"UnbalancedHypothesisMonitor", UnbalancedHypothesis20221219Fixture{}.hypothesis,
+                      {'a', 'b', 'c'}});
+  fixtures.push_back({"ResetsMonitor", makeResetsAutomaton(), {'a', '\'', static_cast<learnta::Alphabet>(200)}});
+  for (const std::size_t numStates: {4, 16, 64}) {
+    fixtures.push_back(makeRandomMonitorFixture(numStates));
+  }
+
+  return fixtures;
+}
+
+/*!
+ * @brief Execute a runner and TimedAutomatonRunner of the fixture on the same random timed words and compare them
+ *
+ * The runner must have step, getState, and getClockValuation, and its state is the index in fixture.automaton.states
+ * or sink. We compare the outputs and the configurations after each step. The durations are often multiples of 0.25
+ * so that the clock valuations hit the constants in the guards.
+ *
+ * @param reset The function resetting the runner to the initial configuration
+ * @returns The timed word until the first difference, or std::nullopt if there is no difference
+ */
+template<class Runner, class State, class Reset>
+std::optional<std::string> findDifferenceFromRunner(const MonitorFixture &fixture, Runner &runner, State sink,
+                                                    Reset reset, std::size_t numWords = 200, std::size_t length = 30) {
+  using namespace learnta;
+  std::unordered_map<const TAState *, State> toIndex{{nullptr, sink}};
+  for (std::size_t i = 0; i < fixture.automaton.states.size(); ++i) {
+    toIndex[fixture.automaton.states.at(i).get()] = static_cast<State>(i);
+  }
+  const auto &maxConstraints = fixture.automaton.maxConstraints;
+  const double maxConstant = maxConstraints.empty() ? 0 : *std::max_element(maxConstraints.begin(),
+                                                                            maxConstraints.end());
+  const auto gridSize = static_cast<std::size_t>(4 * (maxConstant + 1)) + 1;
+  SplitMix64 engine{20230318};
+
+  TimedAutomatonRunner expected{fixture.automaton};
+  auto sameConfiguration = [&] {
+    const auto &valuation = runner.getClockValuation();
+    return toIndex.at(expected.getState()) == runner.getState() &&
+           std::equal(valuation.begin(), valuation.end(), expected.getClockValuation().begin());
+  };
+  for (std::size_t i = 0; i < numWords; ++i) {
+    expected.pre();
+    reset();
+    std::stringstream word;
+    for (std::size_t j = 0; j < length; ++j) {
+      const double duration = engine.uniformReal() < 0.7 ? static_cast<double>(engine.uniformIndex(gridSize)) / 4.0 :
+                              engine.uniformReal() * (maxConstant + 1);
+      const Alphabet action = fixture.alphabet.at(engine.uniformIndex(fixture.alphabet.size()));
+      word << duration << " " << static_cast<int>(static_cast<unsigned char>(action)) << " ";
+      if (expected.step(duration) != runner.step(duration) || !sameConfiguration() ||
+          expected.step(action) != runner.step(action) || !sameConfiguration()) {
+        return word.str();
+      }
+    }
+    expected.post();
+  }
+
+  return std::nullopt;
+}
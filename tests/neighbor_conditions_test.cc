@@ -14,7 +14,7 @@ BOOST_AUTO_TEST_SUITE(NeighborConditionsTest)
   using namespace learnta;
   struct NeighborConditionsFixture {
     ForwardRegionalElementaryLanguage elementary;
-    std::unordered_set<ClockVariables> preciseClocks = {1};
+    ClockSet preciseClocks = {1};
     NeighborConditions neighborConditions;
     NeighborConditionsFixture() : elementary(ForwardRegionalElementaryLanguage().successor().successor().successor().successor().successor('a').successor('b').successor().successor().successor().successor().successor()),
                                   neighborConditions(elementary, preciseClocks) {}
@@ -22,7 +22,7 @@ BOOST_AUTO_TEST_SUITE(NeighborConditionsTest)
 
   struct NeighborConditionsFixture20221231 {
     ForwardRegionalElementaryLanguage elementary;
-    std::unordered_set<ClockVariables> preciseClocks = {1, 2};
+    ClockSet preciseClocks = {1, 2};
     NeighborConditions neighborConditions;
     NeighborConditionsFixture20221231() : elementary(ForwardRegionalElementaryLanguage::fromTimedWord(TimedWord{"ab", {2.0, 0, 2.5}})),
                                           neighborConditions(elementary, preciseClocks) {}
@@ -33,8 +33,8 @@ BOOST_AUTO_TEST_SUITE(NeighborConditionsTest)
   // codomain: (abb, 1 <= T_{0, 0}  <= 1 && 3 < T_{0, 1}  < 4 && 3 < T_{0, 2}  < 4 && 3 < T_{0, 3}  < 4 && 2 < T_{1, 1}  < 3 && 2 < T_{1, 2}  < 3 && 2 < T_{1, 3}  < 3 && -0 <= T_{2, 2}  <= 0 && -0 <= T_{2, 3}  <= 0 && -0 <= T_{3, 3}  <= 0) renaming: {t0 == t'1}
   struct NeighborConditionsFixture20230106 {
     ForwardRegionalElementaryLanguage elementary;
-    std::unordered_set<ClockVariables> preciseClocks = {1};
-    std::unordered_set<ClockVariables> explicitPreciseClocks = {1, 2, 3};
+    ClockSet preciseClocks = {1};
+    ClockSet explicitPreciseClocks = {1, 2, 3};
     NeighborConditions neighborConditions;
     NeighborConditionsFixture20230106() : elementary(ForwardRegionalElementaryLanguage::fromTimedWord(TimedWord{"abb", {1.0, 2.75, 0, 0}})),
                                           neighborConditions(elementary, preciseClocks) {}
@@ -48,7 +48,7 @@ BOOST_AUTO_TEST_SUITE(NeighborConditionsTest)
   // (abb, 1 <= T_{0, 0}  <= 1 && 3 < T_{0, 1}  < 4 && 3 < T_{0, 2}  < 4 && 4 < T_{0, 3}  < 5 && 2 < T_{1, 1}  < 3 && 2 < T_{1, 2}  < 3 && 3 < T_{1, 3}  < 4 && -0 <= T_{2, 2}  <= 0 && 1 < T_{2, 3}  < 2 && 1 < T_{3, 3}  < 2, 0 < {x2, x3, }{x0, x1, }), {t0 == t'0 && t1 == t'1}
   struct NeighborConditionsFixture20230108 {
     ForwardRegionalElementaryLanguage elementary;
-    std::unordered_set<ClockVariables> preciseClocks = {0, 1};
+    ClockSet preciseClocks = {0, 1};
     NeighborConditions neighborConditions;
     NeighborConditionsFixture20230108() : elementary(ForwardRegionalElementaryLanguage::fromTimedWord(TimedWord{"abb", {1.0, 2.5, 0, 1.25}})),
                                           neighborConditions(elementary, preciseClocks) {}
@@ -57,7 +57,7 @@ BOOST_AUTO_TEST_SUITE(NeighborConditionsTest)
   // (b, -0 < T_{0, 0}  < 1 && 6 < T_{0, 1}  < 7 && 6 < T_{1, 1}  < 7, 0 < {x1, }{x0, }) {x1}
   struct NeighborConditionsFixture20230109 {
     ForwardRegionalElementaryLanguage elementary;
-    std::unordered_set<ClockVariables> preciseClocks = {1};
+    ClockSet preciseClocks = {1};
     NeighborConditions neighborConditions;
     NeighborConditionsFixture20230109() : elementary(ForwardRegionalElementaryLanguage::fromTimedWord(TimedWord{"b", {0.25, 6.5}})),
                                           neighborConditions(elementary, preciseClocks) {}
@@ -366,7 +366,7 @@ BOOST_AUTO_TEST_SUITE(NeighborConditionsTest)
   }
 
   BOOST_AUTO_TEST_CASE(preciseClocksAfterResetTest) {
-    std::unordered_set<ClockVariables> preciseClocks = {2};
+    ClockSet preciseClocks = {2};
     const auto state = new TAState();
     state->next['a'].emplace_back(state, TATransition::Resets{},
                                   std::vector<Constraint> {ConstraintMaker(0) >= 4, ConstraintMaker(0) <= 4,
@@ -378,18 +378,18 @@ BOOST_AUTO_TEST_SUITE(NeighborConditionsTest)
                              std::vector<Constraint>{}};
     transition.resetVars.emplace_back(1, 5.75);
     transition.resetVars.emplace_back(3, 0.0);
-    std::unordered_set<ClockVariables> expected = {2, 3};
+    ClockSet expected = {2, 3};
     BOOST_TEST(expected == NeighborConditions::preciseClocksAfterReset(preciseClocks, transition));
     transition.resetVars.clear();
     transition.resetVars.emplace_back(0, 8.0);
     transition.resetVars.emplace_back(1, 1.5);
     transition.resetVars.emplace_back(2, 0.0);
-    std::unordered_set<ClockVariables> expectedSecond = {0, 2, 3};
+    ClockSet expectedSecond = {0, 2, 3};
     BOOST_TEST(expectedSecond == NeighborConditions::preciseClocksAfterReset(expected, transition));
   }
 
   BOOST_AUTO_TEST_CASE(preciseClocksAfterResetReduceTest) {
-    std::unordered_set<ClockVariables> preciseClocks = {2};
+    ClockSet preciseClocks = {2};
     const auto state = new TAState();
     state->next['a'].emplace_back(state, TATransition::Resets{},
                                   std::vector<Constraint> {ConstraintMaker(0) >= 4, ConstraintMaker(0) <= 4,
@@ -400,13 +400,13 @@ BOOST_AUTO_TEST_SUITE(NeighborConditionsTest)
                              std::vector<Constraint>{}};
     transition.resetVars.emplace_back(1, 5.75);
     transition.resetVars.emplace_back(3, 0.0);
-    std::unordered_set<ClockVariables> expected = {2};
+    ClockSet expected = {2};
     BOOST_TEST(expected == NeighborConditions::preciseClocksAfterReset(preciseClocks, transition));
     transition.resetVars.clear();
     transition.resetVars.emplace_back(0, 8.0);
     transition.resetVars.emplace_back(1, 1.5);
     transition.resetVars.emplace_back(2, 0.0);
-    std::unordered_set<ClockVariables> expectedSecond = {0, 2};
+    ClockSet expectedSecond = {0, 2};
     BOOST_TEST(expectedSecond == NeighborConditions::preciseClocksAfterReset(expected, transition));
   }
 
@@ -15,6 +15,7 @@
 #include "../include/timed_automata_equivalence_oracle.hh"
 
 #include "simple_automaton_fixture.hh"
+#include "small_light_automaton_fixture.hh"
 #include "simple_observation_table_keys_fixture.hh"
 #include "observation_table.hh"
 
@@ -44,9 +45,14 @@ BOOST_AUTO_TEST_SUITE(ObservationTableTest)
     BOOST_CHECK_EQUAL(3, this->observationTable.prefixes.size());
     BOOST_CHECK_EQUAL(1, this->observationTable.pIndices.size());
     BOOST_CHECK_EQUAL(1, this->observationTable.suffixes.size());
-    BOOST_CHECK_EQUAL(1, this->observationTable.discreteSuccessors.size());
-    BOOST_CHECK_EQUAL(1, this->observationTable.discreteSuccessors.at(std::make_pair(0, 'a')));
-    BOOST_CHECK_EQUAL(1, this->observationTable.continuousSuccessors.size());
+    const auto numSuccessors = [](const std::vector<std::size_t> &successors) {
+      return std::count_if(successors.begin(), successors.end(), [](std::size_t successor) {
+        return successor != ObservationTable::noSuccessor;
+      });
+    };
+    BOOST_CHECK_EQUAL(1, numSuccessors(this->observationTable.discreteSuccessors));
+    BOOST_CHECK_EQUAL(1, this->observationTable.discreteSuccessor(0, 'a'));
+    BOOST_CHECK_EQUAL(1, numSuccessors(this->observationTable.continuousSuccessors));
     BOOST_CHECK_EQUAL(2, this->observationTable.continuousSuccessors.at(0));
 
     // All the cells should be "top"
@@ -70,6 +76,121 @@ BOOST_AUTO_TEST_SUITE(ObservationTableTest)
      */
   }
 
+  BOOST_FIXTURE_TEST_CASE(parallelFill, SimpleAutomatonOracleFixture) {
+    std::vector<std::unique_ptr<learnta::SUL>> suls;
+    for (int i = 0; i < 4; ++i) {
+      suls.emplace_back(new learnta::TimedAutomatonRunner{this->automaton});
+    }
+    ObservationTable parallelTable{alphabet, std::make_unique<learnta::SymbolicMembershipOracle>(std::move(suls)), 4};
+    for (auto *table: {&this->observationTable, &parallelTable}) {
+      while (!(table->close() && table->consistent() && table->exteriorConsistent() && table->timeSaturate())) {}
+    }
+
+    // The parallel fill must not change the resulting table
+    BOOST_REQUIRE_EQUAL(this->observationTable.prefixes.size(), parallelTable.prefixes.size());
+    BOOST_REQUIRE_EQUAL(this->observationTable.suffixes.size(), parallelTable.suffixes.size());
+    for (std::size_t i = 0; i < parallelTable.prefixes.size(); ++i) {
+      BOOST_CHECK_EQUAL(this->observationTable.prefixes.at(i), parallelTable.prefixes.at(i));
+      for (std::size_t j = 0; j < parallelTable.suffixes.size(); ++j) {
+        BOOST_CHECK(this->observationTable.table.at(i).at(j).getConditions() ==
+                    parallelTable.table.at(i).at(j).getConditions());
+        BOOST_CHECK_EQUAL(this->observationTable.concatenations.at(i).at(j), parallelTable.concatenations.at(i).at(j));
+      }
+    }
+  }
+
+  BOOST_FIXTURE_TEST_CASE(lazyFill, SimpleAutomatonOracleFixture) {
+    ObservationTable lazyTable{alphabet, std::make_unique<learnta::SymbolicMembershipOracle>(
+            std::unique_ptr<learnta::SUL>(new learnta::TimedAutomatonRunner{this->automaton})), 1, true};
+    for (auto *table: {&this->observationTable, &lazyTable}) {
+      while (!(table->close() && table->consistent() && table->exteriorConsistent() && table->timeSaturate())) {}
+    }
+
+    // The lazy fill must not change the resulting table
+    BOOST_REQUIRE_EQUAL(this->observationTable.prefixes.size(), lazyTable.prefixes.size());
+    BOOST_REQUIRE_EQUAL(this->observationTable.suffixes.size(), lazyTable.suffixes.size());
+    BOOST_CHECK_LE(lazyTable.numFilledCells, this->observationTable.numFilledCells);
+    for (std::size_t i = 0; i < lazyTable.prefixes.size(); ++i) {
+      BOOST_CHECK_EQUAL(this->observationTable.prefixes.at(i), lazyTable.prefixes.at(i));
+      BOOST_CHECK_EQUAL(this->observationTable.isMatch(i), lazyTable.isMatch(i));
+      for (std::size_t j = 0; j < lazyTable.filledColumns.at(i); ++j) {
+        BOOST_CHECK(this->observationTable.table.at(i).at(j).getConditions() ==
+                    lazyTable.table.at(i).at(j).getConditions());
+      }
+    }
+    std::stringstream eagerHypothesis, lazyHypothesis;
+    eagerHypothesis << this->observationTable.generateHypothesis();
+    lazyHypothesis << lazyTable.generateHypothesis();
+    BOOST_CHECK_EQUAL(eagerHypothesis.str(), lazyHypothesis.str());
+  }
+
+  BOOST_FIXTURE_TEST_CASE(lazyFillsFewerCells, SmallLightAutomatonFixture) {
+    const auto makeTable = [&](bool lazy) {
+      return ObservationTable{alphabet, std::make_unique<learnta::SymbolicMembershipOracle>(
+              std::unique_ptr<learnta::SUL>(new learnta::TimedAutomatonRunner{this->targetAutomaton})), 1, lazy};
+    };
+    auto eagerTable = makeTable(false);
+    auto lazyTable = makeTable(true);
+    // The rows of ext(P) are not filled until close() or consistent() compares them
+    BOOST_CHECK_LT(lazyTable.numFilledCells, eagerTable.numFilledCells);
+    // The lazy table fills no more cells than the eager one while they take the same steps. Since the fingerprints of
+    // the partially filled rows are not computed, only the compared cells of ext(P) are filled.
+    bool fewer = false;
+    bool updated;
+    do {
+      updated = false;
+      for (auto *table: {&eagerTable, &lazyTable}) {
+        updated = !(table->close() && table->consistent() && table->exteriorConsistent() && table->timeSaturate()) ||
+                  updated;
+      }
+      BOOST_REQUIRE_EQUAL(eagerTable.prefixes.size(), lazyTable.prefixes.size());
+      BOOST_REQUIRE_EQUAL(eagerTable.suffixes.size(), lazyTable.suffixes.size());
+      BOOST_CHECK_LE(lazyTable.numFilledCells, eagerTable.numFilledCells);
+      fewer = fewer || lazyTable.numFilledCells < eagerTable.numFilledCells;
+    } while (updated);
+    BOOST_CHECK(fewer);
+  }
+
+  BOOST_FIXTURE_TEST_CASE(fingerprint, SimpleAutomatonOracleFixture) {
+    while (!(observationTable.close() && observationTable.consistent() &&
+             observationTable.exteriorConsistent() && observationTable.timeSaturate())) {}
+
+    // The rows with different fingerprints must not be equivalent
+    for (std::size_t i = 0; i < observationTable.prefixes.size(); ++i) {
+      for (std::size_t j = 0; j < observationTable.prefixes.size(); ++j) {
+        if (observationTable.fingerprint(i) != observationTable.fingerprint(j)) {
+          BOOST_CHECK(!findDeterministicEquivalentRenaming(
+                  observationTable.prefixes.at(i), observationTable.row(i), observationTable.rowConcatenations(i),
+                  observationTable.prefixes.at(j), observationTable.row(j), observationTable.rowConcatenations(j),
+                  observationTable.suffixes));
+        }
+      }
+    }
+    BOOST_CHECK_EQUAL(observationTable.fingerprint(0), observationTable.fingerprint(0));
+  }
+
+  BOOST_FIXTURE_TEST_CASE(incrementalChecks, SimpleAutomatonOracleFixture) {
+    while (!(observationTable.close() && observationTable.consistent() &&
+             observationTable.exteriorConsistent() && observationTable.timeSaturate())) {}
+    BOOST_CHECK_EQUAL(observationTable.pIndices.size(), observationTable.exteriorConsistentRows.size());
+    const auto numConsistentPairs = observationTable.consistentPairs.size();
+    const auto numTimeSaturatedRows = observationTable.timeSaturatedRows.size();
+
+    // The checks remain valid without any update
+    BOOST_CHECK(observationTable.consistent());
+    BOOST_CHECK(observationTable.exteriorConsistent());
+    BOOST_CHECK(observationTable.timeSaturate());
+    BOOST_CHECK_EQUAL(numConsistentPairs, observationTable.consistentPairs.size());
+    BOOST_CHECK_EQUAL(numTimeSaturatedRows, observationTable.timeSaturatedRows.size());
+
+    // A new suffix invalidates the previous checks
+    observationTable.suffixes.push_back(observationTable.suffixes.back().predecessor('a'));
+    observationTable.refreshTable();
+    BOOST_CHECK(observationTable.consistentPairs.empty());
+    BOOST_CHECK(observationTable.timeSaturatedRows.empty());
+    BOOST_CHECK_EQUAL(observationTable.pIndices.size(), observationTable.exteriorConsistentRows.size());
+  }
+
   BOOST_AUTO_TEST_CASE(stateSplitTest) {
     const auto toTA = [] (std::vector<std::shared_ptr<TAState>> states) {
       return TimedAutomaton{{states, {states.front()}}, TimedAutomaton::makeMaxConstants(states)}.simplify();
@@ -0,0 +1,123 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/04.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <boost/test/unit_test.hpp>
+
+#include "../include/persistent_membership_store.hh"
+#include "../include/timed_automaton_runner.hh"
+#include "simple_automaton_fixture.hh"
+
+BOOST_AUTO_TEST_SUITE(PersistentMembershipStoreTest)
+  using namespace learnta;
+
+  struct StorePathFixture {
+    std::string path;
+
+    StorePathFixture() {
+      char name[] = "/tmp/learnta_store_XXXXXX";
+      close(mkstemp(name));
+      path = name;
+      std::remove(path.c_str());
+    }
+
+    ~StorePathFixture() {
+      std::remove(path.c_str());
+    }
+  };
+
+  BOOST_FIXTURE_TEST_CASE(reopen, StorePathFixture) {
+    const TimedWord w1{"a", {0.5, 1}};
+    const TimedWord w2{"aa", {0.5, 1, 1.5}};
+    {
+      PersistentMembershipStore store{path, "sul"};
+      BOOST_CHECK(!store.find(w1));
+      store.insert(w1, true);
+      store.insert(w2, false);
+      BOOST_CHECK_EQUAL(2, store.size());
+    }
+    PersistentMembershipStore store{path, "sul"};
+    BOOST_CHECK_EQUAL(2, store.size());
+    BOOST_CHECK(store.find(w1) == std::optional<bool>{true});
+    BOOST_CHECK(store.find(w2) == std::optional<bool>{false});
+    BOOST_CHECK_THROW(PersistentMembershipStore(path, "another sul"), std::runtime_error);
+  }
+
+  BOOST_FIXTURE_TEST_CASE(sharedAndTorn, StorePathFixture) {
+    const TimedWord w1{"a", {0.5, 1}};
+    const TimedWord w2{"aa", {0.5, 1, 1.5}};
+    PersistentMembershipStore reader{path, "sul"};
+    {
+      // The records appended by another writer are visible
+      PersistentMembershipStore writer{path, "sul"};
+      writer.insert(w1, true);
+      BOOST_CHECK(reader.find(w1) == std::optional<bool>{true});
+      writer.insert(w2, true);
+    }
+    // Emulate an interrupted append by dropping the last byte
+    {
+      std::ifstream is{path, std::ios::binary};
+      std::string bytes{std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>()};
+      bytes.pop_back();
+      std::ofstream os{path, std::ios::binary | std::ios::trunc};
+      os << bytes;
+    }
+    PersistentMembershipStore store{path, "sul"};
+    BOOST_CHECK_EQUAL(1, store.size());
+    BOOST_CHECK(!store.find(w2));
+    // The broken record is removed and we can append again
+    store.insert(w2, false);
+    PersistentMembershipStore reopened{path, "sul"};
+    BOOST_CHECK(reopened.find(w2) == std::optional<bool>{false});
+  }
+
+  BOOST_FIXTURE_TEST_CASE(tornByAnotherProcess, StorePathFixture) {
+    const TimedWord w1{"a", {0.5, 1}};
+    const TimedWord w2{"aa", {0.5, 1, 1.5}};
+    PersistentMembershipStore store{path, "sul"};
+    store.insert(w1, true);
+    // Emulate another process killed in the middle of an append while this store is open
+    {
+      std::ofstream os{path, std::ios::binary | std::ios::app};
+      os << "torn";
+    }
+    store.insert(w2, false);
+    PersistentMembershipStore reopened{path, "sul"};
+    BOOST_CHECK_EQUAL(2, reopened.size());
+    BOOST_CHECK(reopened.find(w2) == std::optional<bool>{false});
+    // The file ends at the last record
+    reopened.insert(TimedWord{"b", {0, 0}}, true);
+    BOOST_CHECK(store.find(TimedWord{"b", {0, 0}}) == std::optional<bool>{true});
+  }
+
+  BOOST_AUTO_TEST_CASE(fileName) {
+    // The name does not depend on the platform so that the separate runs share the store
+    BOOST_CHECK_EQUAL("cbf29ce484222325.mqs", PersistentMembershipStore::fileName(""));
+    BOOST_CHECK_EQUAL("af63dc4c8601ec8c.mqs", PersistentMembershipStore::fileName("a"));
+  }
+
+  BOOST_FIXTURE_TEST_CASE(oracle, SimpleAutomatonFixture) {
+    StorePathFixture store;
+    const TimedWord word{"aa", {0.5, 1, 0.25}};
+    const auto makeOracle = [&] {
+      return PersistentMembershipOracle{
+              std::make_unique<SULMembershipOracle>(std::make_unique<TimedAutomatonRunner>(automaton)),
+              store.path, "simple"};
+    };
+    bool expected;
+    {
+      auto oracle = makeOracle();
+      expected = oracle.answerQuery(word);
+      BOOST_CHECK_EQUAL(1, oracle.count());
+    }
+    // The second run does not execute the SUL
+    auto oracle = makeOracle();
+    BOOST_CHECK_EQUAL(expected, oracle.answerQuery(word));
+    BOOST_CHECK_EQUAL(0, oracle.count());
+  }
+
+BOOST_AUTO_TEST_SUITE_END()
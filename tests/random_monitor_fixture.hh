@@ -0,0 +1,36 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/18.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../include/random_timed_automaton_generator.hh"
+#include "../include/timed_automaton.hh"
+
+/*!
+ * @brief The DTAs compiled to the monitors by generate_test_monitors
+ *
+ * The test and the benchmark of the generated monitors compare them with TimedAutomatonRunner executing the same DTAs.
+ * The name is the class name of the monitor and its header is generated_monitors/<name>.hh.
+ */
+struct MonitorFixture {
+  std::string name;
+  learnta::TimedAutomaton automaton;
+  std::vector<learnta::Alphabet> alphabet;
+};
+
+//! @brief A deterministic and complete random DTA with the given number of states
+inline MonitorFixture makeRandomMonitorFixture(std::size_t numStates) {
+  learnta::RandomTimedAutomatonParameters parameters;
+  parameters.numStates = numStates;
+  parameters.numClocks = 2;
+  parameters.alphabetSize = 3;
+  parameters.seed = numStates;
+  learnta::RandomTimedAutomatonGenerator generator{parameters};
+
+  return {"RandomMonitor" + std::to_string(numStates), generator.generate(), generator.alphabet()};
+}
@@ -0,0 +1,145 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/15.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+#include <boost/test/unit_test.hpp>
+
+#include "../include/random_timed_automaton_generator.hh"
+#include "../include/timed_automaton_runner.hh"
+#include "../examples/ota_json_parser.hh"
+#include "../examples/ota_json_writer.hh"
+
+BOOST_AUTO_TEST_SUITE(RandomTimedAutomatonGeneratorTest)
+  using namespace learnta;
+
+  std::string toString(const TimedAutomaton &automaton) {
+    std::stringstream stream;
+    stream << automaton;
+    return stream.str();
+  }
+
+  std::size_t numReachable(const TimedAutomaton &automaton) {
+    std::unordered_set<const TAState *> visited{automaton.initialStates.front().get()};
+    std::vector<const TAState *> toVisit{automaton.initialStates.front().get()};
+    while (!toVisit.empty()) {
+      const auto state = toVisit.back();
+      toVisit.pop_back();
+      for (const auto &[action, transitions]: state->next) {
+        for (const auto &transition: transitions) {
+          if (visited.insert(transition.target).second) {
+            toVisit.push_back(transition.target);
+          }
+        }
+      }
+    }
+    return visited.size();
+  }
+
+  //! @brief The number of the transitions from the state enabled by the one-clock valuation
+  std::size_t numEnabled(const std::vector<TATransition> &transitions, double value) {
+    return std::count_if(transitions.begin(), transitions.end(), [&](const TATransition &transition) {
+      return std::all_of(transition.guard.begin(), transition.guard.end(), [&](const Constraint &constraint) {
+        return constraint.satisfy(value);
+      });
+    });
+  }
+
+  BOOST_AUTO_TEST_CASE(deterministicComplete) {
+    for (std::uint64_t seed = 0; seed < 20; ++seed) {
+      RandomTimedAutomatonParameters parameters;
+      parameters.numStates = 8;
+      parameters.alphabetSize = 3;
+      parameters.seed = seed;
+      RandomTimedAutomatonGenerator generator{parameters};
+      const auto automaton = generator.generate();
+      BOOST_CHECK_EQUAL(8, automaton.stateSize());
+      BOOST_CHECK(automaton.deterministic());
+      BOOST_CHECK_EQUAL(8, numReachable(automaton));
+      // Exactly one transition is enabled for each valuation, action, and state
+      for (const auto &state: automaton.states) {
+        for (const Alphabet action: generator.alphabet()) {
+          BOOST_REQUIRE(state->next.find(action) != state->next.end());
+          for (int i = 0; i <= 2 * parameters.maxConstant + 1; ++i) {
+            BOOST_CHECK_EQUAL(1, numEnabled(state->next.at(action), i / 2.0));
+          }
+        }
+      }
+    }
+  }
+
+  BOOST_AUTO_TEST_CASE(reproducible) {
+    RandomTimedAutomatonParameters parameters;
+    parameters.numClocks = 2;
+    parameters.seed = 42;
+    RandomTimedAutomatonGenerator generator1{parameters}, generator2{parameters};
+    const auto automaton = generator1.generate();
+    BOOST_CHECK_EQUAL(toString(automaton), toString(generator2.generate()));
+    BOOST_CHECK_NE(toString(automaton), toString(generator1.generate()));
+    parameters.seed = 43;
+    BOOST_CHECK_NE(toString(automaton), toString(RandomTimedAutomatonGenerator{parameters}.generate()));
+  }
+
+  BOOST_AUTO_TEST_CASE(nondeterministic) {
+    RandomTimedAutomatonParameters parameters;
+    parameters.deterministic = false;
+    BOOST_CHECK(!RandomTimedAutomatonGenerator{parameters}.generate().deterministic());
+  }
+
+  BOOST_AUTO_TEST_CASE(invalidParameters) {
+    RandomTimedAutomatonParameters parameters;
+    parameters.numStates = 0;
+    BOOST_CHECK_THROW(RandomTimedAutomatonGenerator{parameters}, std::invalid_argument);
+    parameters.numStates = 1;
+    parameters.guardDensity = 1.5;
+    BOOST_CHECK_THROW(RandomTimedAutomatonGenerator{parameters}, std::invalid_argument);
+  }
+
+  BOOST_AUTO_TEST_CASE(jsonRoundTrip) {
+    RandomTimedAutomatonParameters parameters;
+    parameters.seed = 7;
+    RandomTimedAutomatonGenerator generator{parameters};
+    const auto automaton = generator.generate();
+    const std::string path = "/tmp/random_timed_automaton_generator_test.json";
+    {
+      std::ofstream stream{path};
+      writeOtaJson(stream, generator.alphabet(), automaton, "random");
+    }
+    OtaJsonParser parser{path};
+    std::remove(path.c_str());
+    BOOST_CHECK(generator.alphabet() == parser.getAlphabet());
+    BOOST_CHECK_EQUAL(automaton.stateSize(), parser.getTarget().stateSize());
+
+    // The parsed automaton accepts the same timed words
+    TimedAutomatonRunner runner{automaton}, parsedRunner{parser.getTarget()};
+    SplitMix64 engine{0};
+    for (int i = 0; i < 100; ++i) {
+      runner.pre();
+      parsedRunner.pre();
+      for (int j = 0; j < 10; ++j) {
+        const double duration = (engine() % 8) / 2.0;
+        BOOST_CHECK_EQUAL(runner.step(duration), parsedRunner.step(duration));
+        const Alphabet action = generator.alphabet().at(engine() % parameters.alphabetSize);
+        BOOST_CHECK_EQUAL(runner.step(action), parsedRunner.step(action));
+      }
+      runner.post();
+      parsedRunner.post();
+    }
+
+    // The OTA json format supports only one clock
+    parameters.numClocks = 2;
+    std::stringstream stream;
+    BOOST_CHECK_THROW(writeOtaJson(stream, generator.alphabet(), RandomTimedAutomatonGenerator{parameters}.generate(),
+                                   "random"), std::invalid_argument);
+  }
+
+  BOOST_AUTO_TEST_CASE(quoteJsonString) {
+    BOOST_CHECK_EQUAL("\"plain\"", quoteJson("plain"));
+    BOOST_CHECK_EQUAL("\"a\\\"b\\\\c\\u000a\"", quoteJson("a\"b\\c\n"));
+  }
+
+BOOST_AUTO_TEST_SUITE_END()
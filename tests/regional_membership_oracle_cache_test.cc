@@ -0,0 +1,63 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/07.
+ */
+
+#include <sstream>
+#include <boost/test/unit_test.hpp>
+
+#include "../include/membership_oracle.hh"
+#include "../include/timed_automaton_runner.hh"
+#include "simple_automaton_fixture.hh"
+
+BOOST_AUTO_TEST_SUITE(RegionalMembershipOracleCacheTest)
+  using namespace learnta;
+
+  struct Fixture : public SimpleAutomatonFixture {
+    [[nodiscard]] std::unique_ptr<MembershipOracle> makeOracle() const {
+      return std::make_unique<SULMembershipOracle>(std::make_unique<TimedAutomatonRunner>(automaton));
+    }
+  };
+
+  BOOST_FIXTURE_TEST_CASE(region, Fixture) {
+    RegionalMembershipOracleCache cache{makeOracle(), 1};
+    BOOST_CHECK(cache.region(TimedWord{"a", {0.3, 0.2}}) == cache.region(TimedWord{"a", {0.4, 0.1}}));
+    // 0.1 + 0.2 + 0.7 is not exactly 1 in double
+    BOOST_CHECK(cache.region(TimedWord{"aa", {0.1, 0.2, 0.7}}) == cache.region(TimedWord{"aa", {0.2, 0.1, 0.7}}));
+    BOOST_CHECK(cache.region(TimedWord{"a", {0.3, 0.2}}) != cache.region(TimedWord{"a", {0.3, 0.7}}));
+    BOOST_CHECK(cache.region(TimedWord{"a", {0.3, 0.2}}) != cache.region(TimedWord{"a", {0.9, 0.2}}));
+    BOOST_CHECK(cache.region(TimedWord{"a", {1, 0}}) != cache.region(TimedWord{"a", {0.9, 0.1}}));
+    BOOST_CHECK(cache.region(TimedWord{"a", {1.5, 0}}) == cache.region(TimedWord{"a", {2.5, 0}}));
+    BOOST_CHECK(cache.region(TimedWord{"a", {0.5, 0}}) != cache.region(TimedWord{"b", {0.5, 0}}));
+  }
+
+  BOOST_FIXTURE_TEST_CASE(hit, Fixture) {
+    RegionalMembershipOracleCache cache{makeOracle(), 1};
+    const bool result = cache.answerQuery(TimedWord{"aa", {0.3, 0.5, 0.1}});
+    BOOST_CHECK_EQUAL(result, cache.answerQuery(TimedWord{"aa", {0.2, 0.6, 0.1}}));
+    BOOST_CHECK_EQUAL(1, cache.count());
+    cache.answerQuery(TimedWord{"aa", {0.3, 1, 0.1}});
+    BOOST_CHECK_EQUAL(2, cache.count());
+
+    // The cache is restored from a checkpoint
+    std::stringstream checkpoint;
+    cache.save(checkpoint);
+    RegionalMembershipOracleCache restored{makeOracle(), 1};
+    restored.load(checkpoint);
+    BOOST_CHECK_EQUAL(result, restored.answerQuery(TimedWord{"aa", {0.25, 0.55, 0.1}}));
+    BOOST_CHECK_EQUAL(0, restored.count());
+  }
+
+  BOOST_FIXTURE_TEST_CASE(verify, Fixture) {
+    // The maximal constant is too small to distinguish 0.5 and 1.5
+    RegionalMembershipOracleCache cache{makeOracle(), 0, true};
+    BOOST_CHECK(cache.answerQuery(TimedWord{"a", {0.5, 0}}));
+    BOOST_CHECK(!cache.answerQuery(TimedWord{"a", {1.5, 0}}));
+    BOOST_CHECK_EQUAL(1, cache.numMismatches());
+    BOOST_CHECK_EQUAL(2, cache.count());
+    std::stringstream statistics;
+    cache.printStatistics(statistics);
+    BOOST_CHECK(statistics.str().find("Number of mismatches in the regional cache: 1") != std::string::npos);
+  }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/03.
+ */
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <boost/test/unit_test.hpp>
+
+#define private public
+#include "../include/serialization.hh"
+#include "../include/timed_automaton_runner.hh"
+#include "../include/symbolic_membership_oracle.hh"
+#include "../include/observation_table.hh"
+#include "simple_automaton_fixture.hh"
+#include "simple_observation_table_keys_fixture.hh"
+
+BOOST_AUTO_TEST_SUITE(SerializationTest)
+  using namespace learnta;
+
+  template<class T>
+  T roundTrip(const T &value) {
+    std::stringstream stream;
+    Serializer::write(stream, value);
+    T result;
+    Serializer::read(stream, result);
+    return result;
+  }
+
+  BOOST_FIXTURE_TEST_CASE(languages, SimpleObservationTableKeysFixture) {
+    for (const auto &prefix: {p1, p4, p7, p13}) {
+      BOOST_CHECK_EQUAL(prefix, roundTrip(prefix));
+    }
+    for (const auto &suffix: {s1, s2, s3}) {
+      BOOST_CHECK_EQUAL(suffix, roundTrip(suffix));
+    }
+    const TimedWord word{"ab", {0.5, 1, 1.25}};
+    BOOST_CHECK_EQUAL(word, roundTrip(word));
+    const TimedConditionSet conditions{std::vector<TimedCondition>{p4.getTimedCondition(), p7.getTimedCondition()}};
+    BOOST_CHECK(conditions.getConditions() == roundTrip(conditions).getConditions());
+  }
+
+  BOOST_AUTO_TEST_CASE(truncated) {
+    std::stringstream stream;
+    Serializer::write(stream, std::vector<double>{1, 2, 3});
+    auto bytes = stream.str();
+    bytes.pop_back();
+    std::stringstream truncatedStream{bytes};
+    std::vector<double> result;
+    BOOST_CHECK_THROW(Serializer::read(truncatedStream, result), std::runtime_error);
+    std::stringstream tagStream;
+    Serializer::writeTag(tagStream, "foo");
+    BOOST_CHECK_THROW(Serializer::readTag(tagStream, "bar"), std::runtime_error);
+  }
+
+  //! @brief A broken size is rejected before the allocation
+  BOOST_AUTO_TEST_CASE(brokenSize) {
+    for (const std::uint64_t size: {std::uint64_t{1} << 40, std::numeric_limits<std::uint64_t>::max()}) {
+      std::stringstream stream;
+      Serializer::write(stream, size);
+      stream << "some bytes";
+      std::stringstream stringStream{stream.str()};
+      std::string string;
+      BOOST_CHECK_THROW(Serializer::read(stringStream, string), std::runtime_error);
+      std::stringstream vectorStream{stream.str()};
+      std::vector<double> values;
+      BOOST_CHECK_THROW(Serializer::read(vectorStream, values), std::runtime_error);
+    }
+    std::stringstream zoneStream;
+    Serializer::write(zoneStream, std::uint64_t{1} << 20);
+    Serializer::write(zoneStream, std::uint64_t{1} << 20);
+    Zone zone;
+    BOOST_CHECK_THROW(Serializer::read(zoneStream, zone), std::runtime_error);
+  }
+
+  BOOST_FIXTURE_TEST_CASE(observationTable, SimpleAutomatonFixture) {
+    const std::vector<Alphabet> alphabet = {'a'};
+    const auto makeTable = [&] {
+      return ObservationTable{alphabet, std::make_unique<SymbolicMembershipOracle>(
+              std::unique_ptr<SUL>(new TimedAutomatonRunner{this->automaton}))};
+    };
+    auto original = makeTable();
+    while (!(original.close() && original.consistent() && original.exteriorConsistent() && original.timeSaturate())) {}
+    std::stringstream checkpoint;
+    original.save(checkpoint);
+
+    auto resumed = makeTable();
+    const auto initialCount = resumed.memOracle->count();
+    resumed.load(checkpoint);
+    BOOST_CHECK(resumed.prefixes == original.prefixes);
+    BOOST_CHECK(resumed.suffixes == original.suffixes);
+    BOOST_CHECK(resumed.pIndices == original.pIndices);
+    // The resumed table is already closed and consistent without any new query
+    BOOST_CHECK(resumed.close() && resumed.consistent() && resumed.exteriorConsistent() && resumed.timeSaturate());
+    BOOST_CHECK_EQUAL(initialCount, resumed.memOracle->count());
+    std::stringstream originalHypothesis, resumedHypothesis;
+    originalHypothesis << original.generateHypothesis();
+    resumedHypothesis << resumed.generateHypothesis();
+    BOOST_CHECK_EQUAL(originalHypothesis.str(), resumedHypothesis.str());
+  }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,44 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/01.
+ */
+
+#include <numeric>
+#include <stdexcept>
+#include <boost/test/unit_test.hpp>
+
+#include "../include/thread_pool.hh"
+
+BOOST_AUTO_TEST_SUITE(ThreadPoolTest)
+  using namespace learnta;
+
+  BOOST_AUTO_TEST_CASE(parallelFor) {
+    ThreadPool pool{4};
+    BOOST_CHECK_EQUAL(4, pool.size());
+    // We reuse the same pool many times
+    for (std::size_t size: {0, 1, 3, 100, 1000}) {
+      std::vector<std::size_t> result(size, 0);
+      pool.parallelFor(size, [&](std::size_t i) {
+        result.at(i) = i * i;
+      });
+      for (std::size_t i = 0; i < size; ++i) {
+        BOOST_CHECK_EQUAL(i * i, result.at(i));
+      }
+    }
+  }
+
+  BOOST_AUTO_TEST_CASE(exception) {
+    ThreadPool pool{3};
+    BOOST_CHECK_THROW(pool.parallelFor(100, [](std::size_t i) {
+      if (i == 42) {
+        throw std::runtime_error("42");
+      }
+    }), std::runtime_error);
+    // The pool is still usable
+    std::atomic<std::size_t> sum{0};
+    pool.parallelFor(10, [&](std::size_t i) {
+      sum += i;
+    });
+    BOOST_CHECK_EQUAL(45, sum);
+  }
+BOOST_AUTO_TEST_SUITE_END()
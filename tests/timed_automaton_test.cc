@@ -105,7 +105,7 @@ BOOST_AUTO_TEST_SUITE(TimedAutomatonTest)
                       "        loc0->loc2 [label=\"b\", guard=\"{x1 > 5, x0 < 7, x0 > 5, x1 < 6}\", reset=\"{x2 := 0, x0 := 5.5}\"]\n"
                       "}\n", stream.str());
     stream.str("");
-    const std::unordered_set<ClockVariables> preciseClocks = {1};
+    const ClockSet preciseClocks = {1};
     states.at(0)->mergeNondeterministicBranching(preciseClocks);
     BOOST_CHECK_EQUAL(1, states.at(0)->next.at('b').size());
     BOOST_CHECK_EQUAL(states.at(1).get(), states.at(0)->next.at('b').front().target);
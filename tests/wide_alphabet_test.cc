@@ -0,0 +1,124 @@
+/**
+ * @author Masaki Waga
+ * @date 2023/03/21.
+ * @brief The tests of the 16-bit actions. This file is built with LEARNTA_WIDE_ALPHABET in wide_alphabet_test.
+ */
+
+#include <cstdio>
+#include <sstream>
+#include <unordered_set>
+#include <unistd.h>
+#include <boost/test/unit_test.hpp>
+
+#include "../include/alphabet_interner.hh"
+#include "../include/compiled_timed_automaton.hh"
+#include "../include/learner.hh"
+#include "../include/monitor_code_generator.hh"
+#include "../include/persistent_membership_store.hh"
+#include "../include/serialization.hh"
+#include "../include/timed_automaton_runner.hh"
+#include "../include/timed_automata_equivalence_oracle.hh"
+
+#include "simple_automaton_fixture.hh"
+
+BOOST_AUTO_TEST_SUITE(WideAlphabetTest)
+  using namespace learnta;
+  static_assert(sizeof(Alphabet) == 2, "This test requires LEARNTA_WIDE_ALPHABET");
+
+  //! @brief An action not representable by a char
+  const auto wideAction = static_cast<Alphabet>(0x1234);
+
+  //! @brief The DTA in SimpleAutomatonFixture with 'a' replaced by wideAction
+  struct WideAutomatonFixture : SimpleAutomatonFixture {
+    WideAutomatonFixture() {
+      for (auto &state: automaton.states) {
+        state->next[wideAction] = std::move(state->next.at('a'));
+        state->next.erase('a');
+      }
+    }
+  };
+
+  BOOST_AUTO_TEST_CASE(internManyLabels) {
+    AlphabetInterner interner;
+    std::unordered_set<Alphabet> actions;
+    for (std::size_t i = 0; i < 500; ++i) {
+      const auto action = interner.intern("event" + std::to_string(i));
+      BOOST_CHECK_NE(UNOBSERVABLE, action);
+      actions.insert(action);
+    }
+    BOOST_CHECK_EQUAL(500, actions.size());
+    BOOST_CHECK(interner.at("event0") == 'a');
+    BOOST_CHECK(interner.at("event" + std::to_string(AlphabetInterner::printableCapacity)) == 0x80);
+    BOOST_CHECK(interner.at("event499") == 0x80 + 499 - AlphabetInterner::printableCapacity);
+    BOOST_CHECK_EQUAL("event499", interner.label(interner.at("event499")));
+    BOOST_CHECK_EQUAL(AlphabetInterner::printableCapacity + 0xFFFF - 0x7F, AlphabetInterner::capacity);
+  }
+
+  BOOST_FIXTURE_TEST_CASE(learn, WideAutomatonFixture) {
+    const std::vector<Alphabet> alphabet = {wideAction};
+    auto sul = std::unique_ptr<SUL>(new TimedAutomatonRunner{automaton});
+    auto memOracle = std::make_unique<SymbolicMembershipOracle>(std::move(sul));
+    auto complement = automaton.complement(alphabet);
+    auto eqOracle = std::unique_ptr<EquivalenceOracle>(
+            new ComplementTimedAutomataEquivalenceOracle{automaton, complement, alphabet});
+    Learner learner{alphabet, std::move(memOracle), std::move(eqOracle)};
+    const auto result = learner.run();
+
+    BOOST_CHECK_EQUAL(2, result.stateSize());
+    BOOST_CHECK(result.deterministic());
+    for (const auto &state: result.states) {
+      for (const auto &[action, transitions]: state->next) {
+        BOOST_CHECK(action == wideAction);
+      }
+    }
+  }
+
+  //! @brief The actions are not truncated in the checkpoints and the membership stores
+  BOOST_AUTO_TEST_CASE(persistence) {
+    const TimedWord word{Word{wideAction, static_cast<Alphabet>(0x80), static_cast<Alphabet>('a')}, {0.5, 1, 1.5, 2}};
+    std::stringstream stream;
+    Serializer::write(stream, word);
+    TimedWord restored;
+    Serializer::read(stream, restored);
+    BOOST_CHECK_EQUAL(word, restored);
+
+    char name[] = "/tmp/learnta_wide_store_XXXXXX";
+    close(mkstemp(name));
+    std::remove(name);
+    {
+      PersistentMembershipStore store{name, "sul"};
+      store.insert(word, true);
+    }
+    {
+      PersistentMembershipStore store{name, "sul"};
+      BOOST_CHECK(store.find(word) == std::optional<bool>{true});
+      BOOST_CHECK(!store.find(TimedWord{Word{wideAction, 0x80, 0x34}, {0.5, 1, 1.5, 2}}));
+    }
+    std::remove(name);
+  }
+
+  BOOST_FIXTURE_TEST_CASE(compiledAndMonitor, WideAutomatonFixture) {
+    std::stringstream stream;
+    CompiledTimedAutomaton::write(stream, automaton);
+    const auto compiled =
+            std::make_shared<const CompiledTimedAutomaton>(CompiledTimedAutomaton::fromBytes(stream.str()));
+    CompiledTimedAutomatonRunner compiledRunner{compiled};
+    TimedAutomatonRunner runner{automaton};
+    compiledRunner.pre();
+    runner.pre();
+    for (const double duration: {0.5, 1.0, 1.5, 0.25}) {
+      BOOST_CHECK_EQUAL(runner.step(duration), compiledRunner.step(duration));
+      BOOST_CHECK_EQUAL(runner.step(wideAction), compiledRunner.step(wideAction));
+    }
+    // The action sharing the lower byte with wideAction is not in the DTA
+    BOOST_CHECK(!compiledRunner.step(static_cast<Alphabet>(0x34)));
+    BOOST_CHECK(!runner.step(static_cast<Alphabet>(0x34)));
+    compiledRunner.post();
+    runner.post();
+
+    std::ostringstream code;
+    generateMonitor(code, automaton, "WideMonitor");
+    BOOST_CHECK(code.str().find("bool step(char16_t action)") != std::string::npos);
+    BOOST_CHECK(code.str().find("case static_cast<char16_t>(4660):") != std::string::npos);
+  }
+BOOST_AUTO_TEST_SUITE_END()
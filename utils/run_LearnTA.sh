@@ -41,13 +41,10 @@ for benchmark in $benchmarks; do
             $TIMEOUT "${EXECUTABLES_DIR}/examples/learn_ota_json" $json | tee "$LOG_DIR/${filename/.json/}.log"
         done
     elif [ $(echo ${benchmark} | tr [a-z] [A-Z]) == TRAIN ]; then
-        jq '.sigma as $sigma | (.tran |= with_entries(.value[1] = (.value[1] as $event | "abcdefghijklmnopqrstuvwxyz" | split("")[($sigma | index($event))]))) | (.sigma |= map(. as $event | "abcdefghijklmnopqrstuvwxyz" | split("")[($sigma | index($event))])) | .' "$ATVA_BENCHMARK_ROOT/Train.json" > /tmp/Train.json
-        $TIMEOUT "${EXECUTABLES_DIR}/examples/learn_ota_json" /tmp/Train.json | tee "$LOG_DIR/Train.log"
+        $TIMEOUT "${EXECUTABLES_DIR}/examples/learn_ota_json" "$ATVA_BENCHMARK_ROOT/Train.json" | tee "$LOG_DIR/Train.log"
     elif [ $(echo ${benchmark} | tr [a-z] [A-Z]) == LIGHT ]; then
-        jq '.sigma as $sigma | (.tran |= with_entries(.value[1] = (.value[1] as $event | "abcdefghijklmnopqrstuvwxyz" | split("")[($sigma | index($event))]))) | (.sigma |= map(. as $event | "abcdefghijklmnopqrstuvwxyz" | split("")[($sigma | index($event))])) | .' "$ATVA_BENCHMARK_ROOT/Light.json" > /tmp/Light.json
-        $TIMEOUT "${EXECUTABLES_DIR}/examples/learn_ota_json" /tmp/Light.json | tee "$LOG_DIR/Light.log"
+        $TIMEOUT "${EXECUTABLES_DIR}/examples/learn_ota_json" "$ATVA_BENCHMARK_ROOT/Light.json" | tee "$LOG_DIR/Light.log"
     else
-        jq '.sigma as $sigma | (.tran |= with_entries(.value[1] = (.value[1] as $event | "abcdefghijklmnopqrstuvwxyz" | split("")[($sigma | index($event))]))) | (.sigma |= map(. as $event | "abcdefghijklmnopqrstuvwxyz" | split("")[($sigma | index($event))])) | .' "$ATVA_BENCHMARK_ROOT/$(echo ${benchmark} | tr [a-z] [A-Z]).json" > "/tmp/$(echo ${benchmark} | tr [a-z] [A-Z]).json"
-        $TIMEOUT "${EXECUTABLES_DIR}/examples/learn_ota_json" "/tmp/$(echo ${benchmark} | tr [a-z] [A-Z]).json" | tee "$LOG_DIR/$(echo ${benchmark} | tr [a-z] [A-Z]).log"
+        $TIMEOUT "${EXECUTABLES_DIR}/examples/learn_ota_json" "$ATVA_BENCHMARK_ROOT/$(echo ${benchmark} | tr [a-z] [A-Z]).json" | tee "$LOG_DIR/$(echo ${benchmark} | tr [a-z] [A-Z]).log"
     fi
 done